@@ -0,0 +1,384 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#include "BatchRunner.h"
+
+#include "CombineInstruments.h"
+#include "DimRegionPatch.h"
+#include "GigMerger.h"
+#include "SampleImporter.h"
+#include "ScriptChecker.h"
+#include "Settings.h"
+
+#include <glibmm/convert.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include <ctype.h>
+#include <iostream>
+#include <stdlib.h>
+
+namespace {
+
+    // thrown on errors in the script itself, as opposed to errors of
+    // commands, which are thrown as std::string
+    struct SyntaxError {
+        SyntaxError(const std::string& message) : message(message) {}
+        std::string message;
+    };
+
+    void expectArgs(const std::vector<std::string>& args, int min, int max) {
+        const int n = int(args.size()) - 1;
+        if (n < min || (max >= 0 && n > max))
+            throw SyntaxError("wrong amount of arguments for '" + args[0] + "'");
+    }
+
+    // dimension names accepted by the "combine" command, independent of the
+    // GUI's language
+    struct DimensionName {
+        const char* name;
+        gig::dimension_t type;
+    };
+
+    const DimensionName dimensionNames[] = {
+        { "samplechannel",      gig::dimension_samplechannel },
+        { "layer",              gig::dimension_layer },
+        { "velocity",           gig::dimension_velocity },
+        { "aftertouch",         gig::dimension_channelaftertouch },
+        { "releasetrigger",     gig::dimension_releasetrigger },
+        { "keyboard",           gig::dimension_keyboard },
+        { "roundrobin",         gig::dimension_roundrobin },
+        { "random",             gig::dimension_random },
+        { "smartmidi",          gig::dimension_smartmidi },
+        { "roundrobinkeyboard", gig::dimension_roundrobinkeyboard },
+        { "modwheel",           gig::dimension_modwheel },
+        { "breath",             gig::dimension_breath },
+        { "foot",               gig::dimension_foot },
+        { "portamentotime",     gig::dimension_portamentotime },
+        { "effect1",            gig::dimension_effect1 },
+        { "effect2",            gig::dimension_effect2 },
+        { "genpurpose1",        gig::dimension_genpurpose1 },
+        { "genpurpose2",        gig::dimension_genpurpose2 },
+        { "genpurpose3",        gig::dimension_genpurpose3 },
+        { "genpurpose4",        gig::dimension_genpurpose4 },
+        { "sustainpedal",       gig::dimension_sustainpedal },
+        { "portamento",         gig::dimension_portamento },
+        { "sostenutopedal",     gig::dimension_sostenutopedal },
+        { "softpedal",          gig::dimension_softpedal },
+        { "genpurpose5",        gig::dimension_genpurpose5 },
+        { "genpurpose6",        gig::dimension_genpurpose6 },
+        { "genpurpose7",        gig::dimension_genpurpose7 },
+        { "genpurpose8",        gig::dimension_genpurpose8 },
+        { "effect1depth",       gig::dimension_effect1depth },
+        { "effect2depth",       gig::dimension_effect2depth },
+        { "effect3depth",       gig::dimension_effect3depth },
+        { "effect4depth",       gig::dimension_effect4depth },
+        { "effect5depth",       gig::dimension_effect5depth },
+    };
+
+    // accepts one of the names above or the numeric dimension type
+    gig::dimension_t parseDimension(const std::string& s) {
+        for (int i = 0; i < sizeof(dimensionNames) / sizeof(DimensionName); ++i)
+            if (s == dimensionNames[i].name) return dimensionNames[i].type;
+        char* end;
+        const long type = strtol(s.c_str(), &end, 0);
+        if (s.empty() || *end || type <= 0 || type >= 0xff)
+            throw SyntaxError("unknown dimension '" + s + "'");
+        return static_cast<gig::dimension_t>(type);
+    }
+
+} // namespace
+
+BatchRunner::BatchRunner() : riff(NULL), gig(NULL) {
+}
+
+BatchRunner::~BatchRunner() {
+    close();
+}
+
+void BatchRunner::close() {
+    // the gig::File must be deleted before the RIFF::File it was created from
+    delete gig;
+    delete riff;
+    gig = NULL;
+    riff = NULL;
+    selection.clear();
+    importQueue.clear();
+}
+
+/**
+ * Splits the given script @a line into its arguments. Returns false on
+ * unbalanced double quotes.
+ */
+bool BatchRunner::tokenize(const std::string& line, std::vector<std::string>& args) {
+    args.clear();
+    size_t i = 0;
+    while (true) {
+        while (i < line.size() && isspace(line[i])) ++i;
+        if (i >= line.size() || line[i] == '#') return true;
+        std::string arg;
+        if (line[i] == '"') {
+            const size_t end = line.find('"', i + 1);
+            if (end == std::string::npos) return false;
+            arg = line.substr(i + 1, end - i - 1);
+            i = end + 1;
+        } else {
+            while (i < line.size() && !isspace(line[i])) arg += line[i++];
+        }
+        args.push_back(arg);
+    }
+}
+
+/**
+ * Executes all commands of the given @a script. Returns 0 on success, 1 if
+ * a command failed and 2 on errors in the script itself.
+ */
+int BatchRunner::run(std::istream& script) {
+    const gint64 tStart = g_get_monotonic_time();
+    int result = 0;
+    std::string line;
+    for (int iLine = 1; result == 0 && std::getline(script, line); ++iLine) {
+        std::vector<std::string> args;
+        if (!tokenize(line, args)) {
+            std::cerr << "line " << iLine << ": unbalanced quotes" << std::endl;
+            result = 2;
+            break;
+        }
+        if (args.empty()) continue;
+
+        const gint64 t = g_get_monotonic_time();
+        try {
+            execute(args);
+        } catch (SyntaxError e) {
+            std::cerr << "line " << iLine << ": " << e.message << std::endl;
+            result = 2;
+        } catch (std::string e) {
+            std::cerr << "line " << iLine << ": " << e << std::endl;
+            result = 1;
+        } catch (RIFF::Exception e) {
+            std::cerr << "line " << iLine << ": " << e.Message << std::endl;
+            result = 1;
+        } catch (Serialization::Exception e) {
+            std::cerr << "line " << iLine << ": " << e.Message << std::endl;
+            result = 1;
+        } catch (const Glib::Error& e) { // i.e. Glib::FileError, Glib::ConvertError
+            std::cerr << "line " << iLine << ": " << e.what() << std::endl;
+            result = 1;
+        }
+        std::cout << "timing\t" << iLine << "\t" << args[0] << "\t"
+                  << (result ? "error" : "ok") << "\t"
+                  << (g_get_monotonic_time() - t) / 1000 << std::endl;
+    }
+    std::cout << "timing\t-\ttotal\t" << (result ? "error" : "ok") << "\t"
+              << (g_get_monotonic_time() - tStart) / 1000 << std::endl;
+    return result;
+}
+
+void BatchRunner::execute(const std::vector<std::string>& args) {
+    const std::string& cmd = args[0];
+    if (cmd == "open")
+        open(args);
+    else if (cmd == "select")
+        select(args);
+    else if (cmd == "macro")
+        macro(args);
+    else if (cmd == "replace-samples")
+        replaceSamples(args);
+    else if (cmd == "combine")
+        combine(args);
+    else if (cmd == "merge")
+        merge(args);
+    else if (cmd == "validate")
+        validate(args);
+    else if (cmd == "save")
+        save(args);
+    else
+        throw SyntaxError("unknown command '" + cmd + "'");
+}
+
+void BatchRunner::requireFile() const {
+    if (!gig) throw std::string("no file open");
+}
+
+void BatchRunner::open(const std::vector<std::string>& args) {
+    expectArgs(args, 1, 1);
+    close();
+    riff = new RIFF::File(args[1]);
+    try {
+        gig = new gig::File(riff);
+        // load all samples' meta data and regions now, so subsequent
+        // commands measure their own work only
+        gig->GetFirstSample();
+        gig->GetFirstInstrument();
+    } catch (...) {
+        close();
+        throw;
+    }
+}
+
+void BatchRunner::select(const std::vector<std::string>& args) {
+    requireFile();
+    if (args.size() == 1) {
+        selection.clear();
+        return;
+    }
+    for (int i = 1; i < args.size(); ++i) {
+        const std::string& what = args[i];
+        if (what == "all") {
+            selection.clear();
+            for (gig::Instrument* instr = gig->GetFirstInstrument(); instr;
+                 instr = gig->GetNextInstrument())
+                selection.push_back(instr);
+        } else if (what[0] == '#') {
+            const int index = atoi(what.c_str() + 1);
+            gig::Instrument* instr = gig->GetInstrument(index);
+            if (!instr) throw std::string("no instrument with index " + what);
+            selection.push_back(instr);
+        } else {
+            bool found = false;
+            for (gig::Instrument* instr = gig->GetFirstInstrument(); instr;
+                 instr = gig->GetNextInstrument())
+            {
+                if (gig_to_utf8(instr->pInfo->Name) != what) continue;
+                selection.push_back(instr);
+                found = true;
+            }
+            if (!found) throw std::string("no instrument named '" + what + "'");
+        }
+    }
+}
+
+void BatchRunner::macro(const std::vector<std::string>& args) {
+    expectArgs(args, 1, 1);
+    requireFile();
+    std::vector<Settings::MacroInfo> index;
+    Settings::singleton()->loadMacroIndex(index);
+    int iMacro = -1;
+    for (int i = 0; i < index.size(); ++i)
+        if (index[i].name == args[1]) iMacro = i;
+    if (iMacro < 0) throw std::string("no stored macro named '" + args[1] + "'");
+    Serialization::Archive macro;
+    Settings::singleton()->loadMacro(index[iMacro], macro);
+
+    std::vector<gig::DimensionRegion*> dimregs;
+    for (int i = 0; i < selection.size(); ++i) {
+        for (gig::Region* rgn = selection[i]->GetFirstRegion(); rgn;
+             rgn = selection[i]->GetNextRegion())
+        {
+            for (int d = 0; d < rgn->DimensionRegions; ++d)
+                if (rgn->pDimensionRegions[d])
+                    dimregs.push_back(rgn->pDimensionRegions[d]);
+        }
+    }
+    if (dimregs.empty()) return;
+
+    // compile the macro only once (see MainWindow::applyMacro())
+    DimRegionPatch patch;
+    const bool bCompiled = patch.compile(macro, dimregs[0]);
+    for (int i = 0; i < dimregs.size(); ++i) {
+        if (bCompiled)
+            patch.apply(dimregs[i]);
+        else
+            macro.deserialize(dimregs[i]);
+    }
+}
+
+void BatchRunner::replaceSamples(const std::vector<std::string>& args) {
+    expectArgs(args, 1, 2);
+    requireFile();
+    const std::string folder = args[1];
+    const Glib::ustring extension = (args.size() > 2) ? args[2] : ".wav";
+    for (gig::Sample* sample = gig->GetFirstSample(); sample;
+         sample = gig->GetNextSample())
+    {
+        std::string filename =
+            folder + G_DIR_SEPARATOR_S +
+            Glib::filename_from_utf8(gig_to_utf8(sample->pInfo->Name) + extension);
+        // like in the GUI, samples without an appropriate sample file are
+        // reported and left untouched
+        Glib::ustring error;
+        if (!SampleImporter::prepareSample(sample, filename, error)) {
+            std::cerr << "warning: " << filename << " (" << error << ")" << std::endl;
+            continue;
+        }
+        importQueue[sample] = filename;
+    }
+}
+
+void BatchRunner::combine(const std::vector<std::string>& args) {
+    expectArgs(args, 1, 2);
+    requireFile();
+    const gig::dimension_t dimension = parseDimension(args[1]);
+    if (selection.size() < 2)
+        throw std::string("at least two instruments must be selected");
+    gig::Instrument* output = NULL;
+    std::set<Glib::ustring> warnings;
+    combineInstruments(selection, gig, output, dimension, warnings);
+    for (std::set<Glib::ustring>::const_iterator it = warnings.begin();
+         it != warnings.end(); ++it)
+        std::cerr << "warning: " << *it << std::endl;
+    if (args.size() > 2) output->pInfo->Name = gig_from_utf8(args[2]);
+    selection.clear();
+    selection.push_back(output);
+}
+
+void BatchRunner::merge(const std::vector<std::string>& args) {
+    expectArgs(args, 1, -1);
+    requireFile();
+    mergeGigFiles(gig, std::vector<std::string>(args.begin() + 1, args.end()));
+}
+
+void BatchRunner::validate(const std::vector<std::string>& args) {
+    expectArgs(args, 0, 0);
+    requireFile();
+#if USE_LS_SCRIPTVM
+    ScriptChecker checker;
+    const std::vector<ScriptChecker::Result> results = checker.check(gig);
+    std::cout << ScriptChecker::report(results) << std::flush;
+    if (ScriptChecker::errorCount(results))
+        throw std::string("instrument scripts have errors");
+#else
+    throw std::string("validating requires gigedit to be compiled with "
+                      "liblinuxsampler support");
+#endif
+}
+
+void BatchRunner::save(const std::vector<std::string>& args) {
+    expectArgs(args, 0, 1);
+    requireFile();
+    if (args.size() > 1)
+        gig->Save(args[1]);
+    else
+        gig->Save();
+
+    // the samples were resized by Save(), now their sample data can be
+    // written to the file
+    if (importQueue.empty()) return;
+    std::vector<SampleImporter::Job> jobs;
+    for (std::map<gig::Sample*, std::string>::iterator it = importQueue.begin();
+         it != importQueue.end(); ++it)
+    {
+        SampleImporter::Job job;
+        job.sample = it->first;
+        job.path = it->second;
+        job.framesWritten = 0;
+        jobs.push_back(job);
+    }
+    SampleImporter importer;
+    importer.run(jobs);
+    std::string errors;
+    for (int i = 0; i < jobs.size(); ++i) {
+        if (jobs[i].error.empty()) {
+            importQueue.erase(jobs[i].sample);
+            continue;
+        }
+        if (!errors.empty()) errors += "\n";
+        errors += jobs[i].path + " (" + jobs[i].error.raw() + ")";
+    }
+    if (!errors.empty())
+        throw std::string("could not import the following sample(s):\n" + errors);
+}
@@ -0,0 +1,72 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#ifndef GIGEDIT_BATCHRUNNER_H
+#define GIGEDIT_BATCHRUNNER_H
+
+#include "global.h"
+
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+
+/** @brief Executes a script of editing commands without any GUI.
+ *
+ * Implements the command line option "--batch SCRIPT". The script contains
+ * one command per line, arguments are separated by white space, arguments
+ * containing white space must be enclosed in double quotes, and lines
+ * starting with '#' are ignored. Supported commands:
+ *
+ * - open FILE - opens the .gig file to be edited
+ * - select all|NAME|#INDEX - selects instruments for subsequent commands
+ *   (each select command adds to the selection, "select" alone clears it)
+ * - macro NAME - applies the stored macro NAME to all dimension regions of
+ *   the selected instruments
+ * - replace-samples FOLDER [EXTENSION] - replaces each sample by the audio
+ *   file with the same name (plus EXTENSION, ".wav" by default) in FOLDER
+ * - combine DIMENSION [NAME] - combines the selected instruments to a new
+ *   instrument, the new instrument becomes the selection
+ * - merge FILE... - merges the content of other .gig files into this one
+ * - validate - checks all instrument scripts for errors
+ * - save [FILE] - saves the .gig file (under a new name), and imports the
+ *   sample data of all replaced samples
+ *
+ * After each command a tab separated timing line is printed to stdout:
+ * "timing", script line, command, "ok" or "error", and duration in
+ * milliseconds. Error details are printed to stderr. Execution stops on the
+ * first command that fails.
+ */
+class BatchRunner {
+public:
+    BatchRunner();
+    ~BatchRunner();
+    int run(std::istream& script);
+
+    static bool tokenize(const std::string& line, std::vector<std::string>& args);
+
+private:
+    RIFF::File* riff;
+    gig::File* gig;
+    std::vector<gig::Instrument*> selection;
+    std::map<gig::Sample*, std::string> importQueue; ///< Replaced samples whose data is imported on save.
+
+    void close();
+    void execute(const std::vector<std::string>& args);
+    void requireFile() const;
+
+    void open(const std::vector<std::string>& args);
+    void select(const std::vector<std::string>& args);
+    void macro(const std::vector<std::string>& args);
+    void replaceSamples(const std::vector<std::string>& args);
+    void combine(const std::vector<std::string>& args);
+    void merge(const std::vector<std::string>& args);
+    void validate(const std::vector<std::string>& args);
+    void save(const std::vector<std::string>& args);
+};
+
+#endif // GIGEDIT_BATCHRUNNER_H
@@ -0,0 +1,996 @@
+/*
+    Copyright (c) 2014-2018 Christian Schoenebeck
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#include "global.h"
+#include "CombineInstruments.h"
+
+// enable this for debug messages being printed while combining the instruments
+#define DEBUG_COMBINE_INSTRUMENTS 0
+
+#include <set>
+#include <iostream>
+#include <assert.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include <glibmm/ustring.h>
+
+typedef std::vector< std::pair<gig::Instrument*, gig::Region*> > OrderedRegionGroup;
+typedef std::map<gig::Instrument*, gig::Region*> RegionGroup;
+typedef std::map<DLS::range_t,RegionGroup> RegionGroups;
+
+typedef std::vector<DLS::range_t> DimensionZones;
+typedef std::map<gig::dimension_t,DimensionZones> Dimensions;
+
+typedef std::map<gig::dimension_t, int> DimensionRegionUpperLimits;
+
+typedef std::set<Glib::ustring> Warnings;
+
+///////////////////////////////////////////////////////////////////////////
+// private static data
+
+static Warnings g_warnings;
+static bool g_quietWarnings = false; // true: don't print warnings to console
+
+///////////////////////////////////////////////////////////////////////////
+// private functions
+
+#if DEBUG_COMBINE_INSTRUMENTS
+static void printRanges(const RegionGroups& regions) {
+    std::cout << "{ ";
+    for (RegionGroups::const_iterator it = regions.begin(); it != regions.end(); ++it) {
+        if (it != regions.begin()) std::cout << ", ";
+        std::cout << (int)it->first.low << ".." << (int)it->first.high;
+    }
+    std::cout << " }" << std::flush;
+}
+#endif
+
+/**
+ * Store a warning message that shall be stored and displayed to the user as a
+ * list of warnings after the overall operation has finished. Duplicate warning
+ * messages are automatically eliminated.
+ */
+inline void addWarning(const char* fmt, ...) {
+    va_list arg;
+    va_start(arg, fmt);
+    const int SZ = 255 + strlen(fmt);
+    char* buf = new char[SZ];
+    vsnprintf(buf, SZ, fmt, arg);
+    Glib::ustring s = buf;
+    delete [] buf;
+    va_end(arg);
+    if (!g_quietWarnings)
+        std::cerr << _("WARNING:") << " " << s << std::endl << std::flush;
+    g_warnings.insert(s);
+}
+
+/**
+ * Returns the key ranges of all regions of the given @a instruments, sorted
+ * ascending by their range end.
+ */
+static std::vector<DLS::range_t> getRegionRangesSortedByEnd(std::vector<gig::Instrument*>& instruments) {
+    std::vector< std::pair<int,int> > v; // first: range end, second: range start
+    for (uint i = 0; i < instruments.size(); ++i) {
+        gig::Instrument* instr = instruments[i];
+        for (gig::Region* rgn = instr->GetFirstRegion(); rgn; rgn = instr->GetNextRegion()) {
+            if (rgn->KeyRange.low > 127) continue; // out of keyboard range
+            v.push_back(std::pair<int,int>(rgn->KeyRange.high, rgn->KeyRange.low));
+        }
+    }
+    std::sort(v.begin(), v.end());
+    std::vector<DLS::range_t> ranges(v.size());
+    for (size_t i = 0; i < v.size(); ++i) {
+        ranges[i].low  = v[i].second;
+        ranges[i].high = v[i].first;
+    }
+    return ranges;
+}
+
+/**
+ * Find all region intersections of all given @a instruments with one single
+ * sweep over the region ranges sorted by their end.
+ *
+ * Each intersection starts at the smallest region point (not necessarily a
+ * region start point) of all regions not yet passed, and ends at the smallest
+ * region end of all regions which overlap that start point or a higher key.
+ */
+static std::vector<DLS::range_t> findRegionIntersections(std::vector<gig::Instrument*>& instruments) {
+    const std::vector<DLS::range_t> ranges = getRegionRangesSortedByEnd(instruments);
+    const size_t n = ranges.size();
+
+    // lowest region start of all regions from index i to the end
+    std::vector<int> minLow(n + 1, 128);
+    for (size_t i = n; i > 0; --i)
+        minLow[i-1] = std::min<int>(minLow[i], ranges[i-1].low);
+
+    std::vector<DLS::range_t> intersections;
+    size_t i = 0;
+    for (int iStart = 0; iStart <= 127; ) {
+        // skip all regions which end before iStart
+        while (i < n && ranges[i].high < iStart) ++i;
+        if (i == n) break;
+        iStart = std::max(iStart, minLow[i]);
+        // the region providing minLow[i] ends at or after iStart, so this
+        // never runs past the end
+        while (ranges[i].high < iStart) ++i;
+        const int iEnd = ranges[i].high;
+        DLS::range_t range = { uint16_t(iStart), uint16_t(iEnd) };
+        intersections.push_back(range);
+        iStart = iEnd + 1;
+    }
+    return intersections;
+}
+
+static bool rangeEndLess(const DLS::range_t& range, int key) {
+    return range.high < key;
+}
+
+/** @brief Identify required regions.
+ *
+ * Takes a list of @a instruments as argument (which are planned to be combined
+ * as separate dimension zones of a certain dimension into one single new
+ * instrument) and fulfills the following tasks:
+ *
+ * - 1. Identification of total amount of regions required to create a new
+ *      instrument to become a combined version of the given instruments.
+ * - 2. Precise key range of each of those identified required regions to be
+ *      created in that new instrument.
+ * - 3. Grouping the original source regions of the given original instruments
+ *      to the respective target key range (new region) of the instrument to be
+ *      created.
+ *
+ * Runs in O(n log n) with n being the total amount of regions of all
+ * @a instruments: the intersections are found by a sweep over the sorted
+ * region ranges, and since those intersections are disjoint and sorted, the
+ * ones overlapping a region are looked up by binary search.
+ *
+ * @param instruments - list of instruments that are planned to be combined
+ * @returns structured result of the tasks described above
+ */
+static RegionGroups groupByRegionIntersections(std::vector<gig::Instrument*>& instruments) {
+    RegionGroups groups;
+
+    // find all region intersections of all instruments
+    const std::vector<DLS::range_t> intersections = findRegionIntersections(instruments);
+
+    // now sort all regions to those found intersections
+    std::vector<RegionGroup> v(intersections.size());
+    std::vector<gig::Instrument*> warned(intersections.size(), NULL);
+    for (uint i = 0; i < instruments.size(); ++i) {
+        gig::Instrument* instr = instruments[i];
+        for (gig::Region* rgn = instr->GetFirstRegion(); rgn; rgn = instr->GetNextRegion()) {
+            std::vector<DLS::range_t>::const_iterator it = std::lower_bound(
+                intersections.begin(), intersections.end(),
+                int(rgn->KeyRange.low), rangeEndLess
+            );
+            for (; it != intersections.end() && it->low <= rgn->KeyRange.high; ++it) {
+                const size_t k = it - intersections.begin();
+                if (!v[k].count(instr)) {
+                    // first region of this instrument in this intersection
+                    v[k][instr] = rgn;
+                } else if (warned[k] != instr) {
+                    addWarning("More than one region found!");
+                    warned[k] = instr;
+                }
+            }
+        }
+    }
+    for (uint i = 0; i < intersections.size(); ++i) {
+        if (!v[i].empty())
+            groups[intersections[i]] = v[i];
+        else
+            addWarning("Empty region group!");
+    }
+
+    return groups;
+}
+
+/** @brief Identify required dimensions.
+ *
+ * Takes a planned new region (@a regionGroup) as argument and identifies which
+ * precise dimensions would have to be created for that new region, along with
+ * the amount of dimension zones and their precise individual zone sizes.
+ *
+ * @param regionGroup - planned new region for a new instrument
+ * @returns set of dimensions that shall be created for the given planned region
+ */
+static Dimensions getDimensionsForRegionGroup(RegionGroup& regionGroup) {
+    std::map<gig::dimension_t, std::set<int> > dimUpperLimits;
+
+    // collect all dimension region zones' upper limits
+    for (RegionGroup::iterator it = regionGroup.begin();
+         it != regionGroup.end(); ++it)
+    {
+        gig::Region* rgn = it->second;
+        int previousBits = 0;
+        for (uint d = 0; d < rgn->Dimensions; ++d) {
+            const gig::dimension_def_t& def = rgn->pDimensionDefinitions[d];
+            for (uint z = 0; z < def.zones; ++z) {
+                int dr = z << previousBits;
+                gig::DimensionRegion* dimRgn = rgn->pDimensionRegions[dr];
+                // Store the individual dimension zone sizes (or actually their
+                // upper limits here) for each dimension.
+                // HACK: Note that the velocity dimension is specially handled
+                // here. Instead of taking over custom velocity split sizes
+                // here, only a bogus number (zone index number) is stored for
+                // each velocity zone, that way only the maxiumum amount of
+                // velocity splits of all regions is stored here, and when their
+                // individual DimensionRegions are finally copied (later), the
+                // individual velocity split size are copied by that.
+                dimUpperLimits[def.dimension].insert(
+                    (def.dimension == gig::dimension_velocity) ?
+                        z : (def.split_type == gig::split_type_bit) ?
+                            ((z+1) * 128/def.zones - 1) : dimRgn->DimensionUpperLimits[dr]
+                );
+            }
+            previousBits += def.bits;
+        }
+    }
+
+    // convert upper limit set to range vector
+    Dimensions dims;
+    for (std::map<gig::dimension_t, std::set<int> >::const_iterator it = dimUpperLimits.begin();
+         it != dimUpperLimits.end(); ++it)
+    {
+        gig::dimension_t type = it->first;
+        int iLow = 0;
+        for (std::set<int>::const_iterator itNums = it->second.begin();
+             itNums != it->second.end(); ++itNums)
+        {
+            const int iUpperLimit = *itNums;
+            DLS::range_t range = { uint16_t(iLow), uint16_t(iUpperLimit) };
+            dims[type].push_back(range);
+            iLow = iUpperLimit + 1;
+        }
+    }
+
+    return dims;
+}
+
+static void fillDimValues(uint* values/*[8]*/, DimensionCase dimCase, gig::Region* rgn, bool bShouldHaveAllDimensionsPassed) {
+    #if DEBUG_COMBINE_INSTRUMENTS
+    printf("dimvalues = { ");
+    fflush(stdout);
+    #endif
+    for (DimensionCase::iterator it = dimCase.begin(); it != dimCase.end(); ++it) {
+        gig::dimension_t type = it->first;
+        int iDimIndex = getDimensionIndex(type, rgn);
+        if (bShouldHaveAllDimensionsPassed) assert(iDimIndex >= 0);
+        else if (iDimIndex < 0) continue;
+        values[iDimIndex] = it->second;
+        #if DEBUG_COMBINE_INSTRUMENTS
+        printf("%x=%d, ", type, it->second);
+        #endif
+    }
+    #if DEBUG_COMBINE_INSTRUMENTS
+    printf("}\n");
+    #endif
+}
+
+static DimensionRegionUpperLimits getDimensionRegionUpperLimits(gig::DimensionRegion* dimRgn) {
+    DimensionRegionUpperLimits limits;
+    gig::Region* rgn = dimRgn->GetParent();
+    for (uint d = 0; d < rgn->Dimensions; ++d) {
+        const gig::dimension_def_t& def = rgn->pDimensionDefinitions[d];
+        limits[def.dimension] = dimRgn->DimensionUpperLimits[d];
+    }
+    return limits;
+}
+
+static void restoreDimensionRegionUpperLimits(gig::DimensionRegion* dimRgn, const DimensionRegionUpperLimits& limits) {
+    gig::Region* rgn = dimRgn->GetParent();
+    for (DimensionRegionUpperLimits::const_iterator it = limits.begin();
+         it != limits.end(); ++it)
+    {
+        int index = getDimensionIndex(it->first, rgn);
+        assert(index >= 0);
+        dimRgn->DimensionUpperLimits[index] = it->second;
+    }
+}
+
+inline int dimensionRegionIndex(gig::DimensionRegion* dimRgn) {
+    gig::Region* rgn = dimRgn->GetParent();
+    int sz = sizeof(rgn->pDimensionRegions) / sizeof(gig::DimensionRegion*);
+    for (int i = 0; i < sz; ++i)
+        if (rgn->pDimensionRegions[i] == dimRgn)
+            return i;
+    return -1;
+}
+
+/** @brief Get exact zone ranges of given dimension.
+ *
+ * This function is useful for the velocity type dimension. In contrast to other
+ * dimension types, this dimension can have different zone ranges (that is
+ * different individual start and end points of its dimension zones) depending
+ * on which zones of other dimensions (on that gig::Region) are currently
+ * selected.
+ *
+ * @param type - dimension where the zone ranges should be retrieved for
+ *               (usually the velocity dimension in this context)
+ * @param dimRgn - reflects the exact cases (zone selections) of all other
+ *                 dimensions than the given one in question
+ * @returns individual ranges for each zone of the questioned dimension type,
+ *          it returns an empty result on errors instead
+ */
+static DimensionZones preciseDimensionZonesFor(gig::dimension_t type, gig::DimensionRegion* dimRgn) {
+    DimensionZones zones;
+    gig::Region* rgn = dimRgn->GetParent();
+    int iDimension = getDimensionIndex(type, rgn);
+    if (iDimension < 0) return zones;
+    const gig::dimension_def_t& def = rgn->pDimensionDefinitions[iDimension];
+    int iDimRgn = dimensionRegionIndex(dimRgn);
+    int iBaseBits = baseBits(type, rgn);
+    assert(iBaseBits >= 0);
+    int mask = ~(((1 << def.bits) - 1) << iBaseBits);
+
+    #if DEBUG_COMBINE_INSTRUMENTS
+    printf("velo zones { ");
+    fflush(stdout);
+    #endif
+    int iLow = 0;
+    for (int z = 0; z < def.zones; ++z) {
+        gig::DimensionRegion* dimRgn2 =
+            rgn->pDimensionRegions[ (iDimRgn & mask) | ( z << iBaseBits) ];
+        int iHigh = dimRgn2->DimensionUpperLimits[iDimension];
+        DLS::range_t range = { uint16_t(iLow), uint16_t(iHigh) };
+        #if DEBUG_COMBINE_INSTRUMENTS
+        printf("%d..%d, ", iLow, iHigh);
+        fflush(stdout);
+        #endif
+        zones.push_back(range);
+        iLow = iHigh + 1;
+    }
+    #if DEBUG_COMBINE_INSTRUMENTS
+    printf("}\n");
+    #endif
+    return zones;
+}
+
+struct CopyAssignSchedEntry {
+    gig::DimensionRegion* src;
+    gig::DimensionRegion* dst;
+    int velocityZone;
+    int totalSrcVelocityZones;
+};
+typedef std::vector<CopyAssignSchedEntry> CopyAssignSchedule;
+
+/** @brief Schedule copying DimensionRegions from source Region to target Region.
+ *
+ * Schedules copying the entire articulation informations (including sample
+ * reference) from all individual DimensionRegions of source Region @a inRgn to
+ * target Region @a outRgn. It is expected that the required dimensions (thus
+ * the required dimension regions) were already created before calling this
+ * function.
+ *
+ * To be precise, it does the task above only for the dimension zones defined by
+ * the three arguments @a mainDim, @a iSrcMainBit, @a iDstMainBit, which reflect
+ * a selection which dimension zones shall be copied. All other dimension zones
+ * will not be scheduled to be copied by a single call of this function. So this
+ * function needs to be called several time in case all dimension regions shall
+ * be copied of the entire region (@a inRgn, @a outRgn).
+ *
+ * @param outRgn - where the dimension regions shall be copied to
+ * @param inRgn - all dimension regions that shall be copied from
+ * @param dims - precise dimension definitions of target region
+ * @param mainDim - this dimension type, in combination with @a iSrcMainBit and
+ *                  @a iDstMainBit defines a selection which dimension region
+ *                  zones shall be copied by this call of this function
+ * @param iDstMainBit - destination bit of @a mainDim
+ * @param iSrcMainBit - source bit of @a mainDim
+ * @param schedule - list of all DimensionRegion copy operations which is filled
+ *                   during the nested loops / recursions of this function call
+ * @param dimCase - just for internal purpose (function recursion), don't pass
+ *                  anything here, this function will call itself recursively
+ *                  will fill this container with concrete dimension values for
+ *                  selecting the precise dimension regions during its task
+ */
+static void scheduleCopyDimensionRegions(gig::Region* outRgn, gig::Region* inRgn,
+                                 Dimensions dims, gig::dimension_t mainDim,
+                                 int iDstMainBit, int iSrcMainBit,
+                                 CopyAssignSchedule* schedule,
+                                 DimensionCase dimCase = DimensionCase())
+{
+    if (dims.empty()) { // reached deepest level of function recursion ...
+        CopyAssignSchedEntry e;
+
+        // resolve the respective source & destination DimensionRegion ...        
+        uint srcDimValues[8] = {};
+        uint dstDimValues[8] = {};
+        DimensionCase srcDimCase = dimCase;
+        DimensionCase dstDimCase = dimCase;
+        srcDimCase[mainDim] = iSrcMainBit;
+        dstDimCase[mainDim] = iDstMainBit;
+
+        #if DEBUG_COMBINE_INSTRUMENTS
+        printf("-------------------------------\n");
+        printf("iDstMainBit=%d iSrcMainBit=%d\n", iDstMainBit, iSrcMainBit);
+        #endif
+
+        // first select source & target dimension region with an arbitrary
+        // velocity split zone, to get access to the precise individual velocity
+        // split zone sizes (if there is actually a velocity dimension at all,
+        // otherwise we already select the desired source & target dimension
+        // region here)
+        #if DEBUG_COMBINE_INSTRUMENTS
+        printf("src "); fflush(stdout);
+        #endif
+        fillDimValues(srcDimValues, srcDimCase, inRgn, false);
+        #if DEBUG_COMBINE_INSTRUMENTS
+        printf("dst "); fflush(stdout);
+        #endif
+        fillDimValues(dstDimValues, dstDimCase, outRgn, false);
+        gig::DimensionRegion* srcDimRgn = inRgn->GetDimensionRegionByValue(srcDimValues);
+        gig::DimensionRegion* dstDimRgn = outRgn->GetDimensionRegionByValue(dstDimValues);
+        #if DEBUG_COMBINE_INSTRUMENTS
+        printf("iDstMainBit=%d iSrcMainBit=%d\n", iDstMainBit, iSrcMainBit);
+        printf("srcDimRgn=%lx dstDimRgn=%lx\n", (uint64_t)srcDimRgn, (uint64_t)dstDimRgn);
+        printf("srcSample='%s' dstSample='%s'\n",
+               (!srcDimRgn->pSample ? "NULL" : srcDimRgn->pSample->pInfo->Name.c_str()),
+               (!dstDimRgn->pSample ? "NULL" : dstDimRgn->pSample->pInfo->Name.c_str())
+        );
+        #endif
+
+        assert(srcDimRgn->GetParent() == inRgn);
+        assert(dstDimRgn->GetParent() == outRgn);
+
+        // now that we have access to the precise velocity split zone upper
+        // limits, we can select the actual source & destination dimension
+        // regions we need to copy (assuming that source or target region has
+        // a velocity dimension)
+        if (outRgn->GetDimensionDefinition(gig::dimension_velocity)) {
+            // re-select target dimension region (with correct velocity zone)
+            DimensionZones dstZones = preciseDimensionZonesFor(gig::dimension_velocity, dstDimRgn);
+            assert(dstZones.size() > 1);
+            const int iDstZoneIndex =
+                (mainDim == gig::dimension_velocity)
+                    ? iDstMainBit : dstDimCase[gig::dimension_velocity]; // (mainDim == gig::dimension_velocity) exception case probably unnecessary here
+            e.velocityZone = iDstZoneIndex;
+            #if DEBUG_COMBINE_INSTRUMENTS
+            printf("dst velocity zone: %d/%d\n", iDstZoneIndex, (int)dstZones.size());
+            #endif
+            assert(uint(iDstZoneIndex) < dstZones.size());
+            dstDimCase[gig::dimension_velocity] = dstZones[iDstZoneIndex].low; // arbitrary value between low and high
+            #if DEBUG_COMBINE_INSTRUMENTS
+            printf("dst velocity value = %d\n", dstDimCase[gig::dimension_velocity]);
+            printf("dst refilled "); fflush(stdout);
+            #endif
+            fillDimValues(dstDimValues, dstDimCase, outRgn, false);
+            dstDimRgn = outRgn->GetDimensionRegionByValue(dstDimValues);
+            #if DEBUG_COMBINE_INSTRUMENTS
+            printf("reselected dstDimRgn=%lx\n", (uint64_t)dstDimRgn);
+            printf("dstSample='%s'%s\n",
+                (!dstDimRgn->pSample ? "NULL" : dstDimRgn->pSample->pInfo->Name.c_str()),
+                (dstDimRgn->pSample ? " <--- ERROR ERROR ERROR !!!!!!!!! " : "")
+            );
+            #endif
+
+            // re-select source dimension region with correct velocity zone
+            // (if it has a velocity dimension that is)
+            if (inRgn->GetDimensionDefinition(gig::dimension_velocity)) {
+                DimensionZones srcZones = preciseDimensionZonesFor(gig::dimension_velocity, srcDimRgn);
+                e.totalSrcVelocityZones = srcZones.size();
+                assert(srcZones.size() > 0);
+                if (srcZones.size() <= 1) {
+                    addWarning("Input region has a velocity dimension with only ONE zone!");
+                }
+                int iSrcZoneIndex =
+                    (mainDim == gig::dimension_velocity)
+                        ? iSrcMainBit : iDstZoneIndex;
+                if (uint(iSrcZoneIndex) >= srcZones.size())
+                    iSrcZoneIndex = srcZones.size() - 1;
+                srcDimCase[gig::dimension_velocity] = srcZones[iSrcZoneIndex].low; // same zone as used above for target dimension region (no matter what the precise zone ranges are)
+                #if DEBUG_COMBINE_INSTRUMENTS
+                printf("src refilled "); fflush(stdout);
+                #endif
+                fillDimValues(srcDimValues, srcDimCase, inRgn, false);
+                srcDimRgn = inRgn->GetDimensionRegionByValue(srcDimValues);
+                #if DEBUG_COMBINE_INSTRUMENTS
+                printf("reselected srcDimRgn=%lx\n", (uint64_t)srcDimRgn);
+                printf("srcSample='%s'\n",
+                    (!srcDimRgn->pSample ? "NULL" : srcDimRgn->pSample->pInfo->Name.c_str())
+                );
+                #endif
+            }
+        }
+
+        // Schedule copy operation of source -> target DimensionRegion for the
+        // time after all nested loops have been traversed. We have to postpone
+        // the actual copy operations this way, because otherwise it would
+        // overwrite informations inside the destination DimensionRegion object
+        // that we need to read in the code block above.
+        e.src = srcDimRgn;
+        e.dst = dstDimRgn;
+        schedule->push_back(e);
+
+        return; // returning from deepest level of function recursion
+    }
+
+    // Copying n dimensions requires n nested loops. That's why this function
+    // is calling itself recursively to provide the required amount of nested
+    // loops. With each call it pops from argument 'dims' and pushes to
+    // argument 'dimCase'.
+
+    Dimensions::iterator itDimension = dims.begin();
+    gig::dimension_t type = itDimension->first;
+    DimensionZones  zones = itDimension->second;
+    dims.erase(itDimension);
+
+    int iZone = 0;
+    for (DimensionZones::iterator itZone = zones.begin();
+         itZone != zones.end(); ++itZone, ++iZone)
+    {
+        DLS::range_t zoneRange = *itZone;
+        gig::dimension_def_t* def = outRgn->GetDimensionDefinition(type);
+        dimCase[type] = (def->split_type == gig::split_type_bit) ? iZone : zoneRange.low;
+
+        // recurse until 'dims' is exhausted (and dimCase filled up with concrete value)
+        scheduleCopyDimensionRegions(outRgn, inRgn, dims, mainDim, iDstMainBit, iSrcMainBit, schedule, dimCase);
+    }
+}
+
+/**
+ * Copies the scheduled source -> target DimensionRegions of one target region.
+ * This function is called concurrently for different target regions, so the
+ * warnings are not added directly, but appended to @a warnings instead.
+ */
+static void copyScheduledDimensionRegions(CopyAssignSchedule& schedule, gig::dimension_t mainDimension, std::vector<Glib::ustring>& warnings) {
+    for (uint i = 0; i < schedule.size(); ++i) {
+        CopyAssignSchedEntry& e = schedule[i];
+
+        // backup the target DimensionRegion's current dimension zones upper
+        // limits (because the target DimensionRegion's upper limits are
+        // already defined correctly since calling AddDimension(), and the
+        // CopyAssign() call next, will overwrite those upper limits
+        // unfortunately
+        DimensionRegionUpperLimits dstUpperLimits = getDimensionRegionUpperLimits(e.dst);
+        DimensionRegionUpperLimits srcUpperLimits = getDimensionRegionUpperLimits(e.src);
+
+        // now actually copy over the current DimensionRegion
+        const gig::Region* const origRgn = e.dst->GetParent(); // just for sanity check below
+        e.dst->CopyAssign(e.src);
+        assert(origRgn == e.dst->GetParent()); // if gigedit is crashing here, then you must update libgig (to at least SVN r2547, v3.3.0.svn10)
+
+        // restore all original dimension zone upper limits except of the
+        // velocity dimension, because the velocity dimension zone sizes are
+        // allowed to differ for individual DimensionRegions in gig v3
+        // format
+        //
+        // if the main dinension is the 'velocity' dimension, then skip
+        // restoring the source's original velocity zone limits, because
+        // dealing with merging that is not implemented yet
+        // TODO: merge custom velocity splits if main dimension is the velocity dimension (for now equal sized velocity zones are used if mainDim is 'velocity')
+        if (srcUpperLimits.count(gig::dimension_velocity) && mainDimension != gig::dimension_velocity) {
+            if (!dstUpperLimits.count(gig::dimension_velocity)) {
+                warnings.push_back("Source instrument seems to have a velocity dimension whereas new target instrument doesn't!");
+            } else {
+                dstUpperLimits[gig::dimension_velocity] =
+                    (e.velocityZone >= e.totalSrcVelocityZones)
+                        ? 127 : srcUpperLimits[gig::dimension_velocity];
+            }
+        }
+        restoreDimensionRegionUpperLimits(e.dst, dstUpperLimits);
+    }
+}
+
+/**
+ * Pool of worker threads which executes the copy schedules of all target
+ * regions. Once their dimensions were created, the target regions are
+ * independent of each other, so each schedule is processed as a whole by
+ * one thread, in the same order as a serial copy would do. That way the
+ * result does not depend on the amount of threads.
+ */
+class CopyAssignWorkers {
+public:
+    CopyAssignWorkers(std::vector<CopyAssignSchedule>& schedules, gig::dimension_t mainDimension, int maxThreads)
+        : schedules(schedules), mainDimension(mainDimension), maxThreads(maxThreads),
+          warnings(schedules.size()), nextJob(0) {}
+
+    /**
+     * Copies all scheduled DimensionRegions and blocks until done. The
+     * warnings of all threads are added afterwards in target region order.
+     *
+     * @throw gig::Exception if copying any of the DimensionRegions failed
+     */
+    void run() {
+        const int nThreads = std::min<int>(
+            schedules.size(), (maxThreads > 0) ? maxThreads : g_get_num_processors()
+        );
+        if (nThreads <= 1) {
+            thread_function();
+        } else {
+            std::vector<Glib::Threads::Thread*> threads;
+            for (int i = 0; i < nThreads; ++i) {
+#ifdef OLD_THREADS
+                threads.push_back(Glib::Thread::create(sigc::mem_fun(*this, &CopyAssignWorkers::thread_function), true));
+#else
+                threads.push_back(Glib::Threads::Thread::create(sigc::mem_fun(*this, &CopyAssignWorkers::thread_function)));
+#endif
+            }
+            for (int i = 0; i < threads.size(); ++i)
+                threads[i]->join();
+        }
+
+        for (uint i = 0; i < warnings.size(); ++i)
+            for (uint w = 0; w < warnings[i].size(); ++w)
+                addWarning("%s", warnings[i][w].c_str());
+        if (!error.empty())
+            throw gig::Exception(error);
+    }
+
+private:
+    std::vector<CopyAssignSchedule>& schedules;
+    const gig::dimension_t mainDimension;
+    const int maxThreads;
+    std::vector< std::vector<Glib::ustring> > warnings; // one list per schedule
+    Glib::Threads::Mutex mutex;
+    size_t nextJob;
+    Glib::ustring error;
+
+#if defined(WIN32) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 2))
+    // make sure stack is 16-byte aligned for SSE instructions
+    __attribute__((force_align_arg_pointer))
+#endif
+    void thread_function() {
+        while (true) {
+            size_t job;
+            {
+                Glib::Threads::Mutex::Lock lock(mutex);
+                if (nextJob >= schedules.size() || !error.empty()) break;
+                job = nextJob++;
+            }
+            try {
+                copyScheduledDimensionRegions(schedules[job], mainDimension, warnings[job]);
+            } catch (RIFF::Exception e) {
+                Glib::Threads::Mutex::Lock lock(mutex);
+                if (error.empty()) error = e.Message;
+            } catch (...) {
+                // an exception must never leave a worker thread
+                Glib::Threads::Mutex::Lock lock(mutex);
+                if (error.empty()) error = _("Unknown exception while copying dimension regions");
+            }
+        }
+    }
+};
+
+static OrderedRegionGroup sortRegionGroup(const RegionGroup& group, const std::vector<gig::Instrument*>& instruments) {
+    OrderedRegionGroup result;
+    for (std::vector<gig::Instrument*>::const_iterator it = instruments.begin();
+         it != instruments.end(); ++it)
+    {
+        RegionGroup::const_iterator itRgn = group.find(*it);
+        if (itRgn == group.end()) continue;
+        result.push_back(
+            std::pair<gig::Instrument*, gig::Region*>(
+                itRgn->first, itRgn->second
+            )
+        );
+    }
+    return result;
+}
+
+/**
+ * Layout of one region of a new combined instrument, as planned by
+ * planCombination() before any gig object is created.
+ */
+struct PlannedRegion {
+    DLS::range_t keyRange; ///< key range of the new region
+    RegionGroup sources; ///< source region of each instrument for this key range
+    Dimensions dims; ///< dimensions to be copied (without the main dimension)
+    std::vector<gig::dimension_def_t> dimensionDefs; ///< dimensions to be created on the new region (in that order)
+};
+typedef std::vector<PlannedRegion> CombinePlan;
+
+/** @brief Plan the combination of the given instruments.
+ *
+ * Computes the key ranges and dimension layouts of all regions of the new
+ * instrument which combineInstruments() would create, without creating any
+ * gig objects. Issues found while planning are added by addWarning().
+ *
+ * @param instruments - list of instruments that are planned to be combined
+ * @param mainDimension - the dimension that shall be used to combine the
+ *                        instruments
+ * @returns planned regions of the new instrument, ordered by key range
+ */
+static CombinePlan planCombination(std::vector<gig::Instrument*>& instruments, gig::dimension_t mainDimension) {
+    CombinePlan plan;
+
+    // divide the individual regions to (probably even smaller) groups of
+    // regions, coping with the fact that the source regions of the instruments
+    // might have quite different range sizes and start and end points
+    RegionGroups groups = groupByRegionIntersections(instruments);
+    #if DEBUG_COMBINE_INSTRUMENTS
+    std::cout << std::endl << "New regions: " << std::flush;
+    printRanges(groups);
+    std::cout << std::endl;
+    #endif
+
+    // Distinguishing in the following code block between 'horizontal' and
+    // 'vertical' regions. The 'horizontal' ones are meant to be the key ranges
+    // in the output instrument, while the 'vertical' regions are meant to be
+    // the set of source regions that shall be layered to that 'horizontal'
+    // region / key range. It is important to know, that the key ranges defined
+    // in the 'horizontal' and 'vertical' regions might differ.
+
+    for (RegionGroups::iterator itGroup = groups.begin();
+         itGroup != groups.end(); ++itGroup) // iterate over 'horizontal' / target regions ...
+    {
+        plan.push_back(PlannedRegion());
+        PlannedRegion& planned = plan.back();
+        planned.keyRange = itGroup->first;
+        planned.sources = itGroup->second;
+
+        // detect the total amount of zones required for the given main
+        // dimension to build up this combi for current key range
+        int iTotalZones = 0;
+        for (RegionGroup::iterator itRgn = itGroup->second.begin();
+             itRgn != itGroup->second.end(); ++itRgn)
+        {
+            gig::Region* inRgn = itRgn->second;
+            gig::dimension_def_t* def = inRgn->GetDimensionDefinition(mainDimension);
+            iTotalZones += (def) ? def->zones : 1;
+        }
+        #if DEBUG_COMBINE_INSTRUMENTS
+        printf("Required total zones: %d, vertical regions: %d\n", iTotalZones, itGroup->second.size());
+        #endif
+
+        // all required dimensions for this output region (except the main
+        // dimension used for separating the individual instruments, that
+        // particular dimension is planned as next step)
+        planned.dims = getDimensionsForRegionGroup(itGroup->second);
+        // the given main dimension which is used to combine the instruments is
+        // created separately after the next code block, and the main dimension
+        // should not be part of dims here, because it also used for iterating
+        // all dimensions zones, which would lead to this dimensions being
+        // iterated twice
+        planned.dims.erase(mainDimension);
+        {
+            std::vector<gig::dimension_t> skipTheseDimensions; // used to prevent a misbehavior (i.e. crash) of the combine algorithm in case one of the source instruments has a dimension with only one zone, which is not standard conform
+
+            for (Dimensions::iterator itDim = planned.dims.begin();
+                itDim != planned.dims.end(); ++itDim)
+            {
+                gig::dimension_def_t def;
+                def.dimension = itDim->first; // dimension type
+                def.zones = itDim->second.size();
+                def.bits = zoneCountToBits(def.zones);
+                if (def.zones < 2) {
+                    addWarning(
+                        "Attempt to create dimension with type=0x%x with only "
+                        "ONE zone (because at least one of the source "
+                        "instruments seems to have such a velocity dimension "
+                        "with only ONE zone, which is odd)! Skipping this "
+                        "dimension for now.",
+                        (int)itDim->first
+                    );
+                    skipTheseDimensions.push_back(itDim->first);
+                    continue;
+                }
+                planned.dimensionDefs.push_back(def);
+            }
+            // prevent the following dimensions to be processed further below
+            // (since the respective dimension will not be created)
+            for (int i = 0; i < skipTheseDimensions.size(); ++i)
+                planned.dims.erase(skipTheseDimensions[i]);
+        }
+
+        // the main dimension (if necessary for current key range)
+        if (iTotalZones > 1) {
+            gig::dimension_def_t def;
+            def.dimension = mainDimension; // dimension type
+            def.zones = iTotalZones;
+            def.bits = zoneCountToBits(def.zones);
+            planned.dimensionDefs.push_back(def);
+        }
+    }
+
+    return plan;
+}
+
+/** @brief Combine given list of instruments to one instrument.
+ *
+ * Takes a list of @a instruments as argument and combines them to one single
+ * new @a output instrument. For this task, it will create a dimension of type
+ * given by @a mainDimension in the new instrument and copies the source
+ * instruments to those dimension zones.
+ *
+ * @param instruments - (input) list of instruments that shall be combined,
+ *                      they will only be read, so they will be left untouched
+ * @param gig - (input/output) .gig file where the new combined instrument shall
+ *              be created
+ * @param output - (output) on success this pointer will be set to the new
+ *                 instrument being created
+ * @param mainDimension - the dimension that shall be used to combine the
+ *                        instruments
+ * @param warnings - (output) on success the warnings which occurred while
+ *                   combining the instruments
+ * @param maxThreads - maximum amount of threads copying the dimension regions
+ *                     (0: one per processor), the result is the same for any
+ *                     amount of threads
+ * @throw RIFF::Exception on any kinds of errors
+ */
+void combineInstruments(std::vector<gig::Instrument*>& instruments, gig::File* gig, gig::Instrument*& output, gig::dimension_t mainDimension, std::set<Glib::ustring>& warnings, int maxThreads) {
+    output = NULL;
+    g_warnings.clear();
+
+    CombinePlan plan = planCombination(instruments, mainDimension);
+    if (plan.empty())
+        throw gig::Exception(_("No regions found to create a new instrument with."));
+
+    // create a new output instrument
+    gig::Instrument* outInstr = gig->AddInstrument();
+    outInstr->pInfo->Name = _("NEW COMBINATION");
+
+    // copy schedule of each target region, the actual copying is done after
+    // all target regions were created
+    std::vector<CopyAssignSchedule> schedules(plan.size());
+
+    // merge the instruments to the new output instrument
+    for (uint iRgn = 0; iRgn < plan.size(); ++iRgn) { // iterate over 'horizontal' / target regions ...
+        PlannedRegion& planned = plan[iRgn];
+        gig::Region* outRgn = outInstr->AddRegion();
+        outRgn->SetKeyRange(planned.keyRange.low, planned.keyRange.high);
+        #if DEBUG_COMBINE_INSTRUMENTS
+        printf("---> Start target region %d..%d\n", planned.keyRange.low, planned.keyRange.high);
+        #endif
+
+        // create all required dimensions for this output region (including
+        // the main dimension, if necessary for current key range)
+        for (uint iDim = 0; iDim < planned.dimensionDefs.size(); ++iDim) {
+            gig::dimension_def_t def = planned.dimensionDefs[iDim];
+            #if DEBUG_COMBINE_INSTRUMENTS
+            std::cout << "Adding new dimension type=" << std::hex << (int)def.dimension << std::dec << ", zones=" << (int)def.zones << ", bits=" << (int)def.bits << " ... " << std::flush;
+            #endif
+            outRgn->AddDimension(&def);
+            #if DEBUG_COMBINE_INSTRUMENTS
+            std::cout << "OK" << std::endl << std::flush;
+            #endif
+        }
+
+        // for the next task we need to have the current RegionGroup to be
+        // sorted by instrument in the same sequence as the 'instruments' vector
+        // argument passed to this function (because the std::map behind the
+        // 'RegionGroup' type sorts by memory address instead, and that would
+        // sometimes lead to the source instruments' region to be sorted into
+        // the wrong target layer)
+        OrderedRegionGroup currentGroup = sortRegionGroup(planned.sources, instruments);
+
+        // schedule copying the source dimension regions to the target dimension
+        // regions
+        CopyAssignSchedule& schedule = schedules[iRgn];
+        int iDstMainBit = 0;
+        for (OrderedRegionGroup::iterator itRgn = currentGroup.begin();
+             itRgn != currentGroup.end(); ++itRgn) // iterate over 'vertical' / source regions ...
+        {
+            gig::Region* inRgn = itRgn->second;
+            #if DEBUG_COMBINE_INSTRUMENTS
+            printf("[source region of '%s']\n", inRgn->GetParent()->pInfo->Name.c_str());
+            #endif
+
+            // determine how many main dimension zones this input region requires
+            gig::dimension_def_t* def = inRgn->GetDimensionDefinition(mainDimension);
+            const int inRgnMainZones = (def) ? def->zones : 1;
+
+            for (uint iSrcMainBit = 0; iSrcMainBit < inRgnMainZones; ++iSrcMainBit, ++iDstMainBit) {
+                scheduleCopyDimensionRegions(
+                    outRgn, inRgn, planned.dims, mainDimension,
+                    iDstMainBit, iSrcMainBit, &schedule
+                );
+            }
+        }
+    }
+
+    // finally copy the scheduled source -> target dimension regions of all
+    // target regions concurrently
+    CopyAssignWorkers(schedules, mainDimension, maxThreads).run();
+
+    // success
+    output = outInstr;
+    warnings = g_warnings;
+}
+
+/** @brief Dry run of combineInstruments().
+ *
+ * Plans the combination of the given @a instruments without touching the
+ * .gig file and returns a short human readable summary of the new instrument
+ * that would be created: the amount of new regions and dimension regions, the
+ * zone counts of its dimensions and all warnings which are already known
+ * before actually copying anything. This is cheap enough to be called on
+ * each change in the dialog.
+ *
+ * @param instruments - list of instruments that are planned to be combined
+ * @param mainDimension - the dimension that shall be used to combine the
+ *                        instruments
+ * @param details - (output) key range and dimension layout of each new region
+ * @returns summary of the planned instrument
+ */
+Glib::ustring previewCombination(std::vector<gig::Instrument*>& instruments, gig::dimension_t mainDimension, Glib::ustring& details) {
+    // don't touch the warnings of the real combine operation, and don't flood
+    // the console with warnings on each preview
+    Warnings warnings;
+    g_warnings.swap(warnings);
+    g_quietWarnings = true;
+
+    CombinePlan plan;
+    try {
+        plan = planCombination(instruments, mainDimension);
+    } catch (RIFF::Exception e) {
+        g_quietWarnings = false;
+        g_warnings.swap(warnings);
+        details.clear();
+        return e.Message;
+    }
+
+    int totalDimRgns = 0, usedDimRgns = 0;
+    std::map<gig::dimension_t, std::pair<int,int> > zoneCounts; // min, max
+    details.clear();
+    for (uint iRgn = 0; iRgn < plan.size(); ++iRgn) {
+        const PlannedRegion& planned = plan[iRgn];
+        int bits = 0, used = 1;
+        Glib::ustring layout;
+        bool hasVelocityDim = false;
+        for (uint iDim = 0; iDim < planned.dimensionDefs.size(); ++iDim) {
+            const gig::dimension_def_t& def = planned.dimensionDefs[iDim];
+            bits += def.bits;
+            used *= def.zones;
+            if (def.dimension == gig::dimension_velocity) hasVelocityDim = true;
+            if (!zoneCounts.count(def.dimension))
+                zoneCounts[def.dimension] = std::pair<int,int>(def.zones, def.zones);
+            std::pair<int,int>& minMax = zoneCounts[def.dimension];
+            minMax.first  = std::min<int>(minMax.first, def.zones);
+            minMax.second = std::max<int>(minMax.second, def.zones);
+            layout += (iDim ? ", " : "") + dimTypeAsString(def.dimension) +
+                      " " + ToString(int(def.zones));
+        }
+        totalDimRgns += 1 << bits;
+        usedDimRgns += used;
+        details += note_str(planned.keyRange.low) + ".." +
+                   note_str(planned.keyRange.high) + ": " +
+                   (layout.empty() ? _("no dimensions") : layout) + "\n";
+
+        // issues of the copy step which can already be predicted here
+        for (RegionGroup::const_iterator itRgn = planned.sources.begin();
+             itRgn != planned.sources.end(); ++itRgn)
+        {
+            gig::dimension_def_t* def =
+                itRgn->second->GetDimensionDefinition(gig::dimension_velocity);
+            if (!def) continue;
+            if (hasVelocityDim && def->zones <= 1)
+                addWarning("Input region has a velocity dimension with only ONE zone!");
+            if (!hasVelocityDim && mainDimension != gig::dimension_velocity)
+                addWarning("Source instrument seems to have a velocity dimension whereas new target instrument doesn't!");
+        }
+    }
+
+    Glib::ustring txt;
+    if (plan.empty()) {
+        txt = _("No regions found to create a new instrument with.");
+    } else {
+        txt = ToString(plan.size()) + " " + _("regions") + ", " +
+              ToString(totalDimRgns) + " " + _("dimension regions") + " (" +
+              ToString(usedDimRgns) + " " + _("used") + ")";
+        for (std::map<gig::dimension_t, std::pair<int,int> >::const_iterator it = zoneCounts.begin();
+             it != zoneCounts.end(); ++it)
+        {
+            txt += "\n" + dimTypeAsString(it->first) + ": ";
+            if (it->second.first == it->second.second)
+                txt += ToString(it->second.first) + " " + _("zones");
+            else
+                txt += ToString(it->second.first) + ".." +
+                       ToString(it->second.second) + " " + _("zones");
+        }
+    }
+    for (Warnings::const_iterator itWarn = g_warnings.begin();
+         itWarn != g_warnings.end(); ++itWarn)
+    {
+        txt += "\n" + Glib::ustring(_("Warning:")) + " " + *itWarn;
+    }
+
+    g_quietWarnings = false;
+    g_warnings.swap(warnings);
+    return txt;
+}
@@ -0,0 +1,27 @@
+/*
+    Copyright (c) 2014-2018 Christian Schoenebeck
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#ifndef GIGEDIT_COMBINEINSTRUMENTS_H
+#define GIGEDIT_COMBINEINSTRUMENTS_H
+
+#include "global.h"
+
+#include <set>
+#include <vector>
+
+// The actual combine instruments task, without any GUI (see
+// CombineInstrumentsDialog for the GUI, and the batch command "combine").
+
+void combineInstruments(std::vector<gig::Instrument*>& instruments, gig::File* gig,
+                        gig::Instrument*& output, gig::dimension_t mainDimension,
+                        std::set<Glib::ustring>& warnings, int maxThreads = 0);
+
+Glib::ustring previewCombination(std::vector<gig::Instrument*>& instruments,
+                                 gig::dimension_t mainDimension,
+                                 Glib::ustring& details);
+
+#endif // GIGEDIT_COMBINEINSTRUMENTS_H
@@ -82,6 +82,7 @@ protected:
     Gtk::ComboBox   m_comboDimType;
     Gtk::Label      m_labelDimType;
     Gtk::Label      m_labelOrder;
+    Gtk::Label      m_labelPreview;
 
     class ComboDimsModel : public Gtk::TreeModel::ColumnRecord {
     public:
@@ -124,7 +125,9 @@ protected:
     Glib::RefPtr<Gtk::ListStore> m_refOrderModel;
     bool first_call_to_drag_data_get;
 
+    std::vector<gig::Instrument*> orderedInstruments() const;
     void combineSelectedInstruments();
+    void updatePreview();
     void onSelectionChanged();
     void on_order_drag_begin(const Glib::RefPtr<Gdk::DragContext>& context);
     void on_order_drag_data_get(const Glib::RefPtr<Gdk::DragContext>&,
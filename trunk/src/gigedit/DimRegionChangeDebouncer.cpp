@@ -0,0 +1,93 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#include "DimRegionChangeDebouncer.h"
+
+#include <stdio.h>
+
+// enable this for debug messages being printed when the regions get suspended
+// and resumed
+#define DEBUG_DIMREGION_DEBOUNCE 0
+
+DimRegionChangeDebouncer::DimRegionChangeDebouncer(Host& host) :
+    host(host), flushScheduled(false), nChangeEvents(0), nRegionNotifications(0)
+{
+}
+
+void DimRegionChangeDebouncer::dimRegionToBeChanged(gig::DimensionRegion* pDimRgn, bool bInstantCommit) {
+    if (!pDimRgn) return;
+    nChangeEvents++;
+    gig::Region* pRegion = (gig::Region*) pDimRgn->GetParent();
+    #if DEBUG_DIMREGION_DEBOUNCE
+    const bool bIdle = debounceRegionChange.empty();
+    #endif
+    bool bRegionLocked = debounceRegionChange.count(pRegion);
+
+    // Instant commit: the region is only suspended until the pending
+    // dimregion changes were applied by gigedit, which announces all changes
+    // of one edit operation before applying them.
+    if (bInstantCommit && !bRegionLocked) {
+        int& pending = commitRegionChange[pRegion];
+        if (!pending++) {
+            nRegionNotifications++;
+            host.regionToBeChanged(pRegion);
+        }
+        return;
+    }
+
+    if (!bRegionLocked) {
+        #if DEBUG_DIMREGION_DEBOUNCE
+        if (bIdle)
+            printf("DimRgn change event debounce BEGIN (%p)\n", pRegion);
+        #endif
+        debounceRegionChange.insert(pRegion);
+        nRegionNotifications++;
+        host.regionToBeChanged(pRegion);
+    }
+}
+
+void DimRegionChangeDebouncer::dimRegionChanged(gig::DimensionRegion* pDimRgn) {
+    if (!pDimRgn) return;
+    gig::Region* pRegion = (gig::Region*) pDimRgn->GetParent();
+    std::map<gig::Region*,int>::iterator itCommit =
+        commitRegionChange.find(pRegion);
+    if (itCommit != commitRegionChange.end()) {
+        // instant commit (see dimRegionToBeChanged())
+        if (!--itCommit->second) {
+            commitRegionChange.erase(itCommit);
+            host.regionChanged(pRegion);
+        }
+        return;
+    }
+    if (!flushScheduled) {
+        flushScheduled = true;
+        host.scheduleFlush();
+    }
+}
+
+/**
+ * Resumes all regions suspended by debounced dimregion changes.
+ *
+ * Note that we are really aggressively unlocking the regions here: we are
+ * not even bothering whether the amount "changed" events match with the
+ * previously sent amount of "to be changed" events, because this is only
+ * called when the app's event loop is already idle for a while, which is not
+ * the case if the app is still changing instrument parameters (except if the
+ * app is i.e. currently showing an error dialog to the user).
+ */
+void DimRegionChangeDebouncer::flush() {
+    flushScheduled = false;
+    for (std::set<gig::Region*>::const_iterator it = debounceRegionChange.begin();
+         it != debounceRegionChange.end(); ++it)
+    {
+        host.regionChanged(*it);
+    }
+    debounceRegionChange.clear();
+    #if DEBUG_DIMREGION_DEBOUNCE
+    printf("DimRgn change event debounce END\n");
+    #endif
+}
@@ -0,0 +1,57 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#ifndef GIGEDIT_DIMREGIONCHANGEDEBOUNCER_H
+#define GIGEDIT_DIMREGIONCHANGEDEBOUNCER_H
+
+#include "global.h"
+
+#include <set>
+
+/** @brief Coalesces dimension region change events to region notifications.
+ *
+ * Suspending a region in the sampler for each single dimension region change
+ * would be very slow when changing a large amount of dimension regions at
+ * once. So instead the affected region is only suspended once and resumed
+ * when the application became idle again. Alternatively (instant commit) the
+ * region is resumed as soon as all of its announced dimension region changes
+ * were applied.
+ *
+ * Independent of the sampler and the GUI, the notifications are sent to a
+ * Host, which is the sampler plugin in live-mode and a mock host when
+ * benchmarking.
+ */
+class DimRegionChangeDebouncer {
+public:
+    /// Receiver of the coalesced region notifications.
+    class Host {
+    public:
+        virtual ~Host() {}
+        virtual void regionToBeChanged(gig::Region* pRegion) = 0;
+        virtual void regionChanged(gig::Region* pRegion) = 0;
+        /// Must call flush() as soon as the application's event loop is idle.
+        virtual void scheduleFlush() = 0;
+    };
+
+    DimRegionChangeDebouncer(Host& host);
+    void dimRegionToBeChanged(gig::DimensionRegion* pDimRgn, bool bInstantCommit);
+    void dimRegionChanged(gig::DimensionRegion* pDimRgn);
+    void flush();
+
+    int changeEvents() const { return nChangeEvents; }
+    int regionNotifications() const { return nRegionNotifications; }
+
+private:
+    Host& host;
+    std::set<gig::Region*> debounceRegionChange;
+    bool flushScheduled;
+    std::map<gig::Region*,int> commitRegionChange; ///< Regions currently suspended for an instant commit, with their amount of pending dimregion changes.
+    int nChangeEvents; ///< Dimregion "to be changed" events received.
+    int nRegionNotifications; ///< Region "to be changed" notifications sent for them.
+};
+
+#endif // GIGEDIT_DIMREGIONCHANGEDEBOUNCER_H
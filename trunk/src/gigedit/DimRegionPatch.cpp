@@ -0,0 +1,100 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#include "DimRegionPatch.h"
+
+/**
+ * Compiles the given @a macro against the memory layout of the given
+ * DimensionRegion. Returns false if the macro contains anything which
+ * cannot be expressed as memory writes within a DimensionRegion object
+ * (i.e. pointers), or which does not match the DimensionRegion's data
+ * structure, in which case the macro must be applied by
+ * Serialization::Archive::deserialize() instead.
+ */
+bool DimRegionPatch::compile(Serialization::Archive& macro, gig::DimensionRegion* pLayout) {
+    ops.clear();
+    if (!macro.rootObject()) return false;
+    Serialization::Archive layout;
+    layout.serialize(pLayout);
+    return compileObject(macro, macro.rootObject(), layout, layout.rootObject(),
+                         (const char*) pLayout);
+}
+
+bool DimRegionPatch::compileObject(Serialization::Archive& src, const Serialization::Object& srcObj,
+                                   Serialization::Archive& dst, const Serialization::Object& dstObj,
+                                   const char* base)
+{
+    if (!srcObj || !dstObj) return false;
+    const Serialization::DataType& type = dstObj.type();
+    if (!(srcObj.type() == type)) return false;
+    // pointed objects are at different addresses for each dimension region
+    if (type.isPointer()) return false;
+
+    if (type.isPrimitive()) {
+        const char* p = (const char*) dstObj.uid().id;
+        if (p < base || p + type.size() > base + sizeof(gig::DimensionRegion))
+            return false;
+        Op op;
+        op.offset = p - base;
+        op.size = type.size();
+        op.integer = 0;
+        op.real = 0;
+        if (type.isReal()) {
+            if (op.size != sizeof(float) && op.size != sizeof(double)) return false;
+            op.kind = Op::REAL;
+            op.real = src.valueAsReal(srcObj);
+        } else if (type.isBool()) {
+            if (op.size != sizeof(bool)) return false;
+            op.kind = Op::BOOLEAN;
+            op.integer = src.valueAsBool(srcObj);
+        } else if (type.isInteger() || type.isEnum()) {
+            if (op.size != 1 && op.size != 2 && op.size != 4 && op.size != 8)
+                return false;
+            op.kind = Op::INTEGER;
+            op.integer = src.valueAsInt(srcObj);
+        } else {
+            return false;
+        }
+        ops.push_back(op);
+        return true;
+    }
+
+    for (int i = 0; i < srcObj.members().size(); ++i) {
+        const Serialization::Member& srcMember = srcObj.members()[i];
+        const Serialization::Member dstMember = dstObj.memberNamed(srcMember.name());
+        if (!dstMember.isValid()) return false;
+        if (!compileObject(src, src.objectByUID(srcMember.uid()),
+                           dst, dst.objectByUID(dstMember.uid()), base))
+            return false;
+    }
+    return true;
+}
+
+void DimRegionPatch::apply(gig::DimensionRegion* pDimRgn) const {
+    char* base = (char*) pDimRgn;
+    for (int i = 0; i < ops.size(); ++i) {
+        const Op& op = ops[i];
+        char* p = base + op.offset;
+        switch (op.kind) {
+            case Op::REAL:
+                if (op.size == sizeof(float)) *(float*)p = op.real;
+                else *(double*)p = op.real;
+                break;
+            case Op::BOOLEAN:
+                *(bool*)p = op.integer;
+                break;
+            case Op::INTEGER:
+                switch (op.size) {
+                    case 1: *(int8_t*)p  = op.integer; break;
+                    case 2: *(int16_t*)p = op.integer; break;
+                    case 4: *(int32_t*)p = op.integer; break;
+                    case 8: *(int64_t*)p = op.integer; break;
+                }
+                break;
+        }
+    }
+}
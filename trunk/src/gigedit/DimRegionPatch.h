@@ -0,0 +1,43 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#ifndef GIGEDIT_DIMREGIONPATCH_H
+#define GIGEDIT_DIMREGIONPATCH_H
+
+#include "global.h"
+
+#include <vector>
+
+/**
+ * A macro (serialized DimensionRegion) compiled to a flat list of memory
+ * writes relative to the address of a DimensionRegion object. Applying
+ * it to a large amount of dimension regions is much faster than calling
+ * Serialization::Archive::deserialize() for each one of them, which has
+ * to serialize the target object and to resolve the archive's object
+ * graph against it each time.
+ */
+class DimRegionPatch {
+public:
+    bool compile(Serialization::Archive& macro, gig::DimensionRegion* pLayout);
+    void apply(gig::DimensionRegion* pDimRgn) const;
+
+private:
+    struct Op {
+        enum kind_t { INTEGER, REAL, BOOLEAN } kind;
+        size_t offset; ///< Byte offset of the member within DimensionRegion.
+        int size; ///< Size of the member in bytes.
+        int64_t integer;
+        double real;
+    };
+    std::vector<Op> ops;
+
+    bool compileObject(Serialization::Archive& src, const Serialization::Object& srcObj,
+                       Serialization::Archive& dst, const Serialization::Object& dstObj,
+                       const char* base);
+};
+
+#endif // GIGEDIT_DIMREGIONPATCH_H
@@ -0,0 +1,266 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#include "DimensionOptimizer.h"
+
+#include <map>
+
+// Members of a dimension region which define the boundaries of its
+// dimension zones, so they differ among zones by definition.
+static bool isZoneBoundary(const std::string& memberName) {
+    return memberName == "VelocityUpperLimit" ||
+           memberName.find("DimensionUpperLimits") == 0;
+}
+
+static void appendFingerprint(Serialization::Archive& archive,
+                              const Serialization::Object& object,
+                              std::string& s)
+{
+    for (int i = 0; i < object.members().size(); ++i) {
+        const Serialization::Member& member = object.members()[i];
+        if (isZoneBoundary(member.name())) continue;
+        const Serialization::Object& child = archive.objectByUID(member.uid());
+        if (!child || child.type().isPointer()) continue;
+        s += member.name();
+        s += '=';
+        if (child.type().isClass()) {
+            s += '{';
+            appendFingerprint(archive, child, s);
+            s += '}';
+        } else {
+            s += archive.valueAsString(child);
+        }
+        s += ';';
+    }
+}
+
+// Playback parameters of the dimension region's DLS::Sampler base class,
+// including the contents of its sample loops. appendFingerprint() skips
+// pointer members and libgig does not necessarily archive the base class
+// members, so they are added explicitly.
+static void appendSamplerFingerprint(gig::DimensionRegion* dr, std::string& s) {
+    s += "UnityNote=" + ToString(int(dr->UnityNote)) + ";";
+    s += "FineTune=" + ToString(dr->FineTune) + ";";
+    s += "Gain=" + ToString(dr->Gain) + ";";
+    s += "SampleAttenuation=" + ToString(dr->SampleAttenuation) + ";";
+    s += "NoSampleDepthTruncation=" + ToString(dr->NoSampleDepthTruncation) + ";";
+    s += "NoSampleCompression=" + ToString(dr->NoSampleCompression) + ";";
+    s += "SampleLoops=" + ToString(dr->SampleLoops) + ";";
+    for (uint i = 0; i < dr->SampleLoops; ++i) {
+        const DLS::sample_loop_t& loop = dr->pSampleLoops[i];
+        s += "Loop{" + ToString(loop.Size) + "," + ToString(loop.LoopType) +
+             "," + ToString(loop.LoopStart) + "," + ToString(loop.LoopLength) +
+             "};";
+    }
+}
+
+// Equal dimension regions (except of their zone boundaries) have equal
+// fingerprints.
+static std::string fingerprint(gig::DimensionRegion* dr) {
+    Serialization::Archive archive;
+    archive.serialize(dr);
+    std::string s;
+    // the sample reference is not covered by libgig's serialization
+    s += ToString(dr->pSample) + ";";
+    appendSamplerFingerprint(dr, s);
+    appendFingerprint(archive, archive.rootObject(), s);
+    return s;
+}
+
+// Dimensions whose zones are not selected exclusively, but several of them
+// are triggered by one note (all layers, both stereo channels, the note-on
+// and the release trigger zone), so equal zones still sound differently
+// (i.e. louder) than a single one and must be kept.
+static bool isCollapsible(gig::dimension_t type) {
+    return type != gig::dimension_layer &&
+           type != gig::dimension_releasetrigger &&
+           type != gig::dimension_samplechannel &&
+           type != gig::dimension_none;
+}
+
+DimensionOptimizer::DimensionOptimizer() : m_before(0), m_after(0) {
+}
+
+/**
+ * Searches all regions of all instruments of the given file for redundant
+ * dimensions and dimension zones. Results of a previous analysis are
+ * discarded.
+ */
+void DimensionOptimizer::analyze(gig::File* file) {
+    m_redundancies.clear();
+    m_errors.clear();
+    m_before = m_after = 0;
+    for (gig::Instrument* instr = file->GetFirstInstrument(); instr;
+         instr = file->GetNextInstrument())
+    {
+        // collect the regions first, since analyzeRegion() may not interfere
+        // with the instrument's region iteration
+        std::vector<gig::Region*> regions;
+        for (gig::Region* rgn = instr->GetFirstRegion(); rgn;
+             rgn = instr->GetNextRegion())
+        {
+            regions.push_back(rgn);
+        }
+        for (int i = 0; i < regions.size(); ++i)
+            analyzeRegion(regions[i]);
+    }
+}
+
+void DimensionOptimizer::analyzeRegion(gig::Region* rgn) {
+    const int nDimRgns = rgn->DimensionRegions;
+    m_before += nDimRgns;
+
+    // bit position of each dimension within the dimension region index
+    std::vector<int> bitpos(rgn->Dimensions);
+    for (int d = 0, pos = 0; d < rgn->Dimensions; ++d) {
+        bitpos[d] = pos;
+        pos += rgn->pDimensionDefinitions[d].bits;
+    }
+
+    // only compare used dimension regions, and compare them by an integer ID
+    // of their fingerprint instead of the fingerprint itself
+    std::vector<int> ids(nDimRgns, -1);
+    std::map<std::string,int> idOfFingerprint;
+    for (int idr = 0; idr < nDimRgns; ++idr) {
+        if (!rgn->pDimensionRegions[idr]) continue;
+        bool used = true;
+        for (int d = 0; d < rgn->Dimensions && used; ++d) {
+            const gig::dimension_def_t& def = rgn->pDimensionDefinitions[d];
+            const int zone = (idr >> bitpos[d]) & ((1 << def.bits) - 1);
+            if (zone >= def.zones) used = false;
+        }
+        if (!used) continue;
+        const std::string fp = fingerprint(rgn->pDimensionRegions[idr]);
+        std::map<std::string,int>::iterator it = idOfFingerprint.find(fp);
+        if (it == idOfFingerprint.end())
+            it = idOfFingerprint.insert(std::make_pair(fp, int(idOfFingerprint.size()))).first;
+        ids[idr] = it->second;
+    }
+
+    int bitsAfter = 0;
+    for (int d = 0; d < rgn->Dimensions; ++d) {
+        const gig::dimension_def_t& def = rgn->pDimensionDefinitions[d];
+        if (!def.bits || !isCollapsible(def.dimension)) {
+            bitsAfter += def.bits;
+            continue;
+        }
+        const int mask = ((1 << def.bits) - 1) << bitpos[d];
+
+        // whether zone z leads to the same dimension regions as zone z-1
+        std::vector<bool> equalToPrevious(def.zones, true);
+        for (int idr = 0; idr < nDimRgns; ++idr) {
+            if (ids[idr] < 0) continue;
+            const int zone = (idr & mask) >> bitpos[d];
+            if (zone < 1) continue;
+            const int prev = (idr & ~mask) | ((zone - 1) << bitpos[d]);
+            if (ids[prev] != ids[idr]) equalToPrevious[zone] = false;
+        }
+
+        int merged = 0;
+        for (int z = 1; z < def.zones; ++z)
+            if (equalToPrevious[z]) merged++;
+
+        if (merged == def.zones - 1) {
+            Redundancy r = { rgn, def.dimension, -1 };
+            m_redundancies.push_back(r);
+            continue;
+        }
+        // zones are deleted from the highest one downwards by apply(), so
+        // the zone indices remain valid
+        for (int z = def.zones - 1; z >= 1; --z) {
+            if (!equalToPrevious[z]) continue;
+            Redundancy r = { rgn, def.dimension, z };
+            m_redundancies.push_back(r);
+        }
+        bitsAfter += zoneCountToBits(def.zones - merged);
+    }
+    m_after += 1 << bitsAfter;
+}
+
+/// All redundant dimensions and dimension zones found by analyze().
+const std::vector<DimensionOptimizer::Redundancy>& DimensionOptimizer::redundancies() const {
+    return m_redundancies;
+}
+
+/// Total amount of dimension regions of the file when it was analyzed.
+int DimensionOptimizer::dimensionRegionsBefore() const {
+    return m_before;
+}
+
+/// Total amount of dimension regions of the file after apply().
+int DimensionOptimizer::dimensionRegionsAfter() const {
+    return m_after;
+}
+
+/**
+ * Memory which would no longer be occupied by dimension region objects,
+ * both in the sampler and in the editor, after apply(). This does not
+ * include the sample data, which remains shared.
+ */
+size_t DimensionOptimizer::bytesSaved() const {
+    return size_t(m_before - m_after) * sizeof(gig::DimensionRegion);
+}
+
+/// Human readable summary of the last analysis.
+Glib::ustring DimensionOptimizer::report() const {
+    Glib::ustring s;
+    gig::Instrument* instr = NULL;
+    for (int i = 0; i < m_redundancies.size(); ++i) {
+        const Redundancy& r = m_redundancies[i];
+        gig::Instrument* parent = (gig::Instrument*) r.region->GetParent();
+        if (parent != instr) {
+            instr = parent;
+            s += _("Instrument") + Glib::ustring(" '") +
+                 gig_to_utf8(instr->pInfo->Name) + "':\n";
+        }
+        s += "  " + note_str(r.region->KeyRange.low) + ".." +
+             note_str(r.region->KeyRange.high) + ": ";
+        if (r.zone < 0) {
+            s += _("remove dimension") + Glib::ustring(" '") +
+                 dimTypeAsString(r.dimension) + "'\n";
+        } else {
+            s += _("merge zone") + Glib::ustring(" ") + ToString(r.zone) + " " +
+                 _("into zone") + " " + ToString(r.zone - 1) + " " +
+                 _("of dimension") + " '" + dimTypeAsString(r.dimension) + "'\n";
+        }
+    }
+    if (m_redundancies.empty())
+        s += _("No redundant dimensions found.") + Glib::ustring("\n");
+    s += "\n";
+    s += _("Dimension regions before: ") + ToString(m_before) + "\n";
+    s += _("Dimension regions after: ") + ToString(m_after) + "\n";
+    s += _("Memory saved: ") + ToString(bytesSaved() / 1024) + " kB\n";
+    return s;
+}
+
+/**
+ * Collapses all redundant dimensions and dimension zones found by the last
+ * call of analyze(). The file must not have been modified since. Errors do
+ * not abort, they are collected and can be retrieved with errors().
+ */
+void DimensionOptimizer::apply() {
+    m_errors.clear();
+    for (int i = 0; i < m_redundancies.size(); ++i) {
+        const Redundancy& r = m_redundancies[i];
+        try {
+            if (r.zone < 0) {
+                gig::dimension_def_t* def = r.region->GetDimensionDefinition(r.dimension);
+                if (def) r.region->DeleteDimension(def);
+            } else {
+                r.region->DeleteDimensionZone(r.dimension, r.zone);
+            }
+        } catch (RIFF::Exception e) {
+            m_errors.insert(e.Message);
+        }
+    }
+    m_redundancies.clear();
+}
+
+/// Errors which occurred on the last call of apply().
+const std::set<Glib::ustring>& DimensionOptimizer::errors() const {
+    return m_errors;
+}
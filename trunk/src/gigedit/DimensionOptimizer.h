@@ -0,0 +1,60 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#ifndef GIGEDIT_DIMENSIONOPTIMIZER_H
+#define GIGEDIT_DIMENSIONOPTIMIZER_H
+
+#include "global.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+/** @brief Finds and collapses redundant dimensions of all regions of a file.
+ *
+ * A dimension is redundant if all of its zones lead to equal dimension
+ * regions, for every combination of zones of the other dimensions of the
+ * region. In that case the dimension can be removed entirely. Likewise a
+ * single dimension zone is redundant if it leads to the same dimension
+ * regions as its previous zone, in which case both zones can be merged.
+ *
+ * Dimension regions are compared by all their members serialized by libgig
+ * (except of their zone boundaries), by their sample reference and by their
+ * sampler playback parameters including their sample loops. Unused
+ * dimension regions (zones beyond a dimension's zone amount) are ignored.
+ * Dimensions of which several zones are triggered by one note (layer,
+ * release trigger and sample channel) are never considered redundant.
+ */
+class DimensionOptimizer {
+public:
+    /// One dimension or dimension zone which can be collapsed.
+    struct Redundancy {
+        gig::Region* region;
+        gig::dimension_t dimension;
+        int zone; ///< Zone to be merged with its previous zone, or -1 if the entire dimension can be removed.
+    };
+
+    DimensionOptimizer();
+    void analyze(gig::File* file);
+    const std::vector<Redundancy>& redundancies() const;
+    int dimensionRegionsBefore() const;
+    int dimensionRegionsAfter() const;
+    size_t bytesSaved() const;
+    Glib::ustring report() const;
+    void apply();
+    const std::set<Glib::ustring>& errors() const;
+
+private:
+    std::vector<Redundancy> m_redundancies;
+    int m_before;
+    int m_after;
+    std::set<Glib::ustring> m_errors;
+
+    void analyzeRegion(gig::Region* rgn);
+};
+
+#endif // GIGEDIT_DIMENSIONOPTIMIZER_H
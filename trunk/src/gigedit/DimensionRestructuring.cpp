@@ -0,0 +1,156 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#include "DimensionRestructuring.h"
+
+///////////////////////////////////////////////////////////////////////////
+// class 'DimensionStats'
+
+void DimensionStats::add(gig::Region* region) {
+    for (uint i = 0; i < region->Dimensions; ++i) {
+        gig::dimension_def_t* dim = &region->pDimensionDefinitions[i];
+        Usage& usage = dimensions[dim->dimension];
+        usage.bits.insert(dim->bits);
+        usage.zones.insert(dim->zones);
+        usage.usageCount++;
+    }
+    regions++;
+}
+
+DimensionStats DimensionStats::of(gig::Instrument* instrument) {
+    DimensionStats stats;
+    for (gig::Region* rgn = instrument->GetFirstRegion(); rgn;
+         rgn = instrument->GetNextRegion())
+    {
+        stats.add(rgn);
+    }
+    return stats;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// class 'DimensionRestructuring'
+
+DimensionRestructuring::DimensionRestructuring() {
+}
+
+/**
+ * Schedules adding the given dimension to all regions which don't have a
+ * dimension of that type yet.
+ */
+void DimensionRestructuring::addDimension(const gig::dimension_def_t& dim) {
+    additions.push_back(dim);
+}
+
+/**
+ * Schedules removing the dimension of the given type from all regions which
+ * have such a dimension.
+ */
+void DimensionRestructuring::removeDimension(gig::dimension_t type) {
+    removals.push_back(type);
+}
+
+/**
+ * Schedules changing the type of dimension @a oldType to @a newType on all
+ * regions which have a dimension of type @a oldType.
+ */
+void DimensionRestructuring::changeDimensionType(gig::dimension_t oldType, gig::dimension_t newType) {
+    typeChanges.push_back(std::make_pair(oldType, newType));
+}
+
+bool DimensionRestructuring::empty() const {
+    return typeChanges.empty() && removals.empty() && additions.empty();
+}
+
+/**
+ * Applies all scheduled changes to the given regions. Errors do not abort
+ * the batch, they are collected and can be retrieved with errors()
+ * afterwards. After all regions were processed, the dimension stats of the
+ * instruments of the regions are updated.
+ */
+void DimensionRestructuring::apply(const std::vector<gig::Region*>& regions) {
+    begin();
+    for (size_t i = 0; i < regions.size(); ++i)
+        apply(regions[i]);
+    finish(regions);
+}
+
+/// Starts applying the batch stepwise, clearing results of a previous run.
+void DimensionRestructuring::begin() {
+    m_errors.clear();
+    m_stats.clear();
+}
+
+/**
+ * Applies all scheduled changes to the given single region. Must be called
+ * between begin() and finish().
+ */
+void DimensionRestructuring::apply(gig::Region* region) {
+    for (size_t i = 0; i < typeChanges.size(); ++i) {
+        if (!region->GetDimensionDefinition(typeChanges[i].first)) continue;
+        try {
+            region->SetDimensionType(typeChanges[i].first, typeChanges[i].second);
+        } catch (RIFF::Exception e) {
+            m_errors.insert(_("Could not alter dimension: ") + e.Message);
+        }
+    }
+    for (size_t i = 0; i < removals.size(); ++i) {
+        gig::dimension_def_t* dim = region->GetDimensionDefinition(removals[i]);
+        if (!dim) continue;
+        try {
+            region->DeleteDimension(dim);
+        } catch (RIFF::Exception e) {
+            m_errors.insert(_("Could not remove dimension: ") + e.Message);
+        }
+    }
+    for (size_t i = 0; i < additions.size(); ++i) {
+        if (region->GetDimensionDefinition(additions[i].dimension)) continue;
+        // AddDimension() expects a non-const pointer
+        gig::dimension_def_t dim = additions[i];
+        try {
+            region->AddDimension(&dim);
+        } catch (RIFF::Exception e) {
+            m_errors.insert(_("Could not add dimension: ") + e.Message);
+        }
+    }
+}
+
+/**
+ * Ends applying the batch stepwise, updating the dimension stats of the
+ * instruments of the given regions.
+ */
+void DimensionRestructuring::finish(const std::vector<gig::Region*>& regions) {
+    const std::set<gig::Instrument*> instruments = instrumentsOf(regions);
+    for (std::set<gig::Instrument*>::const_iterator it = instruments.begin();
+         it != instruments.end(); ++it)
+    {
+        m_stats[*it] = DimensionStats::of(*it);
+    }
+}
+
+/// Errors which occurred since the last call of begin().
+const std::set<Glib::ustring>& DimensionRestructuring::errors() const {
+    return m_errors;
+}
+
+/**
+ * Dimension stats of all regions of the given instrument, as they were
+ * after the last call of finish(). Only available for instruments of the
+ * regions passed to finish().
+ */
+const DimensionStats& DimensionRestructuring::stats(gig::Instrument* instrument) const {
+    static const DimensionStats none;
+    std::map<gig::Instrument*,DimensionStats>::const_iterator it = m_stats.find(instrument);
+    return (it != m_stats.end()) ? it->second : none;
+}
+
+/// Returns the instruments the given regions belong to.
+std::set<gig::Instrument*> DimensionRestructuring::instrumentsOf(const std::vector<gig::Region*>& regions) {
+    std::set<gig::Instrument*> instruments;
+    for (size_t i = 0; i < regions.size(); ++i)
+        instruments.insert((gig::Instrument*) regions[i]->GetParent());
+    return instruments;
+}
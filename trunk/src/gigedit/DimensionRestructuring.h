@@ -0,0 +1,79 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#ifndef GIGEDIT_DIMENSIONRESTRUCTURING_H
+#define GIGEDIT_DIMENSIONRESTRUCTURING_H
+
+#include "global.h"
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+/** @brief Aggregated dimension definitions of a set of regions.
+ *
+ * For each dimension type it lists the different amounts of bits and zones
+ * the dimension has among the regions, and on how many of the regions the
+ * dimension exists at all.
+ */
+struct DimensionStats {
+    struct Usage {
+        std::set<int> bits;
+        std::set<int> zones;
+        int usageCount;
+
+        Usage() : usageCount(0) {}
+    };
+    typedef std::map<gig::dimension_t, Usage> Dimensions;
+
+    Dimensions dimensions;
+    int regions; ///< Total amount of regions the stats were built from.
+
+    DimensionStats() : regions(0) {}
+    void add(gig::Region* region);
+    static DimensionStats of(gig::Instrument* instrument);
+};
+
+/** @brief Changes the dimension layout of many regions in one pass.
+ *
+ * Collects the requested dimension changes first and then applies all of
+ * them region by region with apply(). The batch can also be applied
+ * stepwise, i.e. from an idle handler: call begin(), then apply() for each
+ * region and finally finish() with all regions of the batch. Each region is restructured only once
+ * by the entire batch: dimension types are changed first, then dimensions
+ * are removed (which frees dimension bits) and finally new dimensions are
+ * added. A change which does not apply to a region (i.e. adding a dimension
+ * the region already has) is skipped for that region.
+ *
+ * The caller is responsible for notifying the sampler about the structure
+ * change, ideally once for the entire batch.
+ */
+class DimensionRestructuring {
+public:
+    DimensionRestructuring();
+    void addDimension(const gig::dimension_def_t& dim);
+    void removeDimension(gig::dimension_t type);
+    void changeDimensionType(gig::dimension_t oldType, gig::dimension_t newType);
+    bool empty() const;
+    void apply(const std::vector<gig::Region*>& regions);
+    void begin();
+    void apply(gig::Region* region);
+    void finish(const std::vector<gig::Region*>& regions);
+    const std::set<Glib::ustring>& errors() const;
+    const DimensionStats& stats(gig::Instrument* instrument) const;
+    static std::set<gig::Instrument*> instrumentsOf(const std::vector<gig::Region*>& regions);
+
+private:
+    std::vector< std::pair<gig::dimension_t,gig::dimension_t> > typeChanges;
+    std::vector<gig::dimension_t> removals;
+    std::vector<gig::dimension_def_t> additions;
+    std::set<Glib::ustring> m_errors;
+    std::map<gig::Instrument*,DimensionStats> m_stats;
+};
+
+#endif // GIGEDIT_DIMENSIONRESTRUCTURING_H
@@ -0,0 +1,49 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#include "GigMerger.h"
+
+#include <stdio.h>
+
+/** @brief Merge the content of other .gig files into a .gig file.
+ *
+ * First checks whether all input files can be opened (to avoid output file
+ * corruption), without keeping them open, then merges the files one by one
+ * into @a gig. The merged file still has to be saved by the caller.
+ *
+ * @param gig - (input/output) .gig file the others are merged into
+ * @param filenames - .gig files to be merged
+ * @param fileStarted - called with the index of each file before it is
+ *                      merged
+ * @throw RIFF::Exception on errors, the message names the offending file
+ */
+void mergeGigFiles(gig::File* gig, const std::vector<std::string>& filenames,
+                   const sigc::slot<void,int>& fileStarted)
+{
+    int i = 0;
+    Glib::ustring action = _("Error occurred while opening '");
+    try {
+        for (i = 0; i < filenames.size(); ++i) {
+            fprintf(stderr, "opening file=%s\n", filenames[i].c_str());
+            RIFF::File riff(filenames[i]);
+            gig::File source(&riff);
+        }
+
+        action = _("Error occurred while merging '");
+        for (i = 0; i < filenames.size(); ++i) {
+            if (!fileStarted.empty()) fileStarted(i);
+            fprintf(stderr, "merging file=%s\n", filenames[i].c_str());
+            RIFF::File riff(filenames[i]);
+            gig::File source(&riff);
+            // this also writes the source's sample data directly to disk, so
+            // the source file can be closed right after
+            gig->AddContentOf(&source);
+        }
+    } catch (RIFF::Exception e) {
+        throw RIFF::Exception(action + filenames[i] + "': " + e.Message);
+    }
+}
@@ -0,0 +1,19 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#ifndef GIGEDIT_GIGMERGER_H
+#define GIGEDIT_GIGMERGER_H
+
+#include "global.h"
+
+#include <string>
+#include <vector>
+
+void mergeGigFiles(gig::File* gig, const std::vector<std::string>& filenames,
+                   const sigc::slot<void,int>& fileStarted = sigc::slot<void,int>());
+
+#endif // GIGEDIT_GIGMERGER_H
@@ -10,7 +10,6 @@
 #include "compat.h"
 
 Glib::ustring gig_to_utf8(const gig::String& gig_string);
-Glib::ustring note_str(int note);
 
 ReferencesView::ReferencesView(Gtk::Window& parent) :
     ManagedDialog("", parent, true), m_sample(NULL),
@@ -0,0 +1,401 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#include "SampleHashIndex.h"
+
+#include <iostream>
+
+#ifdef LIBSNDFILE_HEADER_FILE
+# include LIBSNDFILE_HEADER_FILE(sndfile.h)
+#else
+# include <sndfile.h>
+#endif
+
+// amount of sample points read from disk at once
+#define BLOCK_FRAMES 32768
+
+namespace {
+
+/**
+ * Fast (non-cryptographic) 64 bit hash over a stream of bytes. The result
+ * only depends on the bytes, not on how they were split up into blocks when
+ * passed to update().
+ */
+class ContentHash {
+public:
+    ContentHash() : h(0xcbf29ce484222325ULL), tail(0), nTail(0), length(0) {}
+
+    void update(const uint8_t* p, size_t n) {
+        length += n;
+        // complete pending word of previous block first
+        for (; n && nTail; --n) {
+            tail |= uint64_t(*p++) << (8 * nTail);
+            if (++nTail == 8) {
+                mix(tail);
+                tail = 0;
+                nTail = 0;
+            }
+        }
+        for (; n >= 8; p += 8, n -= 8) {
+            mix(uint64_t(p[0])       | uint64_t(p[1]) << 8  |
+                uint64_t(p[2]) << 16 | uint64_t(p[3]) << 24 |
+                uint64_t(p[4]) << 32 | uint64_t(p[5]) << 40 |
+                uint64_t(p[6]) << 48 | uint64_t(p[7]) << 56);
+        }
+        for (; n; --n)
+            tail |= uint64_t(*p++) << (8 * nTail++);
+    }
+
+    uint64_t value() const {
+        ContentHash c = *this;
+        if (c.nTail) c.mix(c.tail);
+        uint64_t x = c.h ^ length;
+        // final avalanche (as of MurmurHash3)
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+private:
+    uint64_t h;
+    uint64_t tail;
+    int nTail;
+    uint64_t length;
+
+    void mix(uint64_t w) {
+        h ^= w * 0x9e3779b97f4a7c15ULL;
+        h = (h << 27) | (h >> 37);
+        h = h * 5 + 0x52dce729;
+    }
+};
+
+/**
+ * Reads an audio file with libsndfile, converted to exactly the same sample
+ * data as it would be written to the .gig file when importing that audio file
+ * as new sample (see MainWindow::__import_queued_samples()).
+ */
+class AudioFileReader {
+public:
+    AudioFileReader(const std::string& filename) : bitDepth(0) {
+        info.format = 0;
+        hFile = sf_open(filename.c_str(), SFM_READ, &info);
+        if (!hFile) return;
+        sf_command(hFile, SFC_SET_SCALE_FLOAT_INT_READ, 0, SF_TRUE);
+        switch (info.format & 0xff) {
+            case SF_FORMAT_PCM_S8:
+            case SF_FORMAT_PCM_16:
+            case SF_FORMAT_PCM_U8:
+                bitDepth = 16;
+                break;
+            case SF_FORMAT_PCM_24:
+            case SF_FORMAT_PCM_32:
+            case SF_FORMAT_FLOAT:
+            case SF_FORMAT_DOUBLE:
+                bitDepth = 24;
+                break;
+        }
+    }
+
+    ~AudioFileReader() {
+        if (hFile) sf_close(hFile);
+    }
+
+    /// Whether the file could be opened and its format is supported.
+    bool isValid() const { return hFile && bitDepth; }
+    int channels() const { return info.channels; }
+    int bits() const { return bitDepth; }
+    uint32_t sampleRate() const { return info.samplerate; }
+    uint32_t frames() const { return info.frames; }
+    int frameSize() const { return bitDepth / 8 * info.channels; }
+
+    /**
+     * Reads up to @a nFrames sample points into @a buffer, which must be
+     * large enough for that amount of frames, and returns the amount of
+     * sample points actually read.
+     */
+    size_t read(uint8_t* buffer, size_t nFrames) {
+        if (bitDepth == 16)
+            return sf_readf_short(hFile, (short*) buffer, nFrames);
+        // libsndfile returns 32 bits, convert to 24
+        srcbuf.resize(nFrames * info.channels);
+        const size_t n = sf_readf_int(hFile, &srcbuf[0], nFrames);
+        int j = 0;
+        for (int i = 0; i < n * info.channels; i++) {
+            buffer[j++] = srcbuf[i] >> 8;
+            buffer[j++] = srcbuf[i] >> 16;
+            buffer[j++] = srcbuf[i] >> 24;
+        }
+        return n;
+    }
+
+private:
+    SF_INFO info;
+    SNDFILE* hFile;
+    int bitDepth;
+    std::vector<int> srcbuf;
+};
+
+inline SampleHashIndex::Key keyOf(gig::Sample* sample) {
+    SampleHashIndex::Key key;
+    key.channels = sample->Channels;
+    key.bitDepth = sample->BitDepth;
+    key.sampleRate = sample->SamplesPerSecond;
+    key.frames = sample->SamplesTotal;
+    key.hash = 0;
+    return key;
+}
+
+/**
+ * Reads up to @a nFrames sample points of @a sample, from its current
+ * position, into @a buffer.
+ */
+inline size_t readSample(gig::Sample* sample, std::vector<uint8_t>& buffer, size_t nFrames) {
+    buffer.resize(nFrames * sample->FrameSize);
+    return sample->Read(&buffer[0], nFrames);
+}
+
+} // anonymous namespace
+
+bool SampleHashIndex::Key::operator<(const Key& other) const {
+    if (hash != other.hash) return hash < other.hash;
+    if (frames != other.frames) return frames < other.frames;
+    if (channels != other.channels) return channels < other.channels;
+    if (sampleRate != other.sampleRate) return sampleRate < other.sampleRate;
+    return bitDepth < other.bitDepth;
+}
+
+SampleHashIndex::SampleHashIndex() : nextJob(0), jobsDone(0) {
+}
+
+/**
+ * Hashes the sample data of all samples of the given .gig @a file which were
+ * not hashed yet. Samples in @a skip are ignored (i.e. samples whose sample
+ * data was not imported yet). Blocks until all samples were hashed.
+ *
+ * The optional @a progress slot is called with the fraction of samples hashed
+ * so far after each sample, from the worker threads.
+ */
+void SampleHashIndex::update(gig::File* file, const std::set<gig::Sample*>& skip,
+                             const sigc::slot<void,float>& progress)
+{
+    std::set<gig::Sample*> samples;
+    jobs.clear();
+    nextJob = 0;
+    jobsDone = 0;
+    progressSlot = progress;
+    for (int i = 0; file->GetSample(i); ++i) {
+        gig::Sample* sample = file->GetSample(i);
+        samples.insert(sample);
+        if (!keys.count(sample) && !skip.count(sample))
+            jobs.push_back(sample);
+    }
+    // drop samples which are not part of the file (anymore)
+    for (std::map<gig::Sample*,Key>::iterator it = keys.begin(); it != keys.end(); ) {
+        if (samples.count(it->first) && !skip.count(it->first)) ++it;
+        else keys.erase(it++);
+    }
+
+    const int nThreads = std::min<int>(jobs.size(), g_get_num_processors());
+    std::vector<Glib::Threads::Thread*> threads;
+    for (int i = 0; i < nThreads; ++i) {
+#ifdef OLD_THREADS
+        threads.push_back(Glib::Thread::create(sigc::mem_fun(*this, &SampleHashIndex::thread_function), true));
+#else
+        threads.push_back(Glib::Threads::Thread::create(sigc::mem_fun(*this, &SampleHashIndex::thread_function)));
+#endif
+    }
+    for (int i = 0; i < threads.size(); ++i)
+        threads[i]->join();
+    jobs.clear();
+    progressSlot = sigc::slot<void,float>();
+}
+
+#if defined(WIN32) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 2))
+// make sure stack is 16-byte aligned for SSE instructions
+__attribute__((force_align_arg_pointer))
+#endif
+void SampleHashIndex::thread_function() {
+    std::vector<uint8_t> buffer;
+    while (true) {
+        gig::Sample* sample;
+        {
+            Glib::Threads::Mutex::Lock lock(mutex);
+            if (nextJob >= jobs.size()) break;
+            sample = jobs[nextJob++];
+        }
+
+        Key key = keyOf(sample);
+        ContentHash hash;
+        try {
+            size_t n;
+            {
+                Glib::Threads::Mutex::Lock lock(ioMutex);
+                sample->SetPos(0);
+                n = readSample(sample, buffer, BLOCK_FRAMES);
+            }
+            while (n) {
+                hash.update(&buffer[0], n * sample->FrameSize);
+                Glib::Threads::Mutex::Lock lock(ioMutex);
+                n = readSample(sample, buffer, BLOCK_FRAMES);
+            }
+            key.hash = hash.value();
+        } catch (RIFF::Exception e) {
+            std::cerr << "Could not read sample data: " << e.Message << std::endl;
+            sample = NULL; // don't index this sample
+        }
+
+        float fraction;
+        {
+            Glib::Threads::Mutex::Lock lock(mutex);
+            if (sample) keys[sample] = key;
+            fraction = float(++jobsDone) / jobs.size();
+        }
+        if (progressSlot) progressSlot(fraction);
+    }
+}
+
+/**
+ * Drops the given @a sample from the index, must be called before its sample
+ * data is modified or before it is deleted.
+ */
+void SampleHashIndex::forget(gig::Sample* sample) {
+    keys.erase(sample);
+}
+
+void SampleHashIndex::clear() {
+    keys.clear();
+}
+
+/**
+ * Returns all groups of samples of the given .gig @a file with identical
+ * sample data, in the order of the samples in the file. Samples in @a skip are
+ * ignored.
+ */
+std::vector<SampleHashIndex::Duplicates> SampleHashIndex::duplicates(gig::File* file, const std::set<gig::Sample*>& skip) {
+    update(file, skip);
+
+    std::map<Key,Duplicates> candidates;
+    for (int i = 0; file->GetSample(i); ++i) {
+        gig::Sample* sample = file->GetSample(i);
+        if (!keys.count(sample)) continue;
+        candidates[keys[sample]].push_back(sample);
+    }
+
+    std::vector<Duplicates> result;
+    for (std::map<Key,Duplicates>::iterator it = candidates.begin();
+         it != candidates.end(); ++it)
+    {
+        // confirm equal hashes by comparing the entire sample data
+        Duplicates rest = it->second;
+        while (rest.size() > 1) {
+            Duplicates same, others;
+            same.push_back(rest[0]);
+            for (int i = 1; i < rest.size(); ++i) {
+                if (sameContent(rest[0], rest[i]))
+                    same.push_back(rest[i]);
+                else
+                    others.push_back(rest[i]);
+            }
+            if (same.size() > 1) result.push_back(same);
+            rest = others;
+        }
+    }
+    return result;
+}
+
+/**
+ * Returns a sample of the given .gig @a file with exactly the same sample
+ * data as the audio file @a audioFileName would have after being imported,
+ * or NULL if there is no such sample. Samples in @a skip are ignored.
+ */
+gig::Sample* SampleHashIndex::find(gig::File* file, const std::string& audioFileName, const std::set<gig::Sample*>& skip) {
+    Key key;
+    if (!keyOfAudioFile(audioFileName, key)) return NULL;
+    update(file, skip);
+    for (std::map<gig::Sample*,Key>::iterator it = keys.begin(); it != keys.end(); ++it) {
+        if (key < it->second || it->second < key) continue;
+        if (sameContent(it->first, audioFileName))
+            return it->first;
+    }
+    return NULL;
+}
+
+/**
+ * Computes the key of the sample data the given audio file would have after
+ * being imported as sample. Returns false if the file could not be read.
+ */
+bool SampleHashIndex::keyOfAudioFile(const std::string& audioFileName, Key& key) {
+    AudioFileReader reader(audioFileName);
+    if (!reader.isValid()) return false;
+    key.channels = reader.channels();
+    key.bitDepth = reader.bits();
+    key.sampleRate = reader.sampleRate();
+    key.frames = reader.frames();
+
+    ContentHash hash;
+    std::vector<uint8_t> buffer(BLOCK_FRAMES * reader.frameSize());
+    for (size_t n = reader.read(&buffer[0], BLOCK_FRAMES); n;
+         n = reader.read(&buffer[0], BLOCK_FRAMES))
+    {
+        hash.update(&buffer[0], n * reader.frameSize());
+    }
+    key.hash = hash.value();
+    return true;
+}
+
+/**
+ * Compares the audio format and the entire sample data of the two given
+ * samples.
+ */
+bool SampleHashIndex::sameContent(gig::Sample* a, gig::Sample* b) {
+    if (a->Channels != b->Channels || a->BitDepth != b->BitDepth ||
+        a->SamplesPerSecond != b->SamplesPerSecond ||
+        a->SamplesTotal != b->SamplesTotal || a->FrameSize != b->FrameSize)
+        return false;
+    std::vector<uint8_t> bufA, bufB;
+    try {
+        a->SetPos(0);
+        b->SetPos(0);
+        while (true) {
+            const size_t n = readSample(a, bufA, BLOCK_FRAMES);
+            if (readSample(b, bufB, BLOCK_FRAMES) != n) return false;
+            if (!n) return true;
+            if (memcmp(&bufA[0], &bufB[0], n * a->FrameSize)) return false;
+        }
+    } catch (RIFF::Exception e) {
+        return false;
+    }
+}
+
+/**
+ * Compares the audio format and the entire sample data of the given @a sample
+ * with the sample data the given audio file would have after being imported.
+ */
+bool SampleHashIndex::sameContent(gig::Sample* sample, const std::string& audioFileName) {
+    AudioFileReader reader(audioFileName);
+    if (!reader.isValid() || reader.channels() != sample->Channels ||
+        reader.bits() != sample->BitDepth ||
+        reader.sampleRate() != sample->SamplesPerSecond ||
+        reader.frames() != sample->SamplesTotal ||
+        reader.frameSize() != sample->FrameSize)
+        return false;
+    std::vector<uint8_t> bufFile(BLOCK_FRAMES * reader.frameSize()), bufSample;
+    try {
+        sample->SetPos(0);
+        while (true) {
+            const size_t n = reader.read(&bufFile[0], BLOCK_FRAMES);
+            if (readSample(sample, bufSample, n ? n : 1) != n) return false;
+            if (!n) return true;
+            if (memcmp(&bufFile[0], &bufSample[0], n * sample->FrameSize)) return false;
+        }
+    } catch (RIFF::Exception e) {
+        return false;
+    }
+}
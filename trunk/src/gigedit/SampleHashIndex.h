@@ -0,0 +1,78 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#ifndef GIGEDIT_SAMPLEHASHINDEX_H
+#define GIGEDIT_SAMPLEHASHINDEX_H
+
+#include "global.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/** @brief Index of the audio content of all samples of a .gig file.
+ *
+ * Used to find samples which are stored several times with identical sample
+ * data, i.e. after merging files or importing the same audio file again. The
+ * sample data of all samples is hashed concurrently, each worker thread
+ * hashing a different sample. Since all samples share the same file handle,
+ * only the hashing runs in parallel, reading the sample data from disk is
+ * serialized. Equal hashes are always confirmed by comparing the entire
+ * sample data, so a hash collision never causes a sample to be treated as
+ * duplicate.
+ *
+ * Hashes are kept by the index, so subsequent calls of update() only hash
+ * samples which were added since. Since hashing takes a while on large
+ * files, the GUI calls update() on a separate thread (see SampleHasher) before
+ * calling duplicates() or find(), which then do not need to hash anything
+ * anymore. Samples whose sample data is modified or
+ * which are deleted must be dropped from the index with forget().
+ */
+class SampleHashIndex {
+public:
+    /// Audio format and hash of the sample data of a sample.
+    struct Key {
+        int channels;
+        int bitDepth;
+        uint32_t sampleRate;
+        uint32_t frames;
+        uint64_t hash;
+
+        bool operator<(const Key& other) const;
+    };
+
+    /// Samples with identical sample data, the first one is the one to be kept.
+    typedef std::vector<gig::Sample*> Duplicates;
+
+    SampleHashIndex();
+    void update(gig::File* file, const std::set<gig::Sample*>& skip,
+                const sigc::slot<void,float>& progress = sigc::slot<void,float>());
+    void forget(gig::Sample* sample);
+    void clear();
+    std::vector<Duplicates> duplicates(gig::File* file, const std::set<gig::Sample*>& skip);
+    gig::Sample* find(gig::File* file, const std::string& audioFileName, const std::set<gig::Sample*>& skip);
+
+    static bool keyOfAudioFile(const std::string& audioFileName, Key& key);
+    static bool sameContent(gig::Sample* a, gig::Sample* b);
+    static bool sameContent(gig::Sample* sample, const std::string& audioFileName);
+
+private:
+    std::map<gig::Sample*,Key> keys;
+
+    // state shared with the worker threads during update()
+    Glib::Threads::Mutex mutex;
+    Glib::Threads::Mutex ioMutex; ///< Serializes reading sample data from disk.
+    std::vector<gig::Sample*> jobs;
+    size_t nextJob;
+    size_t jobsDone;
+    sigc::slot<void,float> progressSlot;
+
+    void thread_function();
+};
+
+#endif // GIGEDIT_SAMPLEHASHINDEX_H
@@ -0,0 +1,184 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#include "SampleImporter.h"
+
+#include <stdio.h>
+
+#ifdef LIBSNDFILE_HEADER_FILE
+# include LIBSNDFILE_HEADER_FILE(sndfile.h)
+#else
+# include <sndfile.h>
+#endif
+
+// amount of sample points decoded and written at once
+#define BLOCK_FRAMES 10000
+
+SampleImporter::SampleImporter() : jobs(NULL), nextJob(0) {
+}
+
+/**
+ * Returns the bit depth a sample in a .gig file requires for an audio file
+ * of the given libsndfile format, or 0 if the format is not supported.
+ */
+int SampleImporter::bitDepthOf(int sndfileFormat) {
+    switch (sndfileFormat & 0xff) {
+        case SF_FORMAT_PCM_S8:
+        case SF_FORMAT_PCM_16:
+        case SF_FORMAT_PCM_U8:
+            return 16;
+        case SF_FORMAT_PCM_24:
+        case SF_FORMAT_PCM_32:
+        case SF_FORMAT_FLOAT:
+        case SF_FORMAT_DOUBLE:
+            return 24;
+        default:
+            return 0; // unsupported subformat (yet?)
+    }
+}
+
+/**
+ * Adjusts audio format and size of the given @a sample to the audio file
+ * @a path, so that the audio file can be imported to the sample after the
+ * .gig file was saved. Returns false and sets @a error if the audio file
+ * cannot be used.
+ */
+bool SampleImporter::prepareSample(gig::Sample* sample, const std::string& path, Glib::ustring& error) {
+    SF_INFO info;
+    info.format = 0;
+    SNDFILE* hFile = sf_open(path.c_str(), SFM_READ, &info);
+    if (!hFile) {
+        error = _("could not open file");
+        return false;
+    }
+    sf_close(hFile);
+    const int bitdepth = bitDepthOf(info.format);
+    if (!bitdepth) {
+        error = _("format not supported");
+        return false;
+    }
+    sample->Channels = info.channels;
+    sample->BitDepth = bitdepth;
+    sample->FrameSize = bitdepth / 8/*1 byte are 8 bits*/ * info.channels;
+    sample->SamplesPerSecond = info.samplerate;
+    sample->AverageBytesPerSecond = sample->FrameSize * sample->SamplesPerSecond;
+    sample->BlockAlign = sample->FrameSize;
+    sample->SamplesTotal = info.frames;
+    // schedule resizing the sample (which will be done physically when
+    // File::Save() is called)
+    sample->Resize(info.frames);
+    return true;
+}
+
+/**
+ * Imports the audio files of all given @a jobs. Blocks until all of them
+ * were processed. The result of each import is stored in its job.
+ */
+void SampleImporter::run(std::vector<Job>& jobs) {
+    this->jobs = &jobs;
+    nextJob = 0;
+
+    const int nThreads = std::min<int>(jobs.size(), g_get_num_processors());
+    std::vector<Glib::Threads::Thread*> threads;
+    for (int i = 0; i < nThreads; ++i) {
+#ifdef OLD_THREADS
+        threads.push_back(Glib::Thread::create(sigc::mem_fun(*this, &SampleImporter::thread_function), true));
+#else
+        threads.push_back(Glib::Threads::Thread::create(sigc::mem_fun(*this, &SampleImporter::thread_function)));
+#endif
+    }
+    for (int i = 0; i < threads.size(); ++i)
+        threads[i]->join();
+    this->jobs = NULL;
+}
+
+#if defined(WIN32) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 2))
+// make sure stack is 16-byte aligned for SSE instructions
+__attribute__((force_align_arg_pointer))
+#endif
+void SampleImporter::thread_function() {
+    while (true) {
+        Job* job;
+        {
+            Glib::Threads::Mutex::Lock lock(mutex);
+            if (nextJob >= jobs->size()) break;
+            job = &(*jobs)[nextJob++];
+        }
+        import(*job);
+    }
+}
+
+void SampleImporter::import(Job& job) {
+    job.framesWritten = 0;
+    job.error.clear();
+    fprintf(stderr, "Importing sample %s\n", job.path.c_str());
+
+    SF_INFO info;
+    info.format = 0;
+    SNDFILE* hFile = sf_open(job.path.c_str(), SFM_READ, &info);
+    if (!hFile) {
+        job.error = _("could not open file");
+        return;
+    }
+    sf_command(hFile, SFC_SET_SCALE_FLOAT_INT_READ, 0, SF_TRUE);
+    const int bitdepth = bitDepthOf(info.format);
+    if (!bitdepth) {
+        sf_close(hFile);
+        job.error = _("format not supported");
+        return;
+    }
+
+    try {
+        {
+            // reset write position for sample
+            Glib::Threads::Mutex::Lock lock(ioMutex);
+            job.sample->SetPos(0);
+        }
+        switch (bitdepth) {
+            case 16: {
+                std::vector<short> buffer(BLOCK_FRAMES * info.channels);
+                sf_count_t cnt = info.frames;
+                while (cnt) {
+                    // libsndfile does the conversion for us (if needed)
+                    int n = sf_readf_short(hFile, &buffer[0], BLOCK_FRAMES);
+                    if (n <= 0) break;
+                    // write from buffer directly (physically) into .gig file
+                    Glib::Threads::Mutex::Lock lock(ioMutex);
+                    job.sample->Write(&buffer[0], n);
+                    job.framesWritten += n;
+                    cnt -= n;
+                }
+                break;
+            }
+            case 24: {
+                std::vector<int> srcbuf(BLOCK_FRAMES * info.channels);
+                std::vector<uint8_t> dstbuf(BLOCK_FRAMES * 3 * info.channels);
+                sf_count_t cnt = info.frames;
+                while (cnt) {
+                    // libsndfile returns 32 bits, convert to 24
+                    int n = sf_readf_int(hFile, &srcbuf[0], BLOCK_FRAMES);
+                    if (n <= 0) break;
+                    int j = 0;
+                    for (int i = 0 ; i < n * info.channels ; i++) {
+                        dstbuf[j++] = srcbuf[i] >> 8;
+                        dstbuf[j++] = srcbuf[i] >> 16;
+                        dstbuf[j++] = srcbuf[i] >> 24;
+                    }
+                    // write from buffer directly (physically) into .gig file
+                    Glib::Threads::Mutex::Lock lock(ioMutex);
+                    job.sample->Write(&dstbuf[0], n);
+                    job.framesWritten += n;
+                    cnt -= n;
+                }
+                break;
+            }
+        }
+    } catch (RIFF::Exception e) {
+        job.error = e.Message;
+    }
+    sf_close(hFile);
+}
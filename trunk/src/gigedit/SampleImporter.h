@@ -0,0 +1,53 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#ifndef GIGEDIT_SAMPLEIMPORTER_H
+#define GIGEDIT_SAMPLEIMPORTER_H
+
+#include "global.h"
+
+#include <string>
+#include <vector>
+
+/** @brief Imports the sample data of audio files into samples of a .gig file.
+ *
+ * Several audio files are imported concurrently, each worker thread decoding
+ * and converting a different audio file. Since all samples share the same
+ * file handle, only decoding runs in parallel, the converted sample data is
+ * written to the .gig file one block at a time.
+ *
+ * The samples must already have the audio format and size of their audio
+ * file (see prepareSample()), and the .gig file must have been saved since,
+ * so the samples' data chunks have their final size on disk.
+ */
+class SampleImporter {
+public:
+    /// Import of one audio file.
+    struct Job {
+        gig::Sample* sample; ///< Sample the audio file's data is imported to.
+        std::string path; ///< Audio file to be imported.
+        unsigned long framesWritten; ///< Output: amount of sample points written.
+        Glib::ustring error; ///< Output: reason of failure, empty on success.
+    };
+
+    SampleImporter();
+    void run(std::vector<Job>& jobs);
+
+    static int bitDepthOf(int sndfileFormat);
+    static bool prepareSample(gig::Sample* sample, const std::string& path, Glib::ustring& error);
+
+private:
+    std::vector<Job>* jobs;
+    size_t nextJob;
+    Glib::Threads::Mutex mutex;
+    Glib::Threads::Mutex ioMutex; ///< Serializes writing sample data to disk.
+
+    void thread_function();
+    void import(Job& job);
+};
+
+#endif // GIGEDIT_SAMPLEIMPORTER_H
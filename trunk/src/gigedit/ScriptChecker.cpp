@@ -0,0 +1,174 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+    
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#include "ScriptChecker.h"
+
+#if USE_LS_SCRIPTVM
+
+#include "global.h"
+#include <glibmm/checksum.h>
+#include <set>
+
+ScriptChecker::ScriptChecker() : nextJob(0) {
+}
+
+/**
+ * Parses all scripts of all script groups of the given .gig @a file and
+ * returns the parser issues of each script, in the order of the scripts in
+ * the file. Blocks until all scripts were checked.
+ */
+std::vector<ScriptChecker::Result> ScriptChecker::check(gig::File* file) {
+    std::vector<Result> results;
+    std::vector<std::string> checksums;
+    std::map<gig::Script*,size_t> index;
+    std::set<std::string> queued;
+
+    jobs.clear();
+    nextJob = 0;
+
+    for (int g = 0; file->GetScriptGroup(g); ++g) {
+        gig::ScriptGroup* group = file->GetScriptGroup(g);
+        for (int s = 0; group->GetScript(s); ++s) {
+            gig::Script* script = group->GetScript(s);
+            Result result;
+            result.script = script;
+            result.group = gig_to_utf8(group->Name);
+            result.name = gig_to_utf8(script->Name);
+            index[script] = results.size();
+            results.push_back(result);
+
+            const std::string code = script->GetScriptAsText();
+            const std::string checksum =
+                Glib::Checksum::compute_checksum(Glib::Checksum::CHECKSUM_SHA1, code);
+            checksums.push_back(checksum);
+            if (!cache.count(checksum) && queued.insert(checksum).second)
+                jobs.push_back(std::make_pair(checksum, code));
+        }
+    }
+
+    for (int i = 0; file->GetInstrument(i); ++i) {
+        gig::Instrument* instr = file->GetInstrument(i);
+        for (int slot = 0; slot < instr->ScriptSlotCount(); ++slot) {
+            gig::Script* script = instr->GetScriptOfSlot(slot);
+            if (!script || !index.count(script)) continue;
+            results[index[script]].usage.push_back(
+                gig_to_utf8(instr->pInfo->Name) + " (" + _("slot") + " " +
+                ToString(slot + 1) + ")"
+            );
+        }
+    }
+
+    // parse all scripts not cached yet, each thread with its own script VM
+    const int nThreads = std::min<int>(jobs.size(), g_get_num_processors());
+    std::vector<Glib::Threads::Thread*> threads;
+    for (int i = 0; i < nThreads; ++i) {
+#ifdef OLD_THREADS
+        threads.push_back(Glib::Thread::create(sigc::mem_fun(*this, &ScriptChecker::thread_function), true));
+#else
+        threads.push_back(Glib::Threads::Thread::create(sigc::mem_fun(*this, &ScriptChecker::thread_function)));
+#endif
+    }
+    for (int i = 0; i < threads.size(); ++i)
+        threads[i]->join();
+    jobs.clear();
+
+    for (int i = 0; i < results.size(); ++i) {
+        const Issues& issues = cache[checksums[i]];
+        results[i].errors = issues.errors;
+        results[i].warnings = issues.warnings;
+    }
+
+    // only keep the results of the scripts just checked, so the cache does
+    // not grow with each script edit over the entire session
+    const std::set<std::string> current(checksums.begin(), checksums.end());
+    for (std::map<std::string,Issues>::iterator it = cache.begin(); it != cache.end(); ) {
+        if (current.count(it->first)) ++it;
+        else cache.erase(it++);
+    }
+    return results;
+}
+
+#if defined(WIN32) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 2))
+// make sure stack is 16-byte aligned for SSE instructions
+__attribute__((force_align_arg_pointer))
+#endif
+void ScriptChecker::thread_function() {
+    LinuxSampler::ScriptVM* vm = LinuxSampler::ScriptVMFactory::Create("gig");
+    while (true) {
+        size_t job;
+        {
+            Glib::Threads::Mutex::Lock lock(mutex);
+            if (nextJob >= jobs.size()) break;
+            job = nextJob++;
+        }
+
+        Issues issues;
+        LinuxSampler::VMParserContext* parserContext = vm->loadScript(jobs[job].second);
+        issues.errors = parserContext->errors();
+        issues.warnings = parserContext->warnings();
+        delete parserContext;
+
+        Glib::Threads::Mutex::Lock lock(mutex);
+        cache[jobs[job].first] = issues;
+    }
+    delete vm;
+}
+
+int ScriptChecker::errorCount(const std::vector<Result>& results) {
+    int n = 0;
+    for (int i = 0; i < results.size(); ++i)
+        n += results[i].errors.size();
+    return n;
+}
+
+int ScriptChecker::warningCount(const std::vector<Result>& results) {
+    int n = 0;
+    for (int i = 0; i < results.size(); ++i)
+        n += results[i].warnings.size();
+    return n;
+}
+
+static Glib::ustring issueLine(const char* type, const LinuxSampler::ParserIssue& issue) {
+    return Glib::ustring("    ") + type + " (" + _("line") + " " +
+           ToString(issue.firstLine) + ", " + _("column") + " " +
+           ToString(issue.firstColumn) + "): " + issue.txt + "\n";
+}
+
+/**
+ * Returns a plain text report of the given check @a results, listing for
+ * each script with issues all errors and warnings and the instruments
+ * using that script.
+ */
+Glib::ustring ScriptChecker::report(const std::vector<Result>& results) {
+    Glib::ustring txt = ToString(results.size()) + " " + _("scripts checked") +
+        ": " + ToString(errorCount(results)) + " " + _("errors") + ", " +
+        ToString(warningCount(results)) + " " + _("warnings") + "\n";
+
+    for (int i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        if (r.errors.empty() && r.warnings.empty()) continue;
+
+        txt += "\n\"" + r.group + "\" / \"" + r.name + "\": " +
+               ToString(r.errors.size()) + " " + _("errors") + ", " +
+               ToString(r.warnings.size()) + " " + _("warnings") + "\n";
+        if (r.usage.empty()) {
+            txt += Glib::ustring("    ") + _("Not used by any instrument.") + "\n";
+        } else {
+            txt += Glib::ustring("    ") + _("Used by") + ": ";
+            for (int u = 0; u < r.usage.size(); ++u)
+                txt += (u ? ", " : "") + r.usage[u];
+            txt += "\n";
+        }
+        for (int e = 0; e < r.errors.size(); ++e)
+            txt += issueLine(_("ERROR"), r.errors[e]);
+        for (int w = 0; w < r.warnings.size(); ++w)
+            txt += issueLine(_("Warning"), r.warnings[w]);
+    }
+    return txt;
+}
+
+#endif // USE_LS_SCRIPTVM
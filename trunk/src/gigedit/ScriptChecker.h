@@ -0,0 +1,66 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+    
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#ifndef GIGEDIT_SCRIPTCHECKER_H
+#define GIGEDIT_SCRIPTCHECKER_H
+
+#include "scripteditor.h" // for USE_LS_SCRIPTVM and the script VM headers
+
+#if USE_LS_SCRIPTVM
+
+#include <map>
+#include <string>
+#include <vector>
+
+/** @brief Compile check of all instrument scripts of a .gig file.
+ *
+ * Parses all scripts of a .gig file concurrently, each worker thread using
+ * its own script VM instance. Parser results are cached by a checksum of the
+ * script's source code, so scripts with identical source code are parsed
+ * only once, and scripts which were not modified are not parsed again by
+ * subsequent checks with the same ScriptChecker instance. Only the results of
+ * the scripts of the most recent check are kept, so the cache is bounded by
+ * the amount of scripts of the checked file.
+ */
+class ScriptChecker {
+public:
+    /// Parser issues of one script.
+    struct Result {
+        gig::Script* script;
+        Glib::ustring group; ///< Name of the script group the script belongs to.
+        Glib::ustring name; ///< Name of the script.
+        std::vector<Glib::ustring> usage; ///< Instruments (and their script slot) using this script.
+        std::vector<LinuxSampler::ParserIssue> errors;
+        std::vector<LinuxSampler::ParserIssue> warnings;
+    };
+
+    ScriptChecker();
+    std::vector<Result> check(gig::File* file);
+
+    static Glib::ustring report(const std::vector<Result>& results);
+    static int errorCount(const std::vector<Result>& results);
+    static int warningCount(const std::vector<Result>& results);
+
+private:
+    struct Issues {
+        std::vector<LinuxSampler::ParserIssue> errors;
+        std::vector<LinuxSampler::ParserIssue> warnings;
+    };
+
+    std::map<std::string,Issues> cache; ///< Key: SHA-1 checksum of the script's source code.
+
+    // state shared with the worker threads during check()
+    Glib::Threads::Mutex mutex;
+    std::vector<std::pair<std::string,std::string> > jobs; ///< Checksum and source code of scripts to be parsed.
+    size_t nextJob;
+
+    void thread_function();
+};
+
+#endif // USE_LS_SCRIPTVM
+
+#endif // GIGEDIT_SCRIPTCHECKER_H
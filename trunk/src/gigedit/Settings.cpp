@@ -13,16 +13,14 @@
 # include <glib.h>
 #endif
 #include <glibmm/keyfile.h>
+#include <glibmm/main.h>
 #include <iostream>
 #include <stdio.h>
 #include <fstream>
 #include <string.h>
 
-#if (GTKMM_MAJOR_VERSION == 2 && GTKMM_MINOR_VERSION < 40) || GTKMM_MAJOR_VERSION < 2
-# define HAS_GLIB_KEYFILE_SAVE_TO_FILE 0
-#else
-# define HAS_GLIB_KEYFILE_SAVE_TO_FILE 1
-#endif
+/// Delay (in ms) after the last settings change before the config file is written.
+#define SAVE_DELAY_MS 500
 
 static std::string configDir() {
     //printf("configDir '%s'\n", g_get_user_config_dir());
@@ -38,6 +36,23 @@ static std::string configFile() {
     return configDir() + dirSep() + "gigedit.conf";
 }
 
+static std::string macrosFile() {
+    return configDir() + dirSep() + "gigedit.macros";
+}
+
+// Replaces the content of the given file atomically (by writing a temporary
+// file first and renaming it over the original file).
+static bool writeFile(const std::string& filename, const char* data, size_t size) {
+    GError* error = NULL;
+    if (!g_file_set_contents(filename.c_str(), data, size, &error)) {
+        std::cerr << "Failed saving '" << filename << "': "
+                  << (error ? error->message : "") << "\n" << std::flush;
+        if (error) g_error_free(error);
+        return false;
+    }
+    return true;
+}
+
 static std::string groupName(Settings::Group_t group) {
     switch (group) {
         case Settings::GLOBAL: return "Global";
@@ -57,19 +72,6 @@ static std::string groupName(Settings::Group_t group) {
     return "Global";
 }
 
-#if !HAS_GLIB_KEYFILE_SAVE_TO_FILE
-
-static bool saveToFile(Glib::KeyFile* keyfile, std::string filename) {
-    Glib::ustring s = keyfile->to_data();
-    std::ofstream out;
-    out.open(filename.c_str(), std::ios_base::out | std::ios_base::trunc);
-    out << s;
-    out.close();
-    return true;
-}
-
-#endif // ! HAS_GLIB_KEYFILE_SAVE_TO_FILE
-
 static Settings* _instance = NULL;
     
 Settings* Settings::singleton() {
@@ -87,6 +89,8 @@ Settings::Settings() : Glib::ObjectBase(typeid(Settings)),
     autoRestoreWindowDimension(*this, GLOBAL, "autoRestoreWindowDimension", false),
     saveWithTemporaryFile(*this, GLOBAL, "saveWithTemporaryFile", false),
     showTooltips(*this, GLOBAL, "showNewbieTooltips", true),
+    commitLiveEditsInstantly(*this, GLOBAL, "commitLiveEditsInstantly", false),
+    keepPluginWindow(*this, GLOBAL, "keepPluginWindow", true),
     mainWindowX(*this, MAIN_WINDOW, "x", -1),
     mainWindowY(*this, MAIN_WINDOW, "y", -1),
     mainWindowW(*this, MAIN_WINDOW, "w", -1),
@@ -132,7 +136,8 @@ Settings::Settings() : Glib::ObjectBase(typeid(Settings)),
     macrosSetupWindowY(*this, MACROS_SETUP, "y", -1),
     macrosSetupWindowW(*this, MACROS_SETUP, "w", -1),
     macrosSetupWindowH(*this, MACROS_SETUP, "h", -1),
-    m_ignoreNotifies(false)
+    m_ignoreNotifies(false),
+    m_saveThread(NULL), m_dropLegacyMacros(false)
 {
     m_boolProps.push_back(&warnUserOnExtensions);
     m_boolProps.push_back(&syncSamplerInstrumentSelection);
@@ -140,6 +145,8 @@ Settings::Settings() : Glib::ObjectBase(typeid(Settings)),
     m_boolProps.push_back(&autoRestoreWindowDimension);
     m_boolProps.push_back(&saveWithTemporaryFile);
     m_boolProps.push_back(&showTooltips);
+    m_boolProps.push_back(&commitLiveEditsInstantly);
+    m_boolProps.push_back(&keepPluginWindow);
     m_intProps.push_back(&mainWindowX);
     m_intProps.push_back(&mainWindowY);
     m_intProps.push_back(&mainWindowW);
@@ -192,16 +199,17 @@ void Settings::onPropertyChanged(Glib::PropertyBase* pProperty, RawValueType_t t
 
     //printf("Settings::onPropertyChanged(%s)\n", pProperty->get_name().c_str());
 
-    Glib::KeyFile file;
-    try {
-        bool ok = file.load_from_file(configFile());
-        if (!ok) {
-            std::cerr << "Could not load '" << configFile() << "'\n" << std::flush;
-        }
-    } catch (...) {
-        std::cerr << "Could not load '" << configFile() << "'\n" << std::flush;
+    if (type == UNKNOWN) {
+        std::cerr << "BUG: Unknown setting raw type of property '" << pProperty->get_name() << "'\n" << std::flush;
+        return;
     }
+    storeProperty(m_file, pProperty, type);
+    m_changedProps[pProperty] = type;
+
+    scheduleSave();
+}
 
+void Settings::storeProperty(Glib::KeyFile& file, Glib::PropertyBase* pProperty, RawValueType_t type) {
     switch (type) {
         case BOOLEAN: {
             Property<bool>* prop = static_cast<Property<bool>*>(pProperty);
@@ -216,28 +224,88 @@ void Settings::onPropertyChanged(Glib::PropertyBase* pProperty, RawValueType_t t
             break;
         }
         case UNKNOWN:
-            std::cerr << "BUG: Unknown setting raw type of property '" << pProperty->get_name() << "'\n" << std::flush;
-            return;
+            break;
     }
+}
+
+/**
+ * (Re)starts the timeout after which the config file will be written, so
+ * that a burst of changes only causes one single write.
+ */
+void Settings::scheduleSave() {
+    m_saveTimeout.disconnect();
+    m_saveTimeout = Glib::signal_timeout().connect(
+        sigc::mem_fun(*this, &Settings::onSaveTimeout), SAVE_DELAY_MS
+    );
+}
+
+bool Settings::onSaveTimeout() {
+    save();
+    return false; // one-shot
+}
 
+/**
+ * Writes the settings changed since the last write to the config file on a
+ * separate thread. The config file is read again before, so settings changed
+ * by other gigedit instances meanwhile are preserved, only the settings
+ * changed by this instance are replaced.
+ */
+void Settings::save() {
+    // wait for the previous write, if it is (unlikely) still running
+    if (m_saveThread) {
+        m_saveThread->join();
+        m_saveThread = NULL;
+    }
+    Glib::KeyFile file;
     try {
-#if HAS_GLIB_KEYFILE_SAVE_TO_FILE
-        bool ok = file.save_to_file(configFile());
+        file.load_from_file(configFile());
+    } catch (...) {
+        // no config file yet, so there is nothing to be preserved
+    }
+    for (std::map<Glib::PropertyBase*,RawValueType_t>::const_iterator it = m_changedProps.begin();
+         it != m_changedProps.end(); ++it)
+    {
+        storeProperty(file, it->first, it->second);
+    }
+    m_changedProps.clear();
+    const std::string group = groupName(MACROS);
+    if (m_dropLegacyMacros && file.has_group(group))
+        file.remove_group(group);
+    m_dropLegacyMacros = false;
+    m_saveData = file.to_data();
+#ifdef OLD_THREADS
+    m_saveThread = Glib::Thread::create(sigc::mem_fun(*this, &Settings::saveThreadFunction), true);
 #else
-        bool ok = saveToFile(&file, configFile());
+    m_saveThread = Glib::Threads::Thread::create(sigc::mem_fun(*this, &Settings::saveThreadFunction));
 #endif
-        if (!ok) {
-            std::cerr << "Failed saving gigedit config to '" << configFile() << "'\n" << std::flush;
-        } else {
-            //std::cout <<"gigedit CONFIG SAVED\n";
-        }
-    } catch (...) {
-        std::cerr << "Failed saving gigedit config to '" << configFile() << "'\n" << std::flush;
+}
+
+#if defined(WIN32) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 2))
+// make sure stack is 16-byte aligned for SSE instructions
+__attribute__((force_align_arg_pointer))
+#endif
+void Settings::saveThreadFunction() {
+    writeFile(configFile(), m_saveData.c_str(), m_saveData.size());
+}
+
+/**
+ * Writes pending settings changes to the config file immediately and waits
+ * until they were written. Should be called before the application (or
+ * the plugin's editor session) ends.
+ */
+void Settings::flush() {
+    if (m_saveTimeout.connected()) {
+        m_saveTimeout.disconnect();
+        save();
+    }
+    if (m_saveThread) {
+        m_saveThread->join();
+        m_saveThread = NULL;
     }
 }
 
 void Settings::load() {
-    Glib::KeyFile file;
+    Glib::KeyFile& file = m_file;
     try {
         bool ok = file.load_from_file(configFile());
         if (!ok) return;
@@ -280,21 +348,173 @@ void Settings::load() {
 
 #define MACRO_LIST_NAME "srlzl"
 
+// binary macros file: magic, version, amount of macros, then an index with
+// name, comment, creation and modification time, data offset (relative to
+// the end of the index), data size and data checksum of each macro, followed
+// by the raw Serialization::Archive data of all macros (all integers little
+// endian, strings prefixed by their size)
+#define MACROS_FILE_MAGIC "GMAC"
+#define MACROS_FILE_VERSION 1
+
+// 32 bit FNV-1a hash of a macro's raw data
+static uint32_t macroChecksum(const char* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= uint8_t(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void putUInt32(std::string& s, uint32_t value) {
+    for (int i = 0; i < 4; ++i)
+        s += char((value >> (8 * i)) & 0xff);
+}
+
+static void putInt64(std::string& s, int64_t value) {
+    putUInt32(s, uint64_t(value) & 0xffffffff);
+    putUInt32(s, uint64_t(value) >> 32);
+}
+
+static void putString(std::string& s, const std::string& value) {
+    putUInt32(s, value.size());
+    s += value;
+}
+
+static bool readUInt32(std::istream& in, uint32_t& value) {
+    char buf[4];
+    if (!in.read(buf, 4)) return false;
+    value = 0;
+    for (int i = 0; i < 4; ++i)
+        value |= uint32_t(uint8_t(buf[i])) << (8 * i);
+    return true;
+}
+
+static bool readInt64(std::istream& in, int64_t& value) {
+    uint32_t lo, hi;
+    if (!readUInt32(in, lo) || !readUInt32(in, hi)) return false;
+    value = int64_t(uint64_t(lo) | (uint64_t(hi) << 32));
+    return true;
+}
+
+static bool readString(std::istream& in, std::string& value) {
+    uint32_t n;
+    if (!readUInt32(in, n)) return false;
+    value.resize(n);
+    if (n && !in.read(&value[0], n)) return false;
+    return true;
+}
+
+// Only reads the index of the macros file, not the macros themselves.
+static bool readMacroIndex(std::vector<Settings::MacroInfo>& index) {
+    index.clear();
+    std::ifstream in(macrosFile().c_str(), std::ios_base::in | std::ios_base::binary);
+    if (!in) return false;
+    char magic[4];
+    uint32_t version, count;
+    if (!in.read(magic, 4) || memcmp(magic, MACROS_FILE_MAGIC, 4) ||
+        !readUInt32(in, version) || version != MACROS_FILE_VERSION ||
+        !readUInt32(in, count)) return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        Settings::MacroInfo info;
+        int64_t created, modified;
+        uint32_t offset, size;
+        if (!readString(in, info.name) || !readString(in, info.comment) ||
+            !readInt64(in, created) || !readInt64(in, modified) ||
+            !readUInt32(in, offset) || !readUInt32(in, size) ||
+            !readUInt32(in, info.checksum))
+        {
+            index.clear();
+            return false;
+        }
+        info.created = created;
+        info.modified = modified;
+        info.offset = offset;
+        info.size = size;
+        index.push_back(info);
+    }
+    // data offsets are relative to the end of the index
+    const size_t dataBegin = in.tellg();
+    for (int i = 0; i < index.size(); ++i)
+        index[i].offset += dataBegin;
+    return true;
+}
+
+/**
+ * Loads the index of all macros stored by the user. This is fast, since the
+ * macros themselves are not decoded; use loadMacro() to decode an individual
+ * macro when it is actually needed.
+ */
+void Settings::loadMacroIndex(std::vector<MacroInfo>& index) {
+    if (readMacroIndex(index)) return;
+
+    // no macros file yet, so convert the macros stored in the config file by
+    // older versions of gigedit (if any)
+    std::vector<Serialization::Archive> macros;
+    loadLegacyMacros(macros);
+    if (macros.empty()) return;
+    saveMacros(macros);
+    readMacroIndex(index);
+}
+
+// Reads the raw data of the macro described by @a info from the macros file,
+// returns false if that data does not match the macro's checksum (anymore).
+static bool readMacroData(const Settings::MacroInfo& info, std::vector<char>& data) {
+    std::ifstream in(macrosFile().c_str(), std::ios_base::in | std::ios_base::binary);
+    data.resize(info.size);
+    if (!in || !in.seekg(info.offset) || (info.size && !in.read(&data[0], info.size)))
+        return false;
+    return macroChecksum(data.empty() ? NULL : &data[0], data.size()) == info.checksum;
+}
+
+/**
+ * Decodes the macro described by @a info from the macros file. If the macros
+ * file was rewritten since @a info was loaded (i.e. by another gigedit
+ * instance), the index is reloaded and @a info updated accordingly.
+ *
+ * @throws Serialization::Exception if the macro could not be read or decoded
+ */
+void Settings::loadMacro(MacroInfo& info, Serialization::Archive& macro) {
+    std::vector<char> data;
+    if (!readMacroData(info, data)) {
+        std::vector<MacroInfo> index;
+        readMacroIndex(index);
+        bool found = false;
+        for (int i = 0; i < index.size() && !found; ++i) {
+            if (index[i].name == info.name && index[i].created == info.created) {
+                info = index[i];
+                found = true;
+            }
+        }
+        if (!found || !readMacroData(info, data))
+            throw Serialization::Exception("Could not read macro from macros file");
+    }
+    macro.decode((const uint8_t*)(data.empty() ? NULL : &data[0]), data.size());
+}
+
+/**
+ * Loads and decodes all macros stored by the user.
+ */
 void Settings::loadMacros(std::vector<Serialization::Archive>& macros) {
-    const std::string group = groupName(MACROS);
     macros.clear();
-    Glib::KeyFile file;
-    try {
-        bool ok = file.load_from_file(configFile());
-        if (!ok) return;
-    } catch (...) {
-        std::cerr << "Could not load gigedit config file '" << configFile() << "'\n" << std::flush;
-        return;
+    std::vector<MacroInfo> index;
+    loadMacroIndex(index);
+    for (int i = 0; i < index.size(); ++i) {
+        Serialization::Archive macro;
+        loadMacro(index[i], macro);
+        macros.push_back(macro);
     }
-    if (!file.has_group(group)) return;
-    if (!file.has_key(group, MACRO_LIST_NAME))
+}
+
+// Loads macros stored in the config file by older versions of gigedit.
+void Settings::loadLegacyMacros(std::vector<Serialization::Archive>& macros) {
+    macros.clear();
+
+    const std::string group = groupName(MACROS);
+    if (!m_file.has_group(group)) return;
+    if (!m_file.has_key(group, MACRO_LIST_NAME))
         return;
-    std::vector<Glib::ustring> v = file.get_string_list(group, MACRO_LIST_NAME);
+    std::vector<Glib::ustring> v = m_file.get_string_list(group, MACRO_LIST_NAME);
     for (int i = 0; i < v.size(); ++i) {
         Serialization::Archive macro;
         macro.decode((const uint8_t*)v[i].c_str(), v[i].length());
@@ -303,40 +523,35 @@ void Settings::loadMacros(std::vector<Serialization::Archive>& macros) {
 }
 
 void Settings::saveMacros(const std::vector<Serialization::Archive>& macros) {
-    const std::string group = groupName(MACROS);
-    Glib::KeyFile file;
-    try {
-        bool ok = file.load_from_file(configFile());
-        if (!ok) {
-            std::cerr << "Could not load '" << configFile() << "'\n" << std::flush;
-        }
-    } catch (...) {
-        std::cerr << "Could not load '" << configFile() << "'\n" << std::flush;
-        return;
-    }
-
-    std::vector<Glib::ustring> v;
+    std::string index;
+    std::string data;
     for (int i = 0; i < macros.size(); ++i) {
-        const Serialization::RawData& rawData = const_cast<Serialization::Archive&>(macros[i]).rawData();
-        std::string s((const char*)&rawData[0], rawData.size());
-        v.push_back(s);
+        Serialization::Archive& macro = const_cast<Serialization::Archive&>(macros[i]);
+        const Serialization::RawData& rawData = macro.rawData();
+        putString(index, macro.name());
+        putString(index, macro.comment());
+        putInt64(index, macro.timeStampCreated());
+        putInt64(index, macro.timeStampModified());
+        putUInt32(index, data.size());
+        putUInt32(index, rawData.size());
+        putUInt32(index, rawData.empty() ? macroChecksum(NULL, 0) :
+                         macroChecksum((const char*)&rawData[0], rawData.size()));
+        if (!rawData.empty())
+            data.append((const char*)&rawData[0], rawData.size());
     }
 
-    file.set_string_list(group, MACRO_LIST_NAME, v);
+    std::string s = MACROS_FILE_MAGIC;
+    putUInt32(s, MACROS_FILE_VERSION);
+    putUInt32(s, macros.size());
+    s += index;
+    s += data;
+    if (!writeFile(macrosFile(), s.data(), s.size())) return;
 
-    try {
-#if HAS_GLIB_KEYFILE_SAVE_TO_FILE
-        bool ok = file.save_to_file(configFile());
-#else
-        bool ok = saveToFile(&file, configFile());
-#endif
-        if (!ok) {
-            std::cerr << "Failed saving gigedit config to '" << configFile() << "'\n" << std::flush;
-        } else {
-            //std::cout <<"gigedit CONFIG SAVED\n";
-        }
-    } catch (...) {
-        std::cerr << "Failed saving gigedit config to '" << configFile() << "'\n" << std::flush;
+    // drop macros stored in the config file by older versions of gigedit
+    const std::string group = groupName(MACROS);
+    if (m_file.has_group(group)) {
+        m_file.remove_group(group);
+        m_dropLegacyMacros = true;
+        scheduleSave();
     }
-
 }
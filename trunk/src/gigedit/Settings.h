@@ -11,7 +11,9 @@
 #include <typeinfo>
 #include <glibmm/object.h>
 #include <glibmm/property.h>
+#include <glibmm/keyfile.h>
 #include <vector>
+#include <ctime>
 #include "global.h"
 
 /**
@@ -20,7 +22,9 @@
  * This class holds a bunch of custom Property objects which can be accessed
  * as if they were basic data types (i.e. by using assignment operator, etc.).
  * As soon as a property gets modified this way, it will automatically be saved
- * to a local config file.
+ * to a local config file. Saving is delayed for a short time and done on a
+ * separate thread, so that many changes in a row (i.e. while the user is
+ * resizing a window) only cause one single write of the config file.
  */
 class Settings : public Glib::Object {
 public:
@@ -128,6 +132,8 @@ public:
     Property<bool> autoRestoreWindowDimension;
     Property<bool> saveWithTemporaryFile; ///< If enabled and the user selects "Save" from the main menu, then the file is first saved as separate temporary file and after the save operation completed the temporary file is moved over the original file.
     Property<bool> showTooltips; ///< Whether tooltips specifically intended for newbies should be displayed throughout the application (default: yes).
+    Property<bool> commitLiveEditsInstantly; ///< If enabled, changes to dimension regions in live-mode suspend the affected region in the sampler only while each single change is applied, instead of keeping it suspended until gigedit becomes idle (default: no).
+    Property<bool> keepPluginWindow; ///< If enabled, closing the editor in live-mode only hides its window, which is then reused next time the sampler requests to edit an instrument (default: yes).
 
     // settings of "MainWindow" group
     Property<int> mainWindowX;
@@ -196,11 +202,28 @@ public:
     Property<int> macrosSetupWindowW;
     Property<int> macrosSetupWindowH;
 
+    /**
+     * Meta information of a macro stored by the user, which is available
+     * without having to decode the macro (see loadMacroIndex()).
+     */
+    struct MacroInfo {
+        std::string name;
+        std::string comment;
+        time_t created;
+        time_t modified;
+        size_t offset; ///< Position of the macro's data in the macros file.
+        size_t size; ///< Size of the macro's data in bytes.
+        uint32_t checksum; ///< Checksum of the macro's data, to detect that the macros file was rewritten since the index was loaded.
+    };
+
     static Settings* singleton();
     Settings();
     void load();
+    void loadMacroIndex(std::vector<MacroInfo>& index);
+    void loadMacro(MacroInfo& info, Serialization::Archive& macro);
     void loadMacros(std::vector<Serialization::Archive>& macros);
     void saveMacros(const std::vector<Serialization::Archive>& macros);
+    void flush();
 
 protected:
     void onPropertyChanged(Glib::PropertyBase* pProperty, RawValueType_t type, Group_t group);
@@ -209,6 +232,19 @@ private:
     std::vector<Glib::PropertyBase*> m_boolProps; ///< Pointers to all 'bool' type properties this Setting class manages.
     std::vector<Glib::PropertyBase*> m_intProps; ///< Pointers to all 'int' type properties this Setting class manages.
     bool m_ignoreNotifies;
+    Glib::KeyFile m_file; ///< Current content of the config file, kept in memory.
+    std::map<Glib::PropertyBase*,RawValueType_t> m_changedProps; ///< Properties changed since the config file was written the last time.
+    bool m_dropLegacyMacros; ///< Whether the macros group has to be removed from the config file on next write.
+    sigc::connection m_saveTimeout;
+    Glib::Threads::Thread* m_saveThread;
+    std::string m_saveData; ///< Config file content currently written by m_saveThread.
+
+    void loadLegacyMacros(std::vector<Serialization::Archive>& macros);
+    static void storeProperty(Glib::KeyFile& file, Glib::PropertyBase* pProperty, RawValueType_t type);
+    void scheduleSave();
+    bool onSaveTimeout();
+    void save();
+    void saveThreadFunction();
 };
 
 #endif // GIGEDIT_SETTINGS
@@ -0,0 +1,178 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#include "SyntheticGig.h"
+
+#include <math.h>
+
+namespace {
+
+    // deterministic, so each run creates exactly the same content
+    class Random {
+    public:
+        Random(uint32_t seed) : state(seed) {}
+        uint32_t next() {
+            state = state * 1664525 + 1013904223;
+            return state;
+        }
+        int next(int range) {
+            return (next() >> 8) % range;
+        }
+    private:
+        uint32_t state;
+    };
+
+    // the dimensions added to each region, in this order
+    const gig::dimension_t dimensionTypes[] = {
+        gig::dimension_velocity,
+        gig::dimension_modwheel,
+        gig::dimension_roundrobin,
+        gig::dimension_random,
+        gig::dimension_sustainpedal,
+        gig::dimension_breath,
+        gig::dimension_foot,
+        gig::dimension_layer
+    };
+
+    // decaying sine with a bit of noise
+    void generateSampleData(std::vector<int16_t>& buf, Random& rnd) {
+        const double freq = 50.0 + rnd.next(2000);
+        const double decay = 1.0 / (buf.size() + 1);
+        for (int i = 0; i < buf.size(); ++i) {
+            const double amp = 20000.0 * (1.0 - i * decay);
+            const double noise = rnd.next(512) - 256;
+            buf[i] = int16_t(amp * sin(2.0 * M_PI * freq * i / 44100.0) + noise);
+        }
+    }
+
+} // namespace
+
+/// Default parameters are those of preset "small".
+SyntheticGig::Params::Params() :
+    instruments(16), regions(128), dimensions(2), samples(512),
+    sampleFrames(4410), scripts(4), seed(1)
+{
+}
+
+/**
+ * Sets @a params to the standard input size @a name ("small", "medium" or
+ * "large"). Returns false if there is no such preset.
+ */
+bool SyntheticGig::preset(const std::string& name, Params& params) {
+    params = Params();
+    if (name == "small") return true;
+    if (name == "medium") {
+        params.instruments = 256;
+        params.regions = 32;
+        params.dimensions = 4;
+        params.samples = 8192;
+        params.sampleFrames = 2205;
+        params.scripts = 32;
+        return true;
+    }
+    if (name == "large") {
+        params.instruments = 2048;
+        params.regions = 16;
+        params.dimensions = 4;
+        params.samples = 32768;
+        params.sampleFrames = 1024;
+        params.scripts = 128;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Creates a new .gig file at @a path with the given size @a params.
+ *
+ * @throw RIFF::Exception on errors
+ */
+void SyntheticGig::create(const std::string& path, const Params& params) {
+    if (params.samples < 1 || params.sampleFrames < 1)
+        throw RIFF::Exception("at least one sample point is required");
+    const int nRegions = std::min(std::max(params.regions, 1), 128);
+    const int nDimensions = std::min(std::max(params.dimensions, 0), 8);
+
+    Random rnd(params.seed);
+    gig::File gig;
+    gig.pInfo->Name = "Synthetic";
+
+    std::vector<gig::Sample*> samples;
+    for (int i = 0; i < params.samples; ++i) {
+        gig::Sample* s = gig.AddSample();
+        s->pInfo->Name = "Sample " + ToString(i);
+        s->Channels = 1;
+        s->BitDepth = 16;
+        s->FrameSize = 2;
+        s->SamplesPerSecond = 44100;
+        s->AverageBytesPerSecond = s->FrameSize * s->SamplesPerSecond;
+        s->BlockAlign = s->FrameSize;
+        s->SamplesTotal = params.sampleFrames;
+        s->MIDIUnityNote = rnd.next(128);
+        s->Resize(params.sampleFrames);
+        samples.push_back(s);
+    }
+
+    std::vector<gig::Script*> scripts;
+    if (params.scripts > 0) {
+        gig::ScriptGroup* group = gig.AddScriptGroup();
+        group->Name = "Synthetic";
+        for (int i = 0; i < params.scripts; ++i) {
+            gig::Script* script = group->AddScript();
+            script->Name = "Script " + ToString(i);
+            script->SetScriptAsText(
+                "on note\n"
+                "  change_tune($EVENT_ID, " + ToString(rnd.next(2000) - 1000) + ")\n"
+                "  change_vol($EVENT_ID, " + ToString(-rnd.next(6000)) + ")\n"
+                "end on\n"
+            );
+            scripts.push_back(script);
+        }
+    }
+
+    for (int i = 0; i < params.instruments; ++i) {
+        gig::Instrument* instr = gig.AddInstrument();
+        instr->pInfo->Name = "Instrument " + ToString(i);
+        for (int r = 0; r < nRegions; ++r) {
+            gig::Region* rgn = instr->AddRegion();
+            rgn->SetKeyRange(r * 128 / nRegions, (r + 1) * 128 / nRegions - 1);
+            for (int d = 0; d < nDimensions; ++d) {
+                gig::dimension_def_t dim;
+                dim.dimension = dimensionTypes[d];
+                dim.bits = 1;
+                dim.zones = 2;
+                rgn->AddDimension(&dim);
+            }
+            for (int d = 0; d < rgn->DimensionRegions; ++d) {
+                gig::DimensionRegion* dr = rgn->pDimensionRegions[d];
+                dr->pSample = samples[rnd.next(params.samples)];
+                dr->EG1Attack = rnd.next(1000) / 1000.0;
+                dr->EG1Release = rnd.next(4000) / 1000.0;
+                dr->VCFCutoff = rnd.next(128);
+                if (rnd.next(2)) {
+                    DLS::sample_loop_t loop;
+                    loop.LoopType = gig::loop_type_normal;
+                    loop.LoopStart = 0;
+                    loop.LoopLength = params.sampleFrames;
+                    dr->AddSampleLoop(&loop);
+                }
+            }
+        }
+        if (!scripts.empty())
+            instr->AddScriptSlot(scripts[i % scripts.size()]);
+    }
+
+    // the samples' data chunks exist only after saving, so their sample
+    // data can be written only now
+    gig.Save(path);
+    std::vector<int16_t> buf(params.sampleFrames);
+    for (int i = 0; i < samples.size(); ++i) {
+        generateSampleData(buf, rnd);
+        samples[i]->SetPos(0);
+        samples[i]->Write(&buf[0], params.sampleFrames);
+    }
+}
@@ -0,0 +1,40 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#ifndef GIGEDIT_SYNTHETICGIG_H
+#define GIGEDIT_SYNTHETICGIG_H
+
+#include "global.h"
+
+#include <string>
+
+/** @brief Generates .gig files for performance testing.
+ *
+ * The generated files have pseudo-random content, which only depends on the
+ * given size parameters and seed, so each run of the generator creates
+ * exactly the same file. Used by the stress file generator tool
+ * (gigedit-stressgen) and by the microbenchmark (gigedit-bench).
+ */
+class SyntheticGig {
+public:
+    struct Params {
+        int instruments;
+        int regions; ///< Per instrument, splitting the 128 keys evenly (at most 128).
+        int dimensions; ///< Per region (at most 8), each one with 2 zones.
+        int samples; ///< Short mono samples, randomly assigned to the dimension regions.
+        int sampleFrames; ///< Length of each sample in sample points.
+        int scripts; ///< Instrument scripts, assigned to the instruments round robin.
+        uint32_t seed;
+
+        Params();
+    };
+
+    static bool preset(const std::string& name, Params& params);
+    static void create(const std::string& path, const Params& params);
+};
+
+#endif // GIGEDIT_SYNTHETICGIG_H
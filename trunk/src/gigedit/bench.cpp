@@ -0,0 +1,537 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+// Microbenchmark of gigedit's GUI-free model code (libgigeditcore), built
+// and run by "make bench". Each stage works on a synthetic .gig file, so the
+// results are comparable between runs. Some stages and a few untimed checks
+// also verify the results of the model code and fail the run if they are
+// wrong. With --baseline the results are compared against a stored baseline
+// (only reported if none is stored yet), with --write-baseline they become
+// the new baseline.
+
+#include "global.h"
+#include "CombineInstruments.h"
+#include "DimRegionPatch.h"
+#include "DimRegionChangeDebouncer.h"
+#include "DimensionOptimizer.h"
+#include "SampleImporter.h"
+#include "SyntheticGig.h"
+
+#include <glib/gstdio.h>
+#include <glibmm/init.h>
+#include <glibmm/miscutils.h>
+
+#include <fstream>
+#include <iostream>
+#include <stdlib.h>
+
+#ifdef LIBSNDFILE_HEADER_FILE
+# include LIBSNDFILE_HEADER_FILE(sndfile.h)
+#else
+# include <sndfile.h>
+#endif
+
+// size of the synthetic input
+#define INSTRUMENTS         64
+#define REGIONS             32 // per instrument, each spanning 4 keys
+#define DIMENSIONS          4
+#define SAMPLES             256
+#define SAMPLE_FRAMES       4410
+#define IMPORTED_SAMPLES    64
+#define SCAN_REPETITIONS    10
+#define COMBINED_INSTRUMENTS 8 // by stages "combine-1thread" and "combine-nthreads"
+#define PIANO_INSTRUMENTS   32 // combined by stage "combine-32x88" ...
+#define PIANO_KEYS          88 // ... each with one region per piano key
+
+// slower than baseline by more than this is reported as regression
+#define DEFAULT_TOLERANCE_PERCENT 25
+
+namespace {
+
+    struct Result {
+        std::string stage;
+        double ms;
+    };
+
+    std::vector<Result> g_results;
+
+    class StageTimer {
+    public:
+        StageTimer(const std::string& stage) : stage(stage), t0(g_get_monotonic_time()) {}
+        ~StageTimer() {
+            Result r = { stage, (g_get_monotonic_time() - t0) / 1000.0 };
+            g_results.push_back(r);
+        }
+    private:
+        std::string stage;
+        gint64 t0;
+    };
+
+    // Removes all added files when going out of scope, so no temporary files
+    // are left behind if a stage throws.
+    class TempFiles {
+    public:
+        ~TempFiles() {
+            for (int i = 0; i < paths.size(); ++i)
+                g_remove(paths[i].c_str());
+        }
+        std::string add(const std::string& path) {
+            paths.push_back(path);
+            return path;
+        }
+    private:
+        std::vector<std::string> paths;
+    };
+
+    // deterministic, so each run works on exactly the same content
+    class Random {
+    public:
+        Random() : state(0x12345678) {}
+        uint32_t next() {
+            state = state * 1664525 + 1013904223;
+            return state;
+        }
+    private:
+        uint32_t state;
+    };
+
+    /**
+     * Stands in for the sampler in live-mode: keeps track of the regions
+     * suspended by the notifications it receives, and calls the debouncer's
+     * flush() when idle() is called, like gigedit's event loop would do.
+     */
+    class MockSamplerHost : public DimRegionChangeDebouncer::Host {
+    public:
+        MockSamplerHost() : debouncer(NULL), flushPending(false), notifications(0) {}
+
+        virtual void regionToBeChanged(gig::Region* pRegion) {
+            suspended[pRegion]++;
+            notifications++;
+        }
+
+        virtual void regionChanged(gig::Region* pRegion) {
+            if (--suspended[pRegion] < 0)
+                throw RIFF::Exception("region resumed without being suspended");
+            notifications++;
+        }
+
+        virtual void scheduleFlush() {
+            flushPending = true;
+        }
+
+        void idle() {
+            if (!flushPending) return;
+            flushPending = false;
+            debouncer->flush();
+        }
+
+        /// Throws if any region is still suspended.
+        void checkAllResumed() const {
+            for (std::map<gig::Region*,int>::const_iterator it = suspended.begin();
+                 it != suspended.end(); ++it)
+            {
+                if (it->second)
+                    throw RIFF::Exception("region still suspended after edit");
+            }
+        }
+
+        DimRegionChangeDebouncer* debouncer;
+        bool flushPending;
+        int notifications;
+        std::map<gig::Region*,int> suspended;
+    };
+
+    /**
+     * Simulates changing one parameter of all dimension regions of all
+     * regions (that is with "all regions" and "all dimension regions"
+     * selected in the GUI) @a repetitions times and returns the amount of
+     * notifications the (mock) sampler received. This is a microbenchmark of
+     * DimRegionChangeDebouncer only: neither the sampler plugin, nor the
+     * sampler itself, nor any GUI round trip or memory usage is measured.
+     */
+    int runDebounceCycle(const std::vector<gig::Instrument*>& instruments,
+                       bool bInstantCommit, int repetitions)
+    {
+        MockSamplerHost host;
+        DimRegionChangeDebouncer debouncer(host);
+        host.debouncer = &debouncer;
+        std::vector<gig::DimensionRegion*> dimRgns;
+        for (int k = 0; k < instruments.size(); ++k) {
+            for (gig::Region* rgn = instruments[k]->GetFirstRegion(); rgn;
+                 rgn = instruments[k]->GetNextRegion())
+            {
+                for (int d = 0; d < rgn->DimensionRegions; ++d)
+                    dimRgns.push_back(rgn->pDimensionRegions[d]);
+            }
+        }
+        for (int i = 0; i < repetitions; ++i) {
+            // gigedit announces all changes of one edit before applying them
+            for (int d = 0; d < dimRgns.size(); ++d)
+                debouncer.dimRegionToBeChanged(dimRgns[d], bInstantCommit);
+            for (int d = 0; d < dimRgns.size(); ++d)
+                dimRgns[d]->EG1Attack = i / 100.0;
+            for (int d = 0; d < dimRgns.size(); ++d)
+                debouncer.dimRegionChanged(dimRgns[d]);
+            host.idle();
+        }
+        host.checkAllResumed();
+        return host.notifications;
+    }
+
+    // Returns whether the optimizer finds a redundant velocity dimension in
+    // a region whose two velocity zones have equal parameters and differ at
+    // most in the length of their sample loop.
+    bool velocityZonesMerged(bool bDifferentLoops) {
+        gig::File gig;
+        gig::Instrument* instr = gig.AddInstrument();
+        gig::Region* rgn = instr->AddRegion();
+        gig::dimension_def_t dim;
+        dim.dimension = gig::dimension_velocity;
+        dim.bits = 1;
+        dim.zones = 2;
+        rgn->AddDimension(&dim);
+        for (int d = 0; d < rgn->DimensionRegions; ++d) {
+            gig::DimensionRegion* dr = rgn->pDimensionRegions[d];
+            dr->EG1Attack = 0.5;
+            dr->UnityNote = 60;
+            DLS::sample_loop_t loop;
+            loop.LoopType = gig::loop_type_normal;
+            loop.LoopStart = 0;
+            loop.LoopLength = (bDifferentLoops && d) ? 2000 : 1000;
+            dr->AddSampleLoop(&loop);
+        }
+        DimensionOptimizer optimizer;
+        optimizer.analyze(&gig);
+        return !optimizer.redundancies().empty();
+    }
+
+    // dimension regions differing only in their sample loops (which are not
+    // covered by libgig's serialization) must not be merged
+    void checkOptimizerComparesLoops() {
+        if (!velocityZonesMerged(false))
+            throw RIFF::Exception("optimize: equal velocity zones were not merged");
+        if (velocityZonesMerged(true))
+            throw RIFF::Exception("optimize: velocity zones with different loops were merged");
+    }
+
+    void fillSampleData(std::vector<int16_t>& buf, Random& rnd) {
+        for (int i = 0; i < buf.size(); ++i)
+            buf[i] = int16_t(rnd.next() >> 16);
+    }
+
+    // creates the audio files imported by the "import" stage
+    std::vector<std::string> createAudioFiles(const std::string& dir, TempFiles& tempFiles) {
+        Random rnd;
+        std::vector<std::string> files;
+        std::vector<int16_t> buf(SAMPLE_FRAMES);
+        for (int i = 0; i < IMPORTED_SAMPLES; ++i) {
+            const std::string path =
+                tempFiles.add(Glib::build_filename(dir, "import" + ToString(i) + ".wav"));
+            SF_INFO info;
+            info.samplerate = 44100;
+            info.channels = 1;
+            info.format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+            SNDFILE* hFile = sf_open(path.c_str(), SFM_WRITE, &info);
+            if (!hFile) throw RIFF::Exception("could not create " + path);
+            fillSampleData(buf, rnd);
+            sf_writef_short(hFile, &buf[0], SAMPLE_FRAMES);
+            sf_close(hFile);
+            files.push_back(path);
+        }
+        return files;
+    }
+
+    std::string readFile(const std::string& path) {
+        std::ifstream in(path.c_str(), std::ios_base::in | std::ios_base::binary);
+        std::ostringstream ss;
+        ss << in.rdbuf();
+        if (!in) throw RIFF::Exception("could not read " + path);
+        return ss.str();
+    }
+
+    // Combines the same instruments of the file at @a gigPath single threaded
+    // and with one thread per processor; the saved results must be identical.
+    void runCombineThreadsStages(const std::string& dir, const std::string& gigPath,
+                                 TempFiles& tempFiles)
+    {
+        const int maxThreads[2] = { 1, g_get_num_processors() };
+        std::string results[2];
+        for (int i = 0; i < 2; ++i) {
+            RIFF::File riff(gigPath);
+            gig::File gig(&riff);
+            std::vector<gig::Instrument*> sources;
+            for (gig::Instrument* instr = gig.GetFirstInstrument();
+                 instr && sources.size() < COMBINED_INSTRUMENTS;
+                 instr = gig.GetNextInstrument())
+                sources.push_back(instr);
+            {
+                StageTimer t(i ? "combine-nthreads" : "combine-1thread");
+                gig::Instrument* output = NULL;
+                std::set<Glib::ustring> warnings;
+                combineInstruments(sources, &gig, output, gig::dimension_layer,
+                                   warnings, maxThreads[i]);
+            }
+            const std::string outPath = tempFiles.add(
+                Glib::build_filename(dir, "combined" + ToString(i) + ".gig")
+            );
+            gig.Save(outPath);
+            results[i] = readFile(outPath);
+        }
+        if (results[0] != results[1])
+            throw RIFF::Exception("combine: result of " + ToString(maxThreads[1]) +
+                                  " threads differs from single threaded result");
+    }
+
+    void runStages(const std::string& dir) {
+        checkOptimizerComparesLoops();
+
+        // declared first, so the files are removed after they were closed
+        TempFiles tempFiles;
+        const std::string gigPath = tempFiles.add(Glib::build_filename(dir, "bench.gig"));
+        {
+            StageTimer t("create");
+            SyntheticGig::Params params;
+            params.instruments = INSTRUMENTS;
+            params.regions = REGIONS;
+            params.dimensions = DIMENSIONS;
+            params.samples = SAMPLES;
+            params.sampleFrames = SAMPLE_FRAMES;
+            params.scripts = 0;
+            SyntheticGig::create(gigPath, params);
+        }
+        const std::vector<std::string> audioFiles = createAudioFiles(dir, tempFiles);
+
+        RIFF::File riff(gigPath);
+        gig::File gig(&riff);
+        std::vector<gig::Instrument*> instruments;
+        {
+            StageTimer t("load");
+            gig.GetFirstSample();
+            for (gig::Instrument* instr = gig.GetFirstInstrument(); instr;
+                 instr = gig.GetNextInstrument())
+                instruments.push_back(instr);
+        }
+
+        {
+            StageTimer t("refcount");
+            std::map<gig::Sample*,int> refCount;
+            for (int i = 0; i < SCAN_REPETITIONS; ++i)
+                countSampleRefs(&gig, refCount);
+        }
+
+        {
+            StageTimer t("features");
+            int loops = 0;
+            for (int i = 0; i < SCAN_REPETITIONS; ++i) {
+                for (int k = 0; k < instruments.size(); ++k) {
+                    for (gig::Region* rgn = instruments[k]->GetFirstRegion(); rgn;
+                         rgn = instruments[k]->GetNextRegion())
+                        loops += regionFeatures(rgn).loops;
+                }
+            }
+            if (loops < 0) std::cout << loops; // prevent optimizing the loop away
+        }
+
+        {
+            StageTimer t("macro");
+            gig::DimensionRegion* layout =
+                instruments[0]->GetFirstRegion()->pDimensionRegions[0];
+            layout->EG1Attack = 0.5;
+            layout->Crossfade.in_end = 64;
+            Serialization::Archive macro;
+            macro.serialize(layout);
+            DimRegionPatch patch;
+            const bool bCompiled = patch.compile(macro, layout);
+            for (int k = 0; k < instruments.size(); ++k) {
+                for (gig::Region* rgn = instruments[k]->GetFirstRegion(); rgn;
+                     rgn = instruments[k]->GetNextRegion())
+                {
+                    for (int d = 0; d < rgn->DimensionRegions; ++d) {
+                        if (bCompiled)
+                            patch.apply(rgn->pDimensionRegions[d]);
+                        else
+                            macro.deserialize(rgn->pDimensionRegions[d]);
+                    }
+                }
+            }
+        }
+
+        // debouncing of live-mode notifications, each region must only be
+        // suspended once per edit, no matter how many of its dimension
+        // regions are changed
+        const int expectedNotifications =
+            2 * INSTRUMENTS * REGIONS * SCAN_REPETITIONS;
+        {
+            StageTimer t("debounce");
+            if (runDebounceCycle(instruments, false, SCAN_REPETITIONS) != expectedNotifications)
+                throw RIFF::Exception("debounce: dimension region changes were not coalesced");
+        }
+        {
+            StageTimer t("debounce-instant");
+            if (runDebounceCycle(instruments, true, SCAN_REPETITIONS) != expectedNotifications)
+                throw RIFF::Exception("debounce-instant: dimension region changes were not coalesced");
+        }
+
+        {
+            StageTimer t("combine");
+            std::vector<gig::Instrument*> sources(instruments.begin(), instruments.begin() + 4);
+            gig::Instrument* output = NULL;
+            std::set<Glib::ustring> warnings;
+            combineInstruments(sources, &gig, output, gig::dimension_layer, warnings);
+        }
+
+        {
+            gig::File pianos;
+            std::vector<gig::Instrument*> sources;
+            for (int i = 0; i < PIANO_INSTRUMENTS; ++i) {
+                gig::Instrument* instr = pianos.AddInstrument();
+                instr->pInfo->Name = "Piano " + ToString(i);
+                for (int key = 21; key < 21 + PIANO_KEYS; ++key) {
+                    gig::Region* rgn = instr->AddRegion();
+                    rgn->SetKeyRange(key, key);
+                }
+                sources.push_back(instr);
+            }
+            StageTimer t("combine-32x88");
+            gig::Instrument* output = NULL;
+            std::set<Glib::ustring> warnings;
+            combineInstruments(sources, &pianos, output, gig::dimension_layer, warnings);
+        }
+
+        runCombineThreadsStages(dir, gigPath, tempFiles);
+
+        // sample import, split up into resizing the sample chunks, saving the
+        // resized file and writing the sample data
+        std::vector<SampleImporter::Job> jobs;
+        {
+            StageTimer t("import-prepare");
+            gig::Sample* sample = gig.GetFirstSample();
+            for (int i = 0; i < audioFiles.size() && sample; ++i, sample = gig.GetNextSample()) {
+                Glib::ustring error;
+                if (!SampleImporter::prepareSample(sample, audioFiles[i], error))
+                    throw RIFF::Exception(audioFiles[i] + ": " + error.raw());
+                SampleImporter::Job job;
+                job.sample = sample;
+                job.path = audioFiles[i];
+                job.framesWritten = 0;
+                jobs.push_back(job);
+            }
+        }
+        {
+            StageTimer t("import-save");
+            gig.Save();
+        }
+        {
+            StageTimer t("import");
+            SampleImporter importer;
+            importer.run(jobs);
+            for (int i = 0; i < jobs.size(); ++i)
+                if (!jobs[i].error.empty())
+                    throw RIFF::Exception(jobs[i].path + ": " + jobs[i].error.raw());
+        }
+    }
+
+    std::map<std::string,double> loadBaseline(const std::string& path) {
+        std::map<std::string,double> baseline;
+        std::ifstream in(path.c_str());
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            const size_t tab = line.find('\t');
+            if (tab == std::string::npos) continue;
+            baseline[line.substr(0, tab)] = atof(line.c_str() + tab + 1);
+        }
+        return baseline;
+    }
+
+    bool writeBaseline(const std::string& path) {
+        std::ofstream out(path.c_str());
+        out << "# gigedit-bench baseline: stage<TAB>milliseconds\n";
+        for (int i = 0; i < g_results.size(); ++i)
+            out << g_results[i].stage << "\t" << g_results[i].ms << "\n";
+        return out.good();
+    }
+
+    void usage() {
+        std::cerr << "usage: gigedit-bench [--baseline FILE [--tolerance PERCENT]] "
+                     "[--write-baseline FILE]" << std::endl;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string baselineFile, newBaselineFile;
+    double tolerance = DEFAULT_TOLERANCE_PERCENT;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--baseline" && i + 1 < argc)
+            baselineFile = argv[++i];
+        else if (arg == "--write-baseline" && i + 1 < argc)
+            newBaselineFile = argv[++i];
+        else if (arg == "--tolerance" && i + 1 < argc)
+            tolerance = atof(argv[++i]);
+        else {
+            usage();
+            return 2;
+        }
+    }
+
+    // without a stored baseline the results are only reported, so say so
+    // instead of silently comparing nothing
+    const std::map<std::string,double> baseline =
+        baselineFile.empty() ? std::map<std::string,double>() : loadBaseline(baselineFile);
+    if (!baselineFile.empty() && baseline.empty()) {
+        std::cerr << "No baseline stored in '" << baselineFile
+                  << "' yet, only reporting the results (run 'make "
+                     "bench-baseline' to create it)." << std::endl;
+    }
+
+    Glib::init();
+#ifdef OLD_THREADS
+    if (!Glib::thread_supported()) Glib::thread_init();
+#endif
+
+    gchar* dir = g_dir_make_tmp("gigedit-bench-XXXXXX", NULL);
+    if (!dir) {
+        std::cerr << "Could not create temporary directory" << std::endl;
+        return 2;
+    }
+    try {
+        runStages(dir);
+    } catch (RIFF::Exception e) {
+        std::cerr << e.Message << std::endl;
+        g_rmdir(dir);
+        g_free(dir);
+        return 2;
+    }
+    g_rmdir(dir);
+    g_free(dir);
+
+    // report: stage, milliseconds and, if available, baseline milliseconds
+    // and the ratio to the baseline
+    int regressions = 0;
+    for (int i = 0; i < g_results.size(); ++i) {
+        const Result& r = g_results[i];
+        std::cout << "bench\t" << r.stage << "\t" << r.ms;
+        std::map<std::string,double>::const_iterator it = baseline.find(r.stage);
+        if (it != baseline.end() && it->second > 0) {
+            const double ratio = r.ms / it->second;
+            std::cout << "\t" << it->second << "\t" << ratio;
+            if (ratio > 1.0 + tolerance / 100.0) {
+                std::cout << "\tREGRESSION";
+                regressions++;
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    if (!newBaselineFile.empty() && !writeBaseline(newBaselineFile)) {
+        std::cerr << "Could not write baseline '" << newBaselineFile << "'" << std::endl;
+        return 2;
+    }
+    return regressions ? 1 : 0;
+}
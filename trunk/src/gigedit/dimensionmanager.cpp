@@ -44,84 +44,6 @@
 #include "global.h"
 #include "compat.h"
 
-// returns a human readable name of the given dimension type
-Glib::ustring dimTypeAsString(gig::dimension_t d) {
-    char buf[32];
-    switch (d) {
-        case gig::dimension_none:
-            return _("None");
-        case gig::dimension_samplechannel:
-            return _("Sample Channel");
-        case gig::dimension_layer:
-            return _("Layer");
-        case gig::dimension_velocity:
-            return _("Velocity");
-        case gig::dimension_channelaftertouch:
-            return _("Aftertouch");
-        case gig::dimension_releasetrigger:
-            return _("Release Trigger");
-        case gig::dimension_keyboard:
-            return _("Keyswitching");
-        case gig::dimension_roundrobin:
-            return _("Round Robin");
-        case gig::dimension_random:
-            return _("Random Generator");
-        case gig::dimension_smartmidi:
-            return _("Smart MIDI");
-        case gig::dimension_roundrobinkeyboard:
-            return _("Keyboard Round Robin");
-        case gig::dimension_modwheel:
-            return _("Modulation Wheel");
-        case gig::dimension_breath:
-            return _("Breath Ctrl.");
-        case gig::dimension_foot:
-            return _("Foot Ctrl.");
-        case gig::dimension_portamentotime:
-            return _("Portamento Time Ctrl.");
-        case gig::dimension_effect1:
-            return _("Effect Ctrl. 1");
-        case gig::dimension_effect2:
-            return _("Effect Ctrl. 2");
-        case gig::dimension_genpurpose1:
-            return _("General Purpose Ctrl. 1");
-        case gig::dimension_genpurpose2:
-            return _("General Purpose Ctrl. 2");
-        case gig::dimension_genpurpose3:
-            return _("General Purpose Ctrl. 3");
-        case gig::dimension_genpurpose4:
-            return _("General Purpose Ctrl. 4");
-        case gig::dimension_sustainpedal:
-            return _("Sustain Pedal");
-        case gig::dimension_portamento:
-            return _("Portamento Ctrl.");
-        case gig::dimension_sostenutopedal:
-            return _("Sostenuto Pedal");
-        case gig::dimension_softpedal:
-            return _("Soft Pedal");
-        case gig::dimension_genpurpose5:
-            return _("General Purpose Ctrl. 5");
-        case gig::dimension_genpurpose6:
-            return _("General Purpose Ctrl. 6");
-        case gig::dimension_genpurpose7:
-            return _("General Purpose Ctrl. 7");
-        case gig::dimension_genpurpose8:
-            return _("General Purpose Ctrl. 8");
-        case gig::dimension_effect1depth:
-            return _("Effect 1 Depth");
-        case gig::dimension_effect2depth:
-            return _("Effect 2 Depth");
-        case gig::dimension_effect3depth:
-            return _("Effect 3 Depth");
-        case gig::dimension_effect4depth:
-            return _("Effect 4 Depth");
-        case gig::dimension_effect5depth:
-            return _("Effect 5 Depth");
-        default:
-            sprintf(buf, "Unknown Type (0x%x) !!!", d);
-            return buf;
-    }
-}
-
 // returns a human readable description of the given dimension
 static Glib::ustring __dimDescriptionAsString(gig::dimension_t d) {
     switch (d) {
@@ -259,6 +181,8 @@ DimensionManager::DimensionManager() :
     allRegionsCheckBox(_("All Regions"))
 {
     ignoreColumnClicked = true;
+    statsInstrument = NULL;
+    restructuringNext = 0;
 
     if (!Settings::singleton()->autoRestoreWindowDimension) {
         set_default_size(630, 250);
@@ -276,6 +200,7 @@ DimensionManager::DimensionManager() :
     scrolledWindow.add(treeView);
     vbox.pack_start(scrolledWindow);
     scrolledWindow.show();
+    vbox.pack_start(progressBar, Gtk::PACK_SHRINK);
     vbox.pack_start(buttonBox, Gtk::PACK_SHRINK);
     buttonBox.set_layout(Gtk::BUTTONBOX_END);
 #if GTKMM_MAJOR_VERSION > 3 || (GTKMM_MAJOR_VERSION == 3 && GTKMM_MINOR_VERSION > 24)
@@ -325,6 +250,8 @@ DimensionManager::DimensionManager() :
 #if HAS_GTKMM_SHOW_ALL_CHILDREN
     show_all_children();
 #endif
+    // only shown while dimensions are restructured
+    progressBar.hide();
 
     Settings::singleton()->showTooltips.get_proxy().signal_changed().connect(
         sigc::mem_fun(*this, &DimensionManager::on_show_tooltips_changed)
@@ -341,6 +268,10 @@ void DimensionManager::on_show_tooltips_changed() {
     set_has_tooltip(b);
 }
 
+DimensionManager::~DimensionManager() {
+    restructuringIdle.disconnect();
+}
+
 bool DimensionManager::allRegions() const {
     return allRegionsCheckBox.get_active();
 }
@@ -357,15 +288,28 @@ void DimensionManager::onAllRegionsCheckBoxToggled() {
     refreshManager();
 }
 
-// following two data types are just used in DimensionManager::refresManager(),
-// due to the maps template nature however, they must be declared at global
-// space to avoid compilation errors
-struct _DimDef {
-    std::set<int> bits;
-    std::set<int> zones;
-    int usageCount;
-};
-typedef std::map<gig::dimension_t, _DimDef> _Dimensions;
+/**
+ * Dimension stats of all regions of the current region's instrument. They
+ * are only recalculated if the instrument was switched, if its amount of
+ * regions changed or if they were invalidated by invalidate_stats(), which
+ * the main window does on each file structure or region change.
+ */
+const DimensionStats& DimensionManager::instrumentStats() {
+    gig::Instrument* instr = (gig::Instrument*)region->GetParent();
+    if (instr != statsInstrument || int(instr->Regions) != stats.regions) {
+        stats = DimensionStats::of(instr);
+        statsInstrument = instr;
+    }
+    return stats;
+}
+
+/**
+ * Must be called if dimensions of the current instrument were changed by
+ * somebody else than this dimension manager.
+ */
+void DimensionManager::invalidate_stats() {
+    statsInstrument = NULL;
+}
 
 // update all GUI elements according to current gig::Region information
 void DimensionManager::refreshManager() {
@@ -373,25 +317,17 @@ void DimensionManager::refreshManager() {
     refTableModel->clear();
     if (allRegions()) {
         if (region) {
-            _Dimensions dims;
-            gig::Instrument* instr = (gig::Instrument*)region->GetParent();
-            int iRegionsCount = 0;
-            for (gig::Region* rgn = instr->GetFirstRegion(); rgn; rgn = instr->GetNextRegion(), ++iRegionsCount) {
-                for (uint i = 0; i < rgn->Dimensions; i++) {
-                    gig::dimension_def_t* dim = &rgn->pDimensionDefinitions[i];
-                    dims[dim->dimension].bits.insert(dim->bits);
-                    dims[dim->dimension].zones.insert(dim->zones);
-                    dims[dim->dimension].usageCount++;
-                }
-            }
-            for (_Dimensions::const_iterator it = dims.begin(); it != dims.end(); ++it) {
+            const DimensionStats& dims = instrumentStats();
+            for (DimensionStats::Dimensions::const_iterator it = dims.dimensions.begin();
+                 it != dims.dimensions.end(); ++it)
+            {
                 Gtk::TreeModel::Row row = *(refTableModel->append());
                 row[tableModel.m_type] = it->first;
                 row[tableModel.m_bits] = it->second.bits;
                 row[tableModel.m_zones] = it->second.zones;
                 row[tableModel.m_description] = __dimDescriptionAsString(it->first);
                 row[tableModel.m_usageCount] = it->second.usageCount;
-                row[tableModel.m_totalRegions] = iRegionsCount;
+                row[tableModel.m_totalRegions] = dims.regions;
             }
         }
     } else {
@@ -418,6 +354,7 @@ void DimensionManager::refreshManager() {
 void DimensionManager::show(gig::Region* region) {
     ignoreColumnClicked = true;
     this->region = region;
+    invalidate_stats();
     refreshManager();
     Gtk::Window::show();
     deiconify();
@@ -519,62 +456,13 @@ void DimensionManager::onColumnClicked() {
             if (newType == oldType) return;
             //printf("change 0x%x -> 0x%x\n", oldType, newType);
 
-            // assemble the list of regions where the selected dimension type
-            // shall be changed
-            std::vector<gig::Region*> vRegions;
-            if (allRegions()) {
-                gig::Instrument* instr = (gig::Instrument*)region->GetParent();
-                for (gig::Region* rgn = instr->GetFirstRegion(); rgn; rgn = instr->GetNextRegion()) {
-                    if (rgn->GetDimensionDefinition(oldType)) vRegions.push_back(rgn);
-                }
-            } else vRegions.push_back(region);
-
-            std::set<Glib::ustring> errors;
-
-            for (uint iRgn = 0; iRgn < vRegions.size(); ++iRgn) {
-                gig::Region* region = vRegions[iRgn];
-                try {
-                    // notify everybody that we're going to update the region
-                    region_to_be_changed_signal.emit(region);
-                    // change the dimension type on that region
-                    region->SetDimensionType(oldType, newType);
-                    // let everybody know there was a change
-                    region_changed_signal.emit(region);
-                } catch (RIFF::Exception e) {
-                    // notify that the changes are over (i.e. to avoid dead locks)
-                    region_changed_signal.emit(region);
-                    Glib::ustring txt = _("Could not alter dimension: ") + e.Message;
-                    if (vRegions.size() == 1) {
-                        // show error message directly
-                        Gtk::MessageDialog msg(*this, txt, false, Gtk::MESSAGE_ERROR);
-                        msg.run();
-                    } else {
-                        // remember error, they are shown after all regions have been processed
-                        errors.insert(txt);
-                    }
-                }
-            }
-            // update all GUI elements
-            refreshManager();
-
-            if (!errors.empty()) {
-                Glib::ustring txt = _(
-                    "The following errors occurred while trying to change the dimension type on all regions:"
-                );
-                txt += "\n\n";
-                for (std::set<Glib::ustring>::const_iterator it = errors.begin();
-                    it != errors.end(); ++it)
-                {
-                    txt += "-> " + *it + "\n";
-                }
-                txt += "\n";
-                txt += _(
-                    "You might also want to check the console for further warnings and "
-                    "error messages."
-                );
-                Gtk::MessageDialog msg(*this, txt, false, Gtk::MESSAGE_ERROR);
-                msg.run();
-            }
+            // change the dimension type on all regions where it exists
+            DimensionRestructuring change;
+            change.changeDimensionType(oldType, newType);
+            std::vector<gig::Region*> vRegions = selectedRegions();
+            restructure(change, vRegions, _(
+                "The following errors occurred while trying to change the dimension type on all regions:"
+            ));
         }
     } else if (focus_column == treeView.get_column(1) || focus_column == treeView.get_column(2)) {
         Glib::ustring txt = _("Right-click on a specific dimension zone of the dimension region selector to delete or split that particular dimension zone!");
@@ -681,67 +569,18 @@ void DimensionManager::addDimension() {
             dim.bits = zoneCountToBits(dim.zones);
         }
 
-        // assemble the list of regions where the selected dimension shall be
-        // added to
-        std::vector<gig::Region*> vRegions;
-        if (allRegions()) {
-            gig::Instrument* instr = (gig::Instrument*)region->GetParent();
-            for (gig::Region* rgn = instr->GetFirstRegion(); rgn; rgn = instr->GetNextRegion()) {
-                if (!rgn->GetDimensionDefinition(type)) vRegions.push_back(rgn);
-            }
-        } else vRegions.push_back(region);
-            
-        std::set<Glib::ustring> errors;
-
-        for (uint iRgn = 0; iRgn < vRegions.size(); ++iRgn) {
-            gig::Region* region = vRegions[iRgn];
-            try {
-                printf(
-                    "Adding dimension (type=0x%x, bits=%d, zones=%d)\n",
-                    dim.dimension, dim.bits, dim.zones
-                );
-                // notify everybody that we're going to update the region
-                region_to_be_changed_signal.emit(region);
-                // add the new dimension to the region
-                // (implicitly creates new dimension regions)
-                region->AddDimension(&dim);
-                // let everybody know there was a change
-                region_changed_signal.emit(region);
-            } catch (RIFF::Exception e) {
-                // notify that the changes are over (i.e. to avoid dead locks)
-                region_changed_signal.emit(region);
-                Glib::ustring txt = _("Could not add dimension: ") + e.Message;
-                if (vRegions.size() == 1) {
-                    // show error message directly
-                    Gtk::MessageDialog msg(*this, txt, false, Gtk::MESSAGE_ERROR);
-                    msg.run();
-                } else {
-                    // remember error, they are shown after all regions have been processed
-                    errors.insert(txt);
-                }
-            }
-        }
-        // update all GUI elements
-        refreshManager();
-
-        if (!errors.empty()) {
-            Glib::ustring txt = _(
-                "The following errors occurred while trying to create the dimension on all regions:"
-            );
-            txt += "\n\n";
-            for (std::set<Glib::ustring>::const_iterator it = errors.begin();
-                 it != errors.end(); ++it)
-            {
-                txt += "-> " + *it + "\n";
-            }
-            txt += "\n";
-            txt += _(
-                "You might also want to check the console for further warnings and "
-                "error messages."
-            );
-            Gtk::MessageDialog msg(*this, txt, false, Gtk::MESSAGE_ERROR);
-            msg.run();
-        }
+        printf(
+            "Adding dimension (type=0x%x, bits=%d, zones=%d)\n",
+            dim.dimension, dim.bits, dim.zones
+        );
+        // add the new dimension to all regions which don't have it yet
+        // (implicitly creates new dimension regions)
+        DimensionRestructuring change;
+        change.addDimension(dim);
+        std::vector<gig::Region*> vRegions = selectedRegions();
+        restructure(change, vRegions, _(
+            "The following errors occurred while trying to create the dimension on all regions:"
+        ));
     }
 }
 
@@ -752,62 +591,126 @@ void DimensionManager::removeDimension() {
         Gtk::TreeModel::Row row = *it;
         gig::dimension_t type = row[tableModel.m_type];
 
-        // assemble the list of regions where the selected dimension shall be
-        // added to
-        std::vector<gig::Region*> vRegions;
-        if (allRegions()) {
-            gig::Instrument* instr = (gig::Instrument*)region->GetParent();
-            for (gig::Region* rgn = instr->GetFirstRegion(); rgn; rgn = instr->GetNextRegion()) {
-                if (rgn->GetDimensionDefinition(type)) vRegions.push_back(rgn);
-            }
-        } else vRegions.push_back(region);
-
-        std::set<Glib::ustring> errors;
-
-        for (uint iRgn = 0; iRgn < vRegions.size(); ++iRgn) {
-            gig::Region* region = vRegions[iRgn];
-            gig::dimension_def_t* dim = region->GetDimensionDefinition(type);
-            try {
-                // notify everybody that we're going to update the region
-                region_to_be_changed_signal.emit(region);
-                // remove selected dimension    
-                region->DeleteDimension(dim);
-                // let everybody know there was a change
-                region_changed_signal.emit(region);
-            } catch (RIFF::Exception e) {
-                // notify that the changes are over (i.e. to avoid dead locks)
-                region_changed_signal.emit(region);
-                Glib::ustring txt = _("Could not remove dimension: ") + e.Message;
-                if (vRegions.size() == 1) {
-                    // show error message directly
-                    Gtk::MessageDialog msg(*this, txt, false, Gtk::MESSAGE_ERROR);
-                    msg.run();
-                } else {
-                    // remember error, they are shown after all regions have been processed
-                    errors.insert(txt);
-                }
-            }
-        }
-        // update all GUI elements
-        refreshManager();
-
-        if (!errors.empty()) {
-            Glib::ustring txt = _(
-                "The following errors occurred while trying to remove the dimension from all regions:"
-            );
-            txt += "\n\n";
-            for (std::set<Glib::ustring>::const_iterator it = errors.begin();
-                 it != errors.end(); ++it)
-            {
-                txt += "-> " + *it + "\n";
-            }
-            txt += "\n";
-            txt += _(
-                "You might also want to check the console for further warnings and "
-                "error messages."
-            );
-            Gtk::MessageDialog msg(*this, txt, false, Gtk::MESSAGE_ERROR);
-            msg.run();
+        // remove selected dimension from all regions which have it
+        DimensionRestructuring change;
+        change.removeDimension(type);
+        std::vector<gig::Region*> vRegions = selectedRegions();
+        restructure(change, vRegions, _(
+            "The following errors occurred while trying to remove the dimension from all regions:"
+        ));
+    }
+}
+
+/**
+ * Returns the regions the dimension editing actions of this window apply
+ * to, that is either all regions of the current instrument or only the
+ * currently selected region.
+ */
+std::vector<gig::Region*> DimensionManager::selectedRegions() const {
+    std::vector<gig::Region*> vRegions;
+    if (allRegions()) {
+        gig::Instrument* instr = (gig::Instrument*)region->GetParent();
+        for (gig::Region* rgn = instr->GetFirstRegion(); rgn; rgn = instr->GetNextRegion())
+            vRegions.push_back(rgn);
+    } else vRegions.push_back(region);
+    return vRegions;
+}
+
+/**
+ * Applies the given dimension changes to all given regions at once. The
+ * regions are processed in small chunks from an idle handler of the GUI
+ * thread (see onRestructuringIdle()), so the progress bar is redrawn
+ * meanwhile without any other thread accessing the gig file concurrently.
+ * If more than one region is affected, the sampler is notified only once
+ * about the structure change of the instrument, instead of once for each
+ * region.
+ */
+void DimensionManager::restructure(const DimensionRestructuring& change,
+                                   const std::vector<gig::Region*>& vRegions,
+                                   const Glib::ustring& errorsText)
+{
+    if (vRegions.empty()) return;
+    gig::Instrument* instr = (gig::Instrument*)vRegions[0]->GetParent();
+    const bool batch = vRegions.size() > 1;
+
+    // block user input to the other windows while the regions are processed
+    set_sensitive(false);
+    set_modal(true);
+    progressBar.set_fraction(0);
+    if (batch) progressBar.show();
+
+    // notify everybody that we're going to update the region(s)
+    if (batch) instrument_struct_to_be_changed_signal.emit(instr);
+    else region_to_be_changed_signal.emit(vRegions[0]);
+
+    restructuring = change;
+    restructuring.begin();
+    restructuringRegions = vRegions;
+    restructuringNext = 0;
+    restructuringErrorsText = errorsText;
+    restructuringIdle.disconnect();
+    restructuringIdle = Glib::signal_idle().connect(
+        sigc::mem_fun(*this, &DimensionManager::onRestructuringIdle)
+    );
+}
+
+/**
+ * Restructures the next few regions of the current batch. Each region is
+ * restructured entirely within one call, so redraws of the other windows
+ * in between never see a region in a half changed state.
+ */
+bool DimensionManager::onRestructuringIdle() {
+    const size_t regionsPerCall = 4;
+    const size_t n = restructuringRegions.size();
+    for (size_t i = 0; i < regionsPerCall && restructuringNext < n; ++i)
+        restructuring.apply(restructuringRegions[restructuringNext++]);
+    progressBar.set_fraction(float(restructuringNext) / float(n));
+    if (restructuringNext < n) return true; // call again
+    restructuring.finish(restructuringRegions);
+    onRestructuringFinished();
+    return false; // disconnect
+}
+
+void DimensionManager::onRestructuringFinished() {
+    const DimensionRestructuring& change = restructuring;
+    const std::vector<gig::Region*>& vRegions = restructuringRegions;
+    gig::Instrument* instr = (gig::Instrument*)vRegions[0]->GetParent();
+    const bool batch = vRegions.size() > 1;
+
+    // let everybody know there was a change
+    if (batch) instrument_struct_changed_signal.emit(instr);
+    else region_changed_signal.emit(vRegions[0]);
+
+    progressBar.hide();
+    set_modal(false);
+
+    // the restructuring already visited all regions, so reuse its stats
+    stats = change.stats(instr);
+    statsInstrument = instr;
+
+    // update all GUI elements
+    refreshManager();
+
+    const std::set<Glib::ustring>& errors = change.errors();
+    if (errors.empty()) return;
+    Glib::ustring txt;
+    if (!batch) {
+        // show error message directly
+        txt = *errors.begin();
+    } else {
+        txt = restructuringErrorsText;
+        txt += "\n\n";
+        for (std::set<Glib::ustring>::const_iterator it = errors.begin();
+             it != errors.end(); ++it)
+        {
+            txt += "-> " + *it + "\n";
         }
+        txt += "\n";
+        txt += _(
+            "You might also want to check the console for further warnings and "
+            "error messages."
+        );
     }
+    Gtk::MessageDialog msg(*this, txt, false, Gtk::MESSAGE_ERROR);
+    msg.run();
 }
@@ -31,6 +31,7 @@
 #include <gtkmm/liststore.h>
 #include <gtkmm/scrolledwindow.h>
 #include <gtkmm/checkbutton.h>
+#include <gtkmm/progressbar.h>
 
 #ifdef LIBGIG_HEADER_FILE
 # include LIBGIG_HEADER_FILE(gig.h)
@@ -40,6 +41,7 @@
 
 #include <set>
 #include "ManagedWindow.h"
+#include "DimensionRestructuring.h"
 
 class DimTypeCellRenderer : public Gtk::CellRendererText {
 public:
@@ -82,10 +84,14 @@ class DimensionManager : public ManagedWindow {
 public:
     sigc::signal<void, gig::Region*> region_to_be_changed_signal;
     sigc::signal<void, gig::Region*> region_changed_signal;
+    sigc::signal<void, gig::Instrument*> instrument_struct_to_be_changed_signal;
+    sigc::signal<void, gig::Instrument*> instrument_struct_changed_signal;
 
     DimensionManager();
+    ~DimensionManager();
     void show(gig::Region* region);
     void set_region(gig::Region* region);
+    void invalidate_stats();
 
     // implementation for abstract methods of interface class "ManagedWindow"
     virtual Settings::Property<int>* windowSettingX() { return &Settings::singleton()->dimensionManagerWindowX; }
@@ -102,6 +108,7 @@ protected:
     Gtk::Button addButton;
     Gtk::Button removeButton;
     Gtk::CheckButton allRegionsCheckBox;
+    Gtk::ProgressBar progressBar;
 
     DimTypeCellRenderer m_cellRendererDimType;
     IntSetCellRenderer m_cellRendererIntSet;
@@ -139,6 +146,18 @@ protected:
     Glib::RefPtr<Gtk::ListStore> refTableModel;
     bool ignoreColumnClicked; //HACK: Prevents that onColumnClicked() gets called multiple times or at times where it is not desired
 
+    // dimension stats of all regions of the current instrument, only
+    // recalculated if the instrument was changed somewhere else
+    DimensionStats stats;
+    gig::Instrument* statsInstrument;
+
+    // batch currently being applied by onRestructuringIdle()
+    DimensionRestructuring restructuring;
+    std::vector<gig::Region*> restructuringRegions;
+    size_t restructuringNext;
+    sigc::connection restructuringIdle;
+    Glib::ustring restructuringErrorsText;
+
     void onAllRegionsCheckBoxToggled();
     void on_show_tooltips_changed();
     void onColumnClicked();
@@ -146,6 +165,11 @@ protected:
     void addDimension();
     void removeDimension();
     bool allRegions() const;
+    std::vector<gig::Region*> selectedRegions() const;
+    const DimensionStats& instrumentStats();
+    void restructure(const DimensionRestructuring& change, const std::vector<gig::Region*>& regions, const Glib::ustring& errorsText);
+    bool onRestructuringIdle();
+    void onRestructuringFinished();
 };
 
 #endif // GIGEDIT_DIMENSIONMANAGER_H
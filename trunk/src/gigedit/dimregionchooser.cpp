@@ -82,7 +82,8 @@ DimRegionChooser::DimRegionChooser(Gtk::Window& window) :
     red("#ff476e"),
     blue("#4796ff"),
     black("black"),
-    white("white")
+    white("white"),
+    layoutCacheInstrument(NULL)
 {
     // make sure blue hatched pattern pixmap is loaded
     loadBuiltInPix();
@@ -807,35 +808,127 @@ void DimRegionChooser::refresh_all() {
     set_region(region);
 }
 
-void DimRegionChooser::get_dimregions(const gig::Region* region, bool stereo,
-                                      std::set<gig::DimensionRegion*>& dimregs) const
+static const std::set<int> emptyZoneSet;
+
+static bool isSameLayout(const gig::dimension_def_t* a, uint dimsA,
+                         const gig::dimension_def_t* b, uint dimsB)
+{
+    if (dimsA != dimsB) return false;
+    for (uint d = 0; d < dimsA; ++d) {
+        if (a[d].dimension != b[d].dimension ||
+            a[d].bits != b[d].bits ||
+            a[d].zones != b[d].zones) return false;
+    }
+    return true;
+}
+
+const DimRegionChooser::RegionLayout&
+DimRegionChooser::layoutOf(const gig::Region* region) const
 {
+    const gig::Instrument* instrument =
+        (gig::Instrument*) ((gig::Region*) region)->GetParent();
+    if (instrument != layoutCacheInstrument) {
+        // drop layouts of other instruments' regions, so the cache does
+        // not grow with every instrument visited
+        layoutCache.clear();
+        layoutCacheInstrument = instrument;
+    }
+    RegionLayout& layout = layoutCache[region];
+    if (!layout.allDimRegions.empty() &&
+        isSameLayout(layout.dimDefs, layout.dimensions,
+                     region->pDimensionDefinitions, region->Dimensions) &&
+        !memcmp(layout.dimRegions, region->pDimensionRegions,
+                sizeof(layout.dimRegions)))
+    {
+        return layout; // dimension structure unchanged, reuse cached layout
+    }
+
+    layout.dimensions = region->Dimensions;
+    for (uint d = 0; d < region->Dimensions && d < 8; ++d)
+        layout.dimDefs[d] = region->pDimensionDefinitions[d];
+    memcpy(layout.dimRegions, region->pDimensionRegions,
+           sizeof(layout.dimRegions));
+
+    layout.allDimRegions.clear();
+    for (int i = 0; i < region->DimensionRegions; ++i)
+        if (region->pDimensionRegions[i])
+            layout.allDimRegions.push_back(region->pDimensionRegions[i]);
+
+    // there are also DimensionRegion objects of unused zones, skip them
+    layout.usedIndices.clear();
     for (int iDimRgn = 0; iDimRgn < 256; ++iDimRgn) {
-        gig::DimensionRegion* dimRgn = region->pDimensionRegions[iDimRgn];
-        if (!dimRgn) continue;
-        bool isValidZone;
-        std::map<gig::dimension_t,int> dimCase = caseOfDimRegion(dimRgn, &isValidZone);
-        if (!isValidZone) continue;
-        for (std::map<gig::dimension_t,int>::const_iterator it = dimCase.begin();
-             it != dimCase.end(); ++it)
-        {
-            if (stereo && it->first == gig::dimension_samplechannel) continue; // is selected
-
-            std::map<gig::dimension_t, std::set<int> >::const_iterator itSelectedDimension =
-                this->dimzones.find(it->first);
-            if (itSelectedDimension != this->dimzones.end() &&
-                itSelectedDimension->second.count(it->second)) continue; // is selected
-
-            goto notSelected;
+        if (!region->pDimensionRegions[iDimRgn]) continue;
+        bool isValidZone = true;
+        for (int d = 0, baseBits = 0; d < region->Dimensions; ++d) {
+            const int bits = region->pDimensionDefinitions[d].bits;
+            const int zone = (iDimRgn >> baseBits) & ((1 << bits) - 1);
+            baseBits += bits;
+            if (zone >= region->pDimensionDefinitions[d].zones) {
+                isValidZone = false;
+                break;
+            }
         }
+        if (isValidZone) layout.usedIndices.push_back(iDimRgn);
+    }
 
-        dimregs.insert(dimRgn);
+    return layout;
+}
+
+void DimRegionChooser::clear_layout_cache() {
+    layoutCache.clear();
+    layoutCacheInstrument = NULL;
+}
+
+/**
+ * Appends all dimension regions of @a region to @a dimregs which are
+ * currently selected by this dimension region chooser.
+ */
+void DimRegionChooser::get_dimregions(const gig::Region* region, bool stereo,
+                                      std::vector<gig::DimensionRegion*>& dimregs) const
+{
+    const RegionLayout& layout = layoutOf(region);
+
+    // resolve the selected zones of each dimension of this region once,
+    // instead of looking them up for each dimension region again
+    std::vector<const std::set<int>*> selectedZones(region->Dimensions);
+    for (int d = 0; d < region->Dimensions; ++d) {
+        const gig::dimension_t type = region->pDimensionDefinitions[d].dimension;
+        std::map<gig::dimension_t, std::set<int> >::const_iterator itSelectedDimension =
+            this->dimzones.find(type);
+        selectedZones[d] =
+            (stereo && type == gig::dimension_samplechannel) ? NULL : // all selected
+            (itSelectedDimension != this->dimzones.end()) ? &itSelectedDimension->second :
+            &emptyZoneSet;
+    }
 
-        notSelected:
-        ;
+    for (size_t i = 0; i < layout.usedIndices.size(); ++i) {
+        const int iDimRgn = layout.usedIndices[i];
+        bool isSelected = true;
+        for (int d = 0, baseBits = 0; d < region->Dimensions; ++d) {
+            const int bits = region->pDimensionDefinitions[d].bits;
+            const int zone = (iDimRgn >> baseBits) & ((1 << bits) - 1);
+            baseBits += bits;
+            if (selectedZones[d] && !selectedZones[d]->count(zone)) {
+                isSelected = false;
+                break;
+            }
+        }
+        if (isSelected) dimregs.push_back(region->pDimensionRegions[iDimRgn]);
     }
 }
 
+/**
+ * Appends all dimension regions of @a region to @a dimregs, regardless of
+ * the current selection.
+ */
+void DimRegionChooser::get_all_dimregions(const gig::Region* region,
+                                          std::vector<gig::DimensionRegion*>& dimregs) const
+{
+    const RegionLayout& layout = layoutOf(region);
+    dimregs.insert(dimregs.end(), layout.allDimRegions.begin(),
+                   layout.allDimRegions.end());
+}
+
 void DimRegionChooser::update_after_resize()
 {
     const uint8_t upperLimit = resize.pos - 1;
@@ -1415,6 +1508,8 @@ void DimRegionChooser::split_dimension_zone() {
         Gtk::MessageDialog msg(txt, false, Gtk::MESSAGE_ERROR);
         msg.run();
     }
+    // amount of dimension zones changed
+    region_changed();
     refresh_all();
 }
 
@@ -1476,6 +1571,8 @@ void DimRegionChooser::delete_dimension_zone() {
         Gtk::MessageDialog msg(txt, false, Gtk::MESSAGE_ERROR);
         msg.run();
     }
+    // amount of dimension zones changed
+    region_changed();
     refresh_all();
 }
 
@@ -56,7 +56,10 @@ public:
 
     gig::DimensionRegion* get_main_dimregion() const;
     void get_dimregions(const gig::Region* region, bool stereo,
-                        std::set<gig::DimensionRegion*>& dimregs) const;
+                        std::vector<gig::DimensionRegion*>& dimregs) const;
+    void get_all_dimregions(const gig::Region* region,
+                            std::vector<gig::DimensionRegion*>& dimregs) const;
+    void clear_layout_cache();
     bool select_dimregion(gig::DimensionRegion* dimrgn);
     void select_next_dimzone(bool add = false);
     void select_prev_dimzone(bool add = false);
@@ -116,6 +119,26 @@ protected:
     bool modifyalldimregs;
     bool modifyallregions;
 
+    /**
+     * Cached dimension layout of a region, used by get_dimregions() and
+     * get_all_dimregions(). It is only rebuilt if the region's dimension
+     * structure (dimension definitions or dimension region pointers)
+     * changed since the layout was cached. Only regions of one instrument
+     * are cached at a time, and the main window clears the cache with
+     * clear_layout_cache() on each instrument structure change (i.e. when
+     * the region chooser deleted a region) and each file structure change.
+     */
+    struct RegionLayout {
+        gig::dimension_def_t dimDefs[8];
+        uint dimensions;
+        gig::DimensionRegion* dimRegions[256];
+        std::vector<int> usedIndices; ///< Indices of all dimension regions of used zones.
+        std::vector<gig::DimensionRegion*> allDimRegions; ///< All (non NULL) dimension regions of the region.
+    };
+    mutable std::map<const gig::Region*, RegionLayout> layoutCache;
+    mutable const gig::Instrument* layoutCacheInstrument; ///< Instrument whose regions are currently cached.
+    const RegionLayout& layoutOf(const gig::Region* region) const;
+
     int focus_line;
     std::map<gig::dimension_t, std::set<int> > dimzones; ///< Reflects which zone(s) of the individual dimension are currently selected.
     int label_width;
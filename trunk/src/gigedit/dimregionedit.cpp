@@ -998,6 +998,12 @@ DimRegionEdit::DimRegionEdit() :
     append_page(*table[5], _("Pitch"));
     append_page(*table[6], _("Misc"));
 
+    for (int i = 0; i < 7; ++i)
+        page_outdated[i] = true;
+    signal_switch_page().connect(
+        sigc::mem_fun(*this, &DimRegionEdit::on_page_switched)
+    );
+
     Settings::singleton()->showTooltips.get_proxy().signal_changed().connect(
         sigc::mem_fun(*this, &DimRegionEdit::on_show_tooltips_changed)
     );
@@ -1198,6 +1204,12 @@ void DimRegionEdit::addRightHandSide(Gtk::Widget& widget)
     rowno++;
 }
 
+// only touch the label if its text actually changed, to avoid needless
+// relayouts of the label (and its parent containers)
+static void setLabelText(Gtk::Label& label, const Glib::ustring& text) {
+    if (label.get_text() != text) label.set_text(text);
+}
+
 void DimRegionEdit::set_dim_region(gig::DimensionRegion* d)
 {
     dimregion = d;
@@ -1209,168 +1221,214 @@ void DimRegionEdit::set_dim_region(gig::DimensionRegion* d)
     set_sensitive(d);
     if (!d) return;
 
+    // only refresh the currently visible page now, all other pages are
+    // refreshed as soon as they are shown (see on_page_switched())
+    for (int i = 0; i < 7; ++i)
+        page_outdated[i] = true;
+    refresh_page(get_current_page());
+}
+
+void DimRegionEdit::on_page_switched(void* page, guint page_num)
+{
+    refresh_page(page_num);
+}
+
+/**
+ * Updates the widgets of the given notebook page with the values of the
+ * currently selected dimension region, if that page is not up to date
+ * already. The individual widgets only update themselves if the new value
+ * differs from the one they currently show.
+ */
+void DimRegionEdit::refresh_page(int page)
+{
+    if (page < 0 || page >= 7 || !page_outdated[page] || !dimregion) return;
+    page_outdated[page] = false;
+
+    gig::DimensionRegion* d = dimregion;
+
     update_model++;
-    eEG1PreAttack.set_value(d->EG1PreAttack);
-    eEG1Attack.set_value(d->EG1Attack);
-    eEG1Decay1.set_value(d->EG1Decay1);
-    eEG1Decay2.set_value(d->EG1Decay2);
-    eEG1InfiniteSustain.set_value(d->EG1InfiniteSustain);
-    eEG1Sustain.set_value(d->EG1Sustain);
-    eEG1Release.set_value(d->EG1Release);
-    eEG1Hold.set_value(d->EG1Hold);
-    eEG1Controller.set_value(d->EG1Controller);
-    eEG1ControllerInvert.set_value(d->EG1ControllerInvert);
-    eEG1ControllerAttackInfluence.set_value(d->EG1ControllerAttackInfluence);
-    eEG1ControllerDecayInfluence.set_value(d->EG1ControllerDecayInfluence);
-    eEG1ControllerReleaseInfluence.set_value(d->EG1ControllerReleaseInfluence);
-    eEG1StateOptions.checkBoxAttack.set_value(d->EG1Options.AttackCancel);
-    eEG1StateOptions.checkBoxAttackHold.set_value(d->EG1Options.AttackHoldCancel);
-    eEG1StateOptions.checkBoxDecay1.set_value(d->EG1Options.Decay1Cancel);
-    eEG1StateOptions.checkBoxDecay2.set_value(d->EG1Options.Decay2Cancel);
-    eEG1StateOptions.checkBoxRelease.set_value(d->EG1Options.ReleaseCancel);
-    eLFO1Frequency.set_value(d->LFO1Frequency);
-    eLFO1InternalDepth.set_value(d->LFO1InternalDepth);
-    eLFO1ControlDepth.set_value(d->LFO1ControlDepth);
-    eLFO1Controller.set_value(d->LFO1Controller);
-    eLFO1FlipPhase.set_value(d->LFO1FlipPhase);
-    eLFO1Sync.set_value(d->LFO1Sync);
-    eEG2PreAttack.set_value(d->EG2PreAttack);
-    eEG2Attack.set_value(d->EG2Attack);
-    eEG2Decay1.set_value(d->EG2Decay1);
-    eEG2Decay2.set_value(d->EG2Decay2);
-    eEG2InfiniteSustain.set_value(d->EG2InfiniteSustain);
-    eEG2Sustain.set_value(d->EG2Sustain);
-    eEG2Release.set_value(d->EG2Release);
-    eEG2Controller.set_value(d->EG2Controller);
-    eEG2ControllerInvert.set_value(d->EG2ControllerInvert);
-    eEG2ControllerAttackInfluence.set_value(d->EG2ControllerAttackInfluence);
-    eEG2ControllerDecayInfluence.set_value(d->EG2ControllerDecayInfluence);
-    eEG2ControllerReleaseInfluence.set_value(d->EG2ControllerReleaseInfluence);
-    eEG2StateOptions.checkBoxAttack.set_value(d->EG2Options.AttackCancel);
-    eEG2StateOptions.checkBoxAttackHold.set_value(d->EG2Options.AttackHoldCancel);
-    eEG2StateOptions.checkBoxDecay1.set_value(d->EG2Options.Decay1Cancel);
-    eEG2StateOptions.checkBoxDecay2.set_value(d->EG2Options.Decay2Cancel);
-    eEG2StateOptions.checkBoxRelease.set_value(d->EG2Options.ReleaseCancel);
-    eLFO2Frequency.set_value(d->LFO2Frequency);
-    eLFO2InternalDepth.set_value(d->LFO2InternalDepth);
-    eLFO2ControlDepth.set_value(d->LFO2ControlDepth);
-    eLFO2Controller.set_value(d->LFO2Controller);
-    eLFO2FlipPhase.set_value(d->LFO2FlipPhase);
-    eLFO2Sync.set_value(d->LFO2Sync);
-    eEG3Attack.set_value(d->EG3Attack);
-    eEG3Depth.set_value(d->EG3Depth);
-    eLFO3Frequency.set_value(d->LFO3Frequency);
-    eLFO3InternalDepth.set_value(d->LFO3InternalDepth);
-    eLFO3ControlDepth.set_value(d->LFO3ControlDepth);
-    eLFO3Controller.set_value(d->LFO3Controller);
-    eLFO3Sync.set_value(d->LFO3Sync);
-    eVCFEnabled.set_value(d->VCFEnabled);
-    eVCFType.set_value(d->VCFType);
-    eVCFCutoffController.set_value(d->VCFCutoffController);
-    eVCFCutoffControllerInvert.set_value(d->VCFCutoffControllerInvert);
-    eVCFCutoff.set_value(d->VCFCutoff);
-    eVCFVelocityCurve.set_value(d->VCFVelocityCurve);
-    eVCFVelocityScale.set_value(d->VCFVelocityScale);
-    eVCFVelocityDynamicRange.set_value(d->VCFVelocityDynamicRange);
-    eVCFResonance.set_value(d->VCFResonance);
-    eVCFResonanceDynamic.set_value(d->VCFResonanceDynamic);
-    eVCFResonanceController.set_value(d->VCFResonanceController);
-    eVCFKeyboardTracking.set_value(d->VCFKeyboardTracking);
-    eVCFKeyboardTrackingBreakpoint.set_value(d->VCFKeyboardTrackingBreakpoint);
-    eVelocityResponseCurve.set_value(d->VelocityResponseCurve);
-    eVelocityResponseDepth.set_value(d->VelocityResponseDepth);
-    eVelocityResponseCurveScaling.set_value(d->VelocityResponseCurveScaling);
-    eReleaseVelocityResponseCurve.set_value(d->ReleaseVelocityResponseCurve);
-    eReleaseVelocityResponseDepth.set_value(d->ReleaseVelocityResponseDepth);
-    eReleaseTriggerDecay.set_value(d->ReleaseTriggerDecay);
-    eCrossfade_in_start.set_value(d->Crossfade.in_start);
-    eCrossfade_in_end.set_value(d->Crossfade.in_end);
-    eCrossfade_out_start.set_value(d->Crossfade.out_start);
-    eCrossfade_out_end.set_value(d->Crossfade.out_end);
-    ePitchTrack.set_value(d->PitchTrack);
-    eSustainReleaseTrigger.set_value(d->SustainReleaseTrigger);
-    eNoNoteOffReleaseTrigger.set_value(d->NoNoteOffReleaseTrigger);
-    eDimensionBypass.set_value(d->DimensionBypass);
-    ePan.set_value(d->Pan);
-    eSelfMask.set_value(d->SelfMask);
-    eAttenuationController.set_value(d->AttenuationController);
-    eInvertAttenuationController.set_value(d->InvertAttenuationController);
-    eAttenuationControllerThreshold.set_value(d->AttenuationControllerThreshold);
-    eChannelOffset.set_value(d->ChannelOffset);
-    eSustainDefeat.set_value(d->SustainDefeat);
-    eMSDecode.set_value(d->MSDecode);
-    eSampleStartOffset.set_value(d->SampleStartOffset);
-    eUnityNote.set_value(d->UnityNote);
-    // show sample group name
-    {
-        Glib::ustring s = "---";
-        if (d->pSample && d->pSample->GetGroup())
-            s = d->pSample->GetGroup()->Name;
-        eSampleGroup.text.set_text(s);
-    }
-    // assemble sample format info string
-    {
-        Glib::ustring s;
-        if (d->pSample) {
-            switch (d->pSample->Channels) {
-                case 1: s = _("Mono"); break;
-                case 2: s = _("Stereo"); break;
-                default:
-                    s = ToString(d->pSample->Channels) + _(" audio channels");
-                    break;
+    switch (page) {
+        case 0: // "Sample"
+            eUnityNote.set_value(d->UnityNote);
+            // show sample group name
+            {
+                Glib::ustring s = "---";
+                if (d->pSample && d->pSample->GetGroup())
+                    s = d->pSample->GetGroup()->Name;
+                setLabelText(eSampleGroup.text, s);
             }
-            s += " " + ToString(d->pSample->BitDepth) + " Bits";
-            s += " " + ToString(d->pSample->SamplesPerSecond/1000) + "."
-                      + ToString((d->pSample->SamplesPerSecond%1000)/100) + " kHz";
-        } else {
-            s = _("No sample assigned to this dimension region.");
-        }
-        eSampleFormatInfo.text.set_text(s);
-    }
-    // generate sample's memory address pointer string
-    {
-        Glib::ustring s;
-        if (d->pSample) {
-            char buf[64] = {};
-            snprintf(buf, sizeof(buf), "%p", d->pSample);
-            s = buf;
-        } else {
-            s = "---";
-        }
-        eSampleID.text.set_text(s);
-    }
-    // generate raw wave form data CRC-32 checksum string
-    {
-        Glib::ustring s = "---";
-        if (d->pSample) {
-            char buf[64] = {};
-            snprintf(buf, sizeof(buf), "%x", d->pSample->GetWaveDataCRC32Checksum());
-            s = buf;
-        }
-        eChecksum.text.set_text(s);
+            // assemble sample format info string
+            {
+                Glib::ustring s;
+                if (d->pSample) {
+                    switch (d->pSample->Channels) {
+                        case 1: s = _("Mono"); break;
+                        case 2: s = _("Stereo"); break;
+                        default:
+                            s = ToString(d->pSample->Channels) + _(" audio channels");
+                            break;
+                    }
+                    s += " " + ToString(d->pSample->BitDepth) + " Bits";
+                    s += " " + ToString(d->pSample->SamplesPerSecond/1000) + "."
+                              + ToString((d->pSample->SamplesPerSecond%1000)/100) + " kHz";
+                } else {
+                    s = _("No sample assigned to this dimension region.");
+                }
+                setLabelText(eSampleFormatInfo.text, s);
+            }
+            // generate sample's memory address pointer string
+            {
+                Glib::ustring s;
+                if (d->pSample) {
+                    char buf[64] = {};
+                    snprintf(buf, sizeof(buf), "%p", d->pSample);
+                    s = buf;
+                } else {
+                    s = "---";
+                }
+                setLabelText(eSampleID.text, s);
+            }
+            // generate raw wave form data CRC-32 checksum string
+            {
+                Glib::ustring s = "---";
+                if (d->pSample) {
+                    char buf[64] = {};
+                    snprintf(buf, sizeof(buf), "%x", d->pSample->GetWaveDataCRC32Checksum());
+                    s = buf;
+                }
+                setLabelText(eChecksum.text, s);
+            }
+            buttonSelectSample.set_sensitive(d && d->pSample);
+            eSampleStartOffset.set_value(d->SampleStartOffset);
+            eChannelOffset.set_value(d->ChannelOffset);
+            eSampleLoopEnabled.set_value(d->SampleLoops);
+            eSampleLoopType.set_value(
+                d->SampleLoops ? d->pSampleLoops[0].LoopType : 0);
+            eSampleLoopStart.set_value(
+                d->SampleLoops ? d->pSampleLoops[0].LoopStart : 0);
+            eSampleLoopLength.set_value(
+                d->SampleLoops ? d->pSampleLoops[0].LoopLength : 0);
+            eSampleLoopInfinite.set_value(
+                d->pSample && d->pSample->LoopPlayCount == 0);
+            eSampleLoopPlayCount.set_value(
+                d->pSample ? d->pSample->LoopPlayCount : 0);
+            {
+                const Glib::ustring s =
+                    d->pSample ? gig_to_utf8(d->pSample->pInfo->Name) : _("NULL");
+                if (wSample->get_text() != s) wSample->set_text(s);
+            }
+            update_loop_elements();
+            break;
+        case 1: // "Amplitude (1)"
+            eGain.set_value(d->Gain);
+            eGainPlus6.set_value(d->Gain);
+            ePan.set_value(d->Pan);
+            eEG1PreAttack.set_value(d->EG1PreAttack);
+            eEG1Attack.set_value(d->EG1Attack);
+            eEG1Hold.set_value(d->EG1Hold);
+            eEG1Decay1.set_value(d->EG1Decay1);
+            eEG1Decay2.set_value(d->EG1Decay2);
+            eEG1InfiniteSustain.set_value(d->EG1InfiniteSustain);
+            eEG1Sustain.set_value(d->EG1Sustain);
+            eEG1Release.set_value(d->EG1Release);
+            eEG1Controller.set_value(d->EG1Controller);
+            eEG1ControllerInvert.set_value(d->EG1ControllerInvert);
+            eEG1ControllerAttackInfluence.set_value(d->EG1ControllerAttackInfluence);
+            eEG1ControllerDecayInfluence.set_value(d->EG1ControllerDecayInfluence);
+            eEG1ControllerReleaseInfluence.set_value(d->EG1ControllerReleaseInfluence);
+            eEG1StateOptions.checkBoxAttack.set_value(d->EG1Options.AttackCancel);
+            eEG1StateOptions.checkBoxAttackHold.set_value(d->EG1Options.AttackHoldCancel);
+            eEG1StateOptions.checkBoxDecay1.set_value(d->EG1Options.Decay1Cancel);
+            eEG1StateOptions.checkBoxDecay2.set_value(d->EG1Options.Decay2Cancel);
+            eEG1StateOptions.checkBoxRelease.set_value(d->EG1Options.ReleaseCancel);
+            break;
+        case 2: // "Amplitude (2)"
+            eLFO1Frequency.set_value(d->LFO1Frequency);
+            eLFO1InternalDepth.set_value(d->LFO1InternalDepth);
+            eLFO1ControlDepth.set_value(d->LFO1ControlDepth);
+            eLFO1Controller.set_value(d->LFO1Controller);
+            eLFO1FlipPhase.set_value(d->LFO1FlipPhase);
+            eLFO1Sync.set_value(d->LFO1Sync);
+            eAttenuationController.set_value(d->AttenuationController);
+            eInvertAttenuationController.set_value(d->InvertAttenuationController);
+            eAttenuationControllerThreshold.set_value(d->AttenuationControllerThreshold);
+            eCrossfade_in_start.set_value(d->Crossfade.in_start);
+            eCrossfade_in_end.set_value(d->Crossfade.in_end);
+            eCrossfade_out_start.set_value(d->Crossfade.out_start);
+            eCrossfade_out_end.set_value(d->Crossfade.out_end);
+            break;
+        case 3: // "Filter (1)"
+            eVCFEnabled.set_value(d->VCFEnabled);
+            eVCFType.set_value(d->VCFType);
+            eVCFCutoffController.set_value(d->VCFCutoffController);
+            eVCFCutoffControllerInvert.set_value(d->VCFCutoffControllerInvert);
+            eVCFCutoff.set_value(d->VCFCutoff);
+            eVCFVelocityCurve.set_value(d->VCFVelocityCurve);
+            eVCFVelocityScale.set_value(d->VCFVelocityScale);
+            eVCFVelocityDynamicRange.set_value(d->VCFVelocityDynamicRange);
+            eVCFResonance.set_value(d->VCFResonance);
+            eVCFResonanceDynamic.set_value(d->VCFResonanceDynamic);
+            eVCFResonanceController.set_value(d->VCFResonanceController);
+            eVCFKeyboardTracking.set_value(d->VCFKeyboardTracking);
+            eVCFKeyboardTrackingBreakpoint.set_value(d->VCFKeyboardTrackingBreakpoint);
+            VCFEnabled_toggled();
+            break;
+        case 4: // "Filter (2)"
+            eEG2PreAttack.set_value(d->EG2PreAttack);
+            eEG2Attack.set_value(d->EG2Attack);
+            eEG2Decay1.set_value(d->EG2Decay1);
+            eEG2Decay2.set_value(d->EG2Decay2);
+            eEG2InfiniteSustain.set_value(d->EG2InfiniteSustain);
+            eEG2Sustain.set_value(d->EG2Sustain);
+            eEG2Release.set_value(d->EG2Release);
+            eEG2Controller.set_value(d->EG2Controller);
+            eEG2ControllerInvert.set_value(d->EG2ControllerInvert);
+            eEG2ControllerAttackInfluence.set_value(d->EG2ControllerAttackInfluence);
+            eEG2ControllerDecayInfluence.set_value(d->EG2ControllerDecayInfluence);
+            eEG2ControllerReleaseInfluence.set_value(d->EG2ControllerReleaseInfluence);
+            eEG2StateOptions.checkBoxAttack.set_value(d->EG2Options.AttackCancel);
+            eEG2StateOptions.checkBoxAttackHold.set_value(d->EG2Options.AttackHoldCancel);
+            eEG2StateOptions.checkBoxDecay1.set_value(d->EG2Options.Decay1Cancel);
+            eEG2StateOptions.checkBoxDecay2.set_value(d->EG2Options.Decay2Cancel);
+            eEG2StateOptions.checkBoxRelease.set_value(d->EG2Options.ReleaseCancel);
+            eLFO2Frequency.set_value(d->LFO2Frequency);
+            eLFO2InternalDepth.set_value(d->LFO2InternalDepth);
+            eLFO2ControlDepth.set_value(d->LFO2ControlDepth);
+            eLFO2Controller.set_value(d->LFO2Controller);
+            eLFO2FlipPhase.set_value(d->LFO2FlipPhase);
+            eLFO2Sync.set_value(d->LFO2Sync);
+            // the sensitivity of this page's widgets depends on the
+            // "Filter (1)" page's VCF enabled check box
+            if (page_outdated[3]) refresh_page(3);
+            else VCFEnabled_toggled();
+            break;
+        case 5: // "Pitch"
+            eFineTune.set_value(d->FineTune);
+            ePitchTrack.set_value(d->PitchTrack);
+            eEG3Attack.set_value(d->EG3Attack);
+            eEG3Depth.set_value(d->EG3Depth);
+            eLFO3Frequency.set_value(d->LFO3Frequency);
+            eLFO3InternalDepth.set_value(d->LFO3InternalDepth);
+            eLFO3ControlDepth.set_value(d->LFO3ControlDepth);
+            eLFO3Controller.set_value(d->LFO3Controller);
+            eLFO3Sync.set_value(d->LFO3Sync);
+            break;
+        case 6: // "Misc"
+            eVelocityResponseCurve.set_value(d->VelocityResponseCurve);
+            eVelocityResponseDepth.set_value(d->VelocityResponseDepth);
+            eVelocityResponseCurveScaling.set_value(d->VelocityResponseCurveScaling);
+            eReleaseVelocityResponseCurve.set_value(d->ReleaseVelocityResponseCurve);
+            eReleaseVelocityResponseDepth.set_value(d->ReleaseVelocityResponseDepth);
+            eReleaseTriggerDecay.set_value(d->ReleaseTriggerDecay);
+            eSustainReleaseTrigger.set_value(d->SustainReleaseTrigger);
+            eNoNoteOffReleaseTrigger.set_value(d->NoNoteOffReleaseTrigger);
+            eDimensionBypass.set_value(d->DimensionBypass);
+            eSelfMask.set_value(d->SelfMask);
+            eSustainDefeat.set_value(d->SustainDefeat);
+            eMSDecode.set_value(d->MSDecode);
+            break;
     }
-    buttonSelectSample.set_sensitive(d && d->pSample);
-    eFineTune.set_value(d->FineTune);
-    eGain.set_value(d->Gain);
-    eGainPlus6.set_value(d->Gain);
-    eSampleLoopEnabled.set_value(d->SampleLoops);
-    eSampleLoopType.set_value(
-        d->SampleLoops ? d->pSampleLoops[0].LoopType : 0);
-    eSampleLoopStart.set_value(
-        d->SampleLoops ? d->pSampleLoops[0].LoopStart : 0);
-    eSampleLoopLength.set_value(
-        d->SampleLoops ? d->pSampleLoops[0].LoopLength : 0);
-    eSampleLoopInfinite.set_value(
-        d->pSample && d->pSample->LoopPlayCount == 0);
-    eSampleLoopPlayCount.set_value(
-        d->pSample ? d->pSample->LoopPlayCount : 0);
     update_model--;
-
-    wSample->set_text(d->pSample ? gig_to_utf8(d->pSample->pInfo->Name) :
-                      _("NULL"));
-
-    update_loop_elements();
-    VCFEnabled_toggled();
 }
 
 
@@ -1593,7 +1651,7 @@ void DimRegionEdit::loop_infinite_toggled() {
 bool DimRegionEdit::set_sample(gig::Sample* sample, bool copy_sample_unity, bool copy_sample_tune, bool copy_sample_loop)
 {
     bool result = false;
-    for (std::set<gig::DimensionRegion*>::iterator itDimReg = dimregs.begin();
+    for (DimRegionSet::iterator itDimReg = dimregs.begin();
          itDimReg != dimregs.end(); ++itDimReg)
     {
         result |= set_sample(*itDimReg, sample, copy_sample_unity, copy_sample_tune, copy_sample_loop);
@@ -1745,7 +1803,7 @@ void DimRegionEdit::set_LoopEnabled(gig::DimensionRegion* d, bool value)
     if (value) {
         // create a new sample loop in case there is none yet
         if (!d->SampleLoops) {
-            DimRegionChangeGuard(this, d);
+            DimRegionChangeGuard guard(this, d);
 
             DLS::sample_loop_t loop;
             loop.LoopType = gig::loop_type_normal;
@@ -1757,7 +1815,7 @@ void DimRegionEdit::set_LoopEnabled(gig::DimensionRegion* d, bool value)
         }
     } else {
         if (d->SampleLoops) {
-            DimRegionChangeGuard(this, d);
+            DimRegionChangeGuard guard(this, d);
 
             // delete ALL existing sample loops
             while (d->SampleLoops) {
@@ -1812,7 +1870,7 @@ void DimRegionEdit::nullOutSampleReference() {
     gig::Sample* oldref = dimregion->pSample;
     if (!oldref) return;
 
-    DimRegionChangeGuard(this, dimregion);
+    DimRegionChangeGuard guard(this, dimregion);
 
     // in case currently assigned sample is a stereo one, then remove both
     // references (expected to be due to a "stereo dimension")
@@ -109,7 +109,7 @@ public:
     sigc::signal<void, gig::Sample*/*old*/, gig::Sample*/*new*/>& signal_sample_ref_changed();
     sigc::signal<void, gig::Sample*>& signal_select_sample();
 
-    std::set<gig::DimensionRegion*> dimregs;
+    DimRegionSet dimregs;
 
 protected:
     sigc::signal<void, gig::DimensionRegion*> dimreg_to_be_changed_signal;
@@ -268,6 +268,10 @@ protected:
     void addRightHandSide(Gtk::Widget& widget);
     void nextPage();
 
+    bool page_outdated[7]; ///< Whether the respective page does not reflect the current dimension region yet.
+    void refresh_page(int page);
+    void on_page_switched(void* page, guint page_num);
+
     void VCFEnabled_toggled();
     void VCFCutoffController_changed();
     void VCFResonanceController_changed();
@@ -343,12 +347,17 @@ protected:
     void set_many(T value,
                   sigc::slot<void, DimRegionEdit*, gig::DimensionRegion*, T> setter) {
         if (update_model == 0) {
-            for (std::set<gig::DimensionRegion*>::iterator i = dimregs.begin() ;
+            // announce all changes before touching any dimregion, so that the
+            // sampler can apply them as one commit per region
+            for (DimRegionSet::iterator i = dimregs.begin() ;
+                 i != dimregs.end() ; ++i)
+                dimreg_to_be_changed_signal.emit(*i);
+            for (DimRegionSet::iterator i = dimregs.begin() ;
                  i != dimregs.end() ; ++i)
-            {
-                DimRegionChangeGuard(this, *i);
                 setter(this, *i, value);
-            }
+            for (DimRegionSet::iterator i = dimregs.begin() ;
+                 i != dimregs.end() ; ++i)
+                dimreg_changed_signal.emit(*i);
         }
     }
 
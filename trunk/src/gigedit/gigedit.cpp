@@ -31,6 +31,7 @@
 #include <gdkmm/region.h>
 #endif
 #include <glibmm/dispatcher.h>
+#include <glibmm/init.h>
 #include <glibmm/main.h>
 #include <glibmm/miscutils.h>
 #include <gtkmm/main.h>
@@ -45,9 +46,13 @@
 #endif
 
 #include "mainwindow.h"
+#include "ScriptChecker.h"
+#include "BatchRunner.h"
 
 #include "global.h"
 
+#include <fstream>
+
 #ifdef __APPLE__
 #include <dlfcn.h>
 #include <glibmm/fileutils.h>
@@ -107,6 +112,7 @@ private:
 #endif
     static Glib::Dispatcher* dispatcher;
     static GigEditState* current;
+    static MainWindow* warm_window;
 
     static void main_loop_run(Cond* intialized);
     static void open_window_static();
@@ -116,6 +122,7 @@ private:
     Cond close;
     Cond initialized;
     gig::Instrument* instrument;
+    std::vector<sigc::connection> connections;
 
     void open_window();
     void close_window();
@@ -256,55 +263,144 @@ void init_app_after_gtk_init() {
 #endif
 }
 
-void connect_signals(GigEdit* gigedit, MainWindow* mainwindow) {
+// startup time probe (see GigEdit::start_startup_probe())
+gint64 startup_probe_begin = 0;
+sigc::connection startup_probe_connection;
+
+void report_startup_probe() {
+    startup_probe_connection.disconnect();
+    if (startup_probe_begin) {
+        const gint64 elapsed = g_get_monotonic_time() - startup_probe_begin;
+        startup_probe_begin = 0;
+        printf("Startup probe: main window drawn after %.1f ms.\n",
+               double(elapsed) / 1000.0);
+        fflush(stdout);
+    }
+}
+
+#if (GTKMM_MAJOR_VERSION == 2 && GTKMM_MINOR_VERSION < 90) || GTKMM_MAJOR_VERSION < 2
+bool on_startup_probe_draw(GdkEventExpose* e) {
+    report_startup_probe();
+    return false; // let the window draw itself as usual
+}
+#elif GTKMM_MAJOR_VERSION > 3 || (GTKMM_MAJOR_VERSION == 3 && GTKMM_MINOR_VERSION > 24)
+// no draw signal on windows anymore with GTKMM 4, see connect_startup_probe()
+#else
+bool on_startup_probe_draw(const Cairo::RefPtr<Cairo::Context>& cr) {
+    report_startup_probe();
+    return false; // let the window draw itself as usual
+}
+#endif
+
+void connect_startup_probe(MainWindow* mainwindow) {
+    if (!startup_probe_begin) return;
+    startup_probe_connection.disconnect();
+#if (GTKMM_MAJOR_VERSION == 2 && GTKMM_MINOR_VERSION < 90) || GTKMM_MAJOR_VERSION < 2
+    startup_probe_connection = mainwindow->signal_expose_event().connect(
+        sigc::ptr_fun(&on_startup_probe_draw), false
+    );
+#elif GTKMM_MAJOR_VERSION > 3 || (GTKMM_MAJOR_VERSION == 3 && GTKMM_MINOR_VERSION > 24)
+    // no draw signal on windows anymore with GTKMM 4, so measure until the
+    // window gets mapped instead, which is right before its first frame
+    startup_probe_connection = mainwindow->signal_map().connect(
+        sigc::ptr_fun(&report_startup_probe)
+    );
+#else
+    startup_probe_connection = mainwindow->signal_draw().connect(
+        sigc::ptr_fun(&on_startup_probe_draw), false
+    );
+#endif
+}
+
+void connect_signals(GigEdit* gigedit, MainWindow* mainwindow,
+                     std::vector<sigc::connection>& connections)
+{
     // the signals of the "GigEdit" class are actually just proxies, that
     // is they simply forward the signals of the internal classes to the
     // outer world
-    mainwindow->signal_file_structure_to_be_changed().connect(
+    connections.push_back(mainwindow->signal_file_structure_to_be_changed().connect(
         gigedit->signal_file_structure_to_be_changed().make_slot()
-    );
-    mainwindow->signal_file_structure_changed().connect(
+    ));
+    connections.push_back(mainwindow->signal_file_structure_changed().connect(
         gigedit->signal_file_structure_changed().make_slot()
-    );
-    mainwindow->signal_samples_to_be_removed().connect(
+    ));
+    connections.push_back(mainwindow->signal_samples_to_be_removed().connect(
         gigedit->signal_samples_to_be_removed().make_slot()
-    );
-    mainwindow->signal_samples_removed().connect(
+    ));
+    connections.push_back(mainwindow->signal_samples_removed().connect(
         gigedit->signal_samples_removed().make_slot()
-    );
-    mainwindow->signal_region_to_be_changed().connect(
+    ));
+    connections.push_back(mainwindow->signal_region_to_be_changed().connect(
         gigedit->signal_region_to_be_changed().make_slot()
-    );
-    mainwindow->signal_region_changed().connect(
+    ));
+    connections.push_back(mainwindow->signal_region_changed().connect(
         gigedit->signal_region_changed().make_slot()
-    );
-    mainwindow->signal_dimreg_to_be_changed().connect(
+    ));
+    connections.push_back(mainwindow->signal_dimreg_to_be_changed().connect(
         gigedit->signal_dimreg_to_be_changed().make_slot()
-    );
-    mainwindow->signal_dimreg_changed().connect(
+    ));
+    connections.push_back(mainwindow->signal_dimreg_changed().connect(
         gigedit->signal_dimreg_changed().make_slot()
-    );
-    mainwindow->signal_sample_changed().connect(
+    ));
+    connections.push_back(mainwindow->signal_sample_changed().connect(
         gigedit->signal_sample_changed().make_slot()
-    );
-    mainwindow->signal_sample_ref_changed().connect(
+    ));
+    connections.push_back(mainwindow->signal_sample_ref_changed().connect(
         gigedit->signal_sample_ref_changed().make_slot()
-    );
-    mainwindow->signal_keyboard_key_hit().connect(
+    ));
+    connections.push_back(mainwindow->signal_keyboard_key_hit().connect(
         gigedit->signal_keyboard_key_hit().make_slot()
-    );
-    mainwindow->signal_keyboard_key_released().connect(
+    ));
+    connections.push_back(mainwindow->signal_keyboard_key_released().connect(
         gigedit->signal_keyboard_key_released().make_slot()
-    );
-    mainwindow->signal_switch_sampler_instrument().connect(
+    ));
+    connections.push_back(mainwindow->signal_switch_sampler_instrument().connect(
         gigedit->signal_switch_sampler_instrument().make_slot()
-    );
-    mainwindow->signal_script_to_be_changed.connect(
+    ));
+    connections.push_back(mainwindow->signal_script_to_be_changed.connect(
         gigedit->signal_script_to_be_changed.make_slot()
-    );
-    mainwindow->signal_script_changed.connect(
+    ));
+    connections.push_back(mainwindow->signal_script_changed.connect(
         gigedit->signal_script_changed.make_slot()
-    );
+    ));
+}
+
+// Implements the command line option "--check-scripts FILE": prints the
+// parser issues of all instrument scripts of the given .gig file to stdout
+// without opening any window. Returns 1 if any script has errors.
+int check_scripts(const char* filename) {
+#if USE_LS_SCRIPTVM
+    try {
+        RIFF::File riff(filename);
+        gig::File gig(&riff);
+        ScriptChecker checker;
+        const std::vector<ScriptChecker::Result> results = checker.check(&gig);
+        std::cout << ScriptChecker::report(results) << std::flush;
+        return ScriptChecker::errorCount(results) ? 1 : 0;
+    } catch (RIFF::Exception e) {
+        std::cerr << e.Message << std::endl;
+        return 2;
+    }
+#else
+    std::cerr << "Checking scripts requires gigedit to be compiled with "
+                 "liblinuxsampler support." << std::endl;
+    return 2;
+#endif
+}
+
+// Implements the command line option "--batch SCRIPT": executes the editing
+// commands of the given script file without opening any window (see
+// BatchRunner for the supported commands).
+int run_batch(const char* filename) {
+    std::ifstream script(filename);
+    if (!script) {
+        std::cerr << "Could not open batch script '" << filename << "'"
+                  << std::endl;
+        return 2;
+    }
+    Glib::init(); // required by Settings for stored macros
+    BatchRunner runner;
+    return runner.run(script);
 }
 
 } // namespace
@@ -313,9 +409,19 @@ GigEdit::GigEdit() {
     state = NULL;
 }
 
+void GigEdit::start_startup_probe() {
+    if (Glib::getenv("GIGEDIT_STARTUP_PROBE").empty()) return;
+    startup_probe_begin = g_get_monotonic_time();
+}
+
 int GigEdit::run(int argc, char* argv[]) {
     init_app();
 
+    if (argc >= 3 && !strcmp(argv[1], "--check-scripts"))
+        return check_scripts(argv[2]);
+    if (argc >= 3 && !strcmp(argv[1], "--batch"))
+        return run_batch(argv[2]);
+
 #if GTKMM_MAJOR_VERSION < 3 || (GTKMM_MAJOR_VERSION == 3 && (GTKMM_MINOR_VERSION < 89 || (GTKMM_MINOR_VERSION == 89 && GTKMM_MICRO_VERSION < 4))) // GTKMM < 3.89.4
     Gtk::Main kit(argc, argv);
 #else
@@ -325,7 +431,9 @@ int GigEdit::run(int argc, char* argv[]) {
     init_app_after_gtk_init();
 
     MainWindow window;
-    connect_signals(this, &window);
+    std::vector<sigc::connection> connections;
+    connect_signals(this, &window, connections);
+    connect_startup_probe(&window);
     if (argc >= 2) window.load_file(argv[1]);
 #if GTKMM_MAJOR_VERSION < 3 || (GTKMM_MAJOR_VERSION == 3 && (GTKMM_MINOR_VERSION < 89 || (GTKMM_MINOR_VERSION == 89 && GTKMM_MICRO_VERSION < 4))) // GTKMM < 3.89.4
     kit.run(window);
@@ -358,6 +466,12 @@ void GigEdit::on_note_off_event(int key, int velocity) {
     state->window->signal_note_off().emit(key, velocity);
 }
 
+void GigEdit::set_lock_stats(const std::string& summary, const std::string& details) {
+    if (!this->state) return;
+    GigEditState* state = static_cast<GigEditState*>(this->state);
+    state->window->set_lock_stats(summary, details);
+}
+
 sigc::signal<void, gig::File*>& GigEdit::signal_file_structure_to_be_changed() {
     return file_structure_to_be_changed_signal;
 }
@@ -417,6 +531,7 @@ Glib::Threads::Mutex GigEditState::mutex;
 #endif
 Glib::Dispatcher* GigEditState::dispatcher = 0;
 GigEditState* GigEditState::current = 0;
+MainWindow* GigEditState::warm_window = 0;
 
 void GigEditState::open_window_static() {
     GigEditState* c = GigEditState::current;
@@ -425,18 +540,40 @@ void GigEditState::open_window_static() {
 }
 
 void GigEditState::open_window() {
-    window = new MainWindow();
+    if (warm_window) {
+        // reuse the window kept from the previous editor session
+        window = warm_window;
+        warm_window = 0;
+    } else {
+        window = new MainWindow();
+    }
 
-    connect_signals(parent, window);
+    connect_signals(parent, window, connections);
+    connect_startup_probe(window);
     if (instrument) window->load_instrument(instrument);
 
-    window->signal_hide().connect(sigc::mem_fun(this,
-                                                &GigEditState::close_window));
+    connections.push_back(
+        window->signal_hide().connect(sigc::mem_fun(this,
+                                                    &GigEditState::close_window))
+    );
     window->present();
 }
 
 void GigEditState::close_window() {
-    delete window;
+    // the GigEdit instance of this session will be gone soon, so disconnect
+    // here on the GUI thread instead of relying on sigc::trackable
+    for (int i = 0; i < connections.size(); ++i)
+        connections[i].disconnect();
+    connections.clear();
+
+    if (Settings::singleton()->keepPluginWindow) {
+        // only hide the window, so the next session can show it instantly
+        window->prepare_for_reuse();
+        warm_window = window;
+    } else {
+        delete window;
+    }
+    Settings::singleton()->flush();
     close.signal();
 }
 
@@ -548,6 +685,7 @@ void GigEditState::run(gig::Instrument* pInstrument) {
         main_loop_started = true;
     }
     current = this;
+    GigEdit::start_startup_probe();
     dispatcher->emit();
     open.wait(); // wait until the GUI thread has read current
     mutex.unlock();
@@ -27,6 +27,7 @@
 #endif
 
 #include <list>
+#include <string>
 #include <cstddef>
 #ifdef SIGCPP_HEADER_FILE
 # include SIGCPP_HEADER_FILE(signal.h)
@@ -41,6 +42,13 @@ public:
     int run(int argc, char* argv[]);
     int run(gig::Instrument* pInstrument);
 
+    /**
+     * Starts measuring the time until the main window is drawn for the
+     * first time. The measured time is printed to stdout, but only if the
+     * environment variable GIGEDIT_STARTUP_PROBE is set.
+     */
+    static void start_startup_probe();
+
     sigc::signal<void, gig::File*>& signal_file_structure_to_be_changed();
     sigc::signal<void, gig::File*>& signal_file_structure_changed();
     sigc::signal<void, std::list<gig::Sample*> >& signal_samples_to_be_removed();
@@ -61,6 +69,15 @@ public:
     void on_note_on_event(int key, int velocity);
     void on_note_off_event(int key, int velocity);
 
+    /**
+     * Shows statistics about how long the sampler was blocked by changes
+     * made with gigedit in the main window's status bar.
+     *
+     * @param summary - short text shown in the status bar
+     * @param details - more verbose text shown as tooltip
+     */
+    void set_lock_stats(const std::string& summary, const std::string& details);
+
 private:
     sigc::signal<void, gig::File*> file_structure_to_be_changed_signal;
     sigc::signal<void, gig::File*> file_structure_changed_signal;
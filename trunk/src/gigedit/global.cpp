@@ -0,0 +1,103 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+#include "global.h"
+
+#include <stdio.h>
+
+// Helpers declared in global.h which are shared by the GUI and the GUI-free
+// parts of gigedit (e.g. for reports of the batch mode).
+
+const char* noteNames[12] = {
+    _("C"), _("C#"), _("D"), _("D#"), _("E"), _("F"),_("F#"),
+    _("G"), _("G#"), _("A"), _("A#"), _("B")
+};
+
+Glib::ustring note_str(int note)
+{
+    char buf[10];
+    sprintf(buf, "%s%d", noteNames[note % 12], note / 12 - 1);
+    return buf;
+}
+
+// returns a human readable name of the given dimension type
+Glib::ustring dimTypeAsString(gig::dimension_t d) {
+    char buf[32];
+    switch (d) {
+        case gig::dimension_none:
+            return _("None");
+        case gig::dimension_samplechannel:
+            return _("Sample Channel");
+        case gig::dimension_layer:
+            return _("Layer");
+        case gig::dimension_velocity:
+            return _("Velocity");
+        case gig::dimension_channelaftertouch:
+            return _("Aftertouch");
+        case gig::dimension_releasetrigger:
+            return _("Release Trigger");
+        case gig::dimension_keyboard:
+            return _("Keyswitching");
+        case gig::dimension_roundrobin:
+            return _("Round Robin");
+        case gig::dimension_random:
+            return _("Random Generator");
+        case gig::dimension_smartmidi:
+            return _("Smart MIDI");
+        case gig::dimension_roundrobinkeyboard:
+            return _("Keyboard Round Robin");
+        case gig::dimension_modwheel:
+            return _("Modulation Wheel");
+        case gig::dimension_breath:
+            return _("Breath Ctrl.");
+        case gig::dimension_foot:
+            return _("Foot Ctrl.");
+        case gig::dimension_portamentotime:
+            return _("Portamento Time Ctrl.");
+        case gig::dimension_effect1:
+            return _("Effect Ctrl. 1");
+        case gig::dimension_effect2:
+            return _("Effect Ctrl. 2");
+        case gig::dimension_genpurpose1:
+            return _("General Purpose Ctrl. 1");
+        case gig::dimension_genpurpose2:
+            return _("General Purpose Ctrl. 2");
+        case gig::dimension_genpurpose3:
+            return _("General Purpose Ctrl. 3");
+        case gig::dimension_genpurpose4:
+            return _("General Purpose Ctrl. 4");
+        case gig::dimension_sustainpedal:
+            return _("Sustain Pedal");
+        case gig::dimension_portamento:
+            return _("Portamento Ctrl.");
+        case gig::dimension_sostenutopedal:
+            return _("Sostenuto Pedal");
+        case gig::dimension_softpedal:
+            return _("Soft Pedal");
+        case gig::dimension_genpurpose5:
+            return _("General Purpose Ctrl. 5");
+        case gig::dimension_genpurpose6:
+            return _("General Purpose Ctrl. 6");
+        case gig::dimension_genpurpose7:
+            return _("General Purpose Ctrl. 7");
+        case gig::dimension_genpurpose8:
+            return _("General Purpose Ctrl. 8");
+        case gig::dimension_effect1depth:
+            return _("Effect 1 Depth");
+        case gig::dimension_effect2depth:
+            return _("Effect 2 Depth");
+        case gig::dimension_effect3depth:
+            return _("Effect 3 Depth");
+        case gig::dimension_effect4depth:
+            return _("Effect 4 Depth");
+        case gig::dimension_effect5depth:
+            return _("Effect 5 Depth");
+        default:
+            sprintf(buf, "Unknown Type (0x%x) !!!", d);
+            return buf;
+    }
+}
@@ -37,6 +37,15 @@
 #if (GLIBMM_MAJOR_VERSION == 2 && GLIBMM_MINOR_VERSION == 31 && GLIBMM_MICRO_VERSION >= 2) || \
     (GLIBMM_MAJOR_VERSION == 2 && GLIBMM_MINOR_VERSION > 31) || GLIBMM_MAJOR_VERSION > 2
 #include <glibmm/threads.h>
+#else // glibmm < 2.31.2
+namespace Glib {
+    namespace Threads {
+        using Glib::Thread;
+        using Glib::Mutex;
+        using Glib::Cond;
+    }
+}
+#define OLD_THREADS
 #endif
 
 #if !defined(WIN32)
@@ -46,6 +55,7 @@
 
 #include <sstream>
 #include <map>
+#include <vector>
 
 #ifdef LIBGIG_HEADER_FILE
 # include LIBGIG_HEADER_FILE(gig.h)
@@ -272,6 +282,74 @@ inline gig::DimensionRegion* dimensionRegionMatching(const DimensionCase& dimCas
     return NULL;
 }
 
+struct RegionFeatures {
+    int sampleRefs;
+    int loops;
+    int validDimRegs;
+
+    RegionFeatures() {
+        sampleRefs = loops = validDimRegs = 0;
+    }
+};
+
+inline RegionFeatures regionFeatures(gig::Region* rgn) {
+    RegionFeatures f;
+    for (int i = 0; i < rgn->DimensionRegions; ++i) {
+        gig::DimensionRegion* dr = rgn->pDimensionRegions[i];
+        DimensionCase c = dimensionCaseOf(dr);
+        if (!isUsedCase(c, rgn)) continue;
+        f.validDimRegs++;
+        if (dr->pSample) f.sampleRefs++;
+        // the user doesn't care about loop if there is no valid sample reference
+        if (dr->pSample && dr->SampleLoops) f.loops++;
+    }
+    return f;
+}
+
+/// Counts how many dimension regions of all instruments use each sample.
+inline void countSampleRefs(gig::File* gig, std::map<gig::Sample*,int>& refCount) {
+    refCount.clear();
+    if (!gig) return;
+    for (gig::Instrument* instrument = gig->GetFirstInstrument(); instrument;
+         instrument = gig->GetNextInstrument())
+    {
+        for (gig::Region* rgn = instrument->GetFirstRegion(); rgn;
+             rgn = instrument->GetNextRegion())
+        {
+            for (int i = 0; i < 256; ++i) {
+                if (!rgn->pDimensionRegions[i]) continue;
+                if (rgn->pDimensionRegions[i]->pSample) {
+                    refCount[rgn->pDimensionRegions[i]->pSample]++;
+                }
+            }
+        }
+    }
+}
+
+// implemented in global.cpp
+extern const char* noteNames[12];
+Glib::ustring note_str(int note);
+Glib::ustring dimTypeAsString(gig::dimension_t d);
+
+/**
+ * Flat set of dimension regions, kept as sorted vector. Compared to a
+ * std::set it does not allocate a node per element, and clear() keeps the
+ * already allocated memory, so refilling it on every selection change is
+ * cheap. Elements may be appended unsorted, but normalize() must be called
+ * afterwards before contains() may be used.
+ */
+class DimRegionSet : public std::vector<gig::DimensionRegion*> {
+public:
+    void normalize() {
+        std::sort(begin(), end());
+        erase(std::unique(begin(), end()), end());
+    }
+
+    bool contains(gig::DimensionRegion* dr) const {
+        return std::binary_search(begin(), end(), dr);
+    }
+};
+
 template<typename T_Message>
 class SignalGuard {
 public:
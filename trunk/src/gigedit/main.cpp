@@ -62,14 +62,23 @@ static void enforceGtk3Settings(int argc, char* argv[]) {
 
 #endif // GTKM 3
 
+// command line options which don't open any window (see GigEdit::run())
+static bool isHeadless(int argc, char* argv[]) {
+    return argc >= 3 && (!strcmp(argv[1], "--check-scripts") ||
+                         !strcmp(argv[1], "--batch"));
+}
+
 #if defined(WIN32)
 #include <windows.h>
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
     LPSTR lpCmdLine, int nCmdShow)
 {
+    GigEdit::start_startup_probe();
+
     #if GTKMM_MAJOR_VERSION >= 3
-    enforceGtk3Settings(__argc, __argv);
+    if (!isHeadless(__argc, __argv))
+        enforceGtk3Settings(__argc, __argv);
     #endif
 
     GigEdit app;
@@ -80,8 +89,11 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
 
 int main(int argc, char* argv[])
 {
+    GigEdit::start_startup_probe();
+
     #if GTKMM_MAJOR_VERSION >= 3
-    enforceGtk3Settings(argc, argv);
+    if (!isHeadless(argc, argv))
+        enforceGtk3Settings(argc, argv);
     #endif
 
 #ifdef __APPLE__
@@ -66,6 +66,11 @@
 #include "scripteditor.h"
 #include "scriptslots.h"
 #include "ReferencesView.h"
+#include "ScriptChecker.h"
+#include "DimensionOptimizer.h"
+#include "DimRegionPatch.h"
+#include "SampleImporter.h"
+#include "GigMerger.h"
 #include "../../gfx/status_attached.xpm"
 #include "../../gfx/status_detached.xpm"
 #include "gfx/builtinpix.h"
@@ -97,6 +102,13 @@ MainWindow::MainWindow() :
     loadBuiltInPix();
 
     this->file = NULL;
+    propDialog = NULL;
+    instrumentProps = NULL;
+    midiRules = NULL;
+    kept_file = NULL;
+    merger = NULL;
+    sample_hasher = NULL;
+    sample_hasher_dialog = NULL;
 
 //    set_border_width(5);
 
@@ -559,6 +571,14 @@ MainWindow::MainWindow() :
         "MoveRootNoteWithRegionMoved", sigc::mem_fun(*this, &MainWindow::on_action_move_root_note_with_region_moved),
         Settings::singleton()->moveRootNoteWithRegionMoved
     );
+    m_actionToggleKeepPluginWindow = m_actionGroup->add_action_bool(
+        "KeepPluginWindow", sigc::mem_fun(*this, &MainWindow::on_action_keep_plugin_window),
+        Settings::singleton()->keepPluginWindow
+    );
+    m_actionToggleCommitLiveEdits = m_actionGroup->add_action_bool(
+        "CommitLiveEditsInstantly", sigc::mem_fun(*this, &MainWindow::on_action_commit_live_edits_instantly),
+        Settings::singleton()->commitLiveEditsInstantly
+    );
 #else
     actionGroup->add(Gtk::Action::create("MenuSettings", _("_Settings")));
     
@@ -585,6 +605,22 @@ MainWindow::MainWindow() :
         toggle_action,
         sigc::mem_fun(*this, &MainWindow::on_action_move_root_note_with_region_moved)
     );
+
+    toggle_action =
+        Gtk::ToggleAction::create("KeepPluginWindow", _("Keep window in live-mode"));
+    toggle_action->set_active(Settings::singleton()->keepPluginWindow);
+    actionGroup->add(
+        toggle_action,
+        sigc::mem_fun(*this, &MainWindow::on_action_keep_plugin_window)
+    );
+
+    toggle_action =
+        Gtk::ToggleAction::create("CommitLiveEditsInstantly", _("Commit changes instantly in live-mode"));
+    toggle_action->set_active(Settings::singleton()->commitLiveEditsInstantly);
+    actionGroup->add(
+        toggle_action,
+        sigc::mem_fun(*this, &MainWindow::on_action_commit_live_edits_instantly)
+    );
 #endif
 
 #if USE_GLIB_ACTION
@@ -594,6 +630,12 @@ MainWindow::MainWindow() :
     m_actionGroup->add_action(
         "MergeFiles", sigc::mem_fun(*this, &MainWindow::on_action_merge_files)
     );
+    m_actionGroup->add_action(
+        "CheckAllScripts", sigc::mem_fun(*this, &MainWindow::on_action_check_all_scripts)
+    );
+    m_actionGroup->add_action(
+        "RemoveRedundantDimensions", sigc::mem_fun(*this, &MainWindow::on_action_remove_redundant_dimensions)
+    );
 #else
     actionGroup->add(Gtk::Action::create("MenuTools", _("_Tools")));
 
@@ -606,6 +648,16 @@ MainWindow::MainWindow() :
         Gtk::Action::create("MergeFiles", _("_Merge Files...")),
         sigc::mem_fun(*this, &MainWindow::on_action_merge_files)
     );
+
+    actionGroup->add(
+        Gtk::Action::create("CheckAllScripts", _("Check All _Scripts...")),
+        sigc::mem_fun(*this, &MainWindow::on_action_check_all_scripts)
+    );
+
+    actionGroup->add(
+        Gtk::Action::create("RemoveRedundantDimensions", _("Remove Redundant _Dimensions...")),
+        sigc::mem_fun(*this, &MainWindow::on_action_remove_redundant_dimensions)
+    );
 #endif
 
     // sample right-click popup actions
@@ -625,6 +677,9 @@ MainWindow::MainWindow() :
     m_actionGroup->add_action(
         "RemoveUnusedSamples", sigc::mem_fun(*this, &MainWindow::on_action_remove_unused_samples)
     );
+    m_actionGroup->add_action(
+        "RemoveDuplicateSamples", sigc::mem_fun(*this, &MainWindow::on_action_remove_duplicate_samples)
+    );
     m_actionViewSampleRefs = m_actionGroup->add_action(
         "ShowSampleRefs", sigc::mem_fun(*this, &MainWindow::on_action_view_references)
     );
@@ -655,6 +710,10 @@ MainWindow::MainWindow() :
         Gtk::Action::create("RemoveUnusedSamples", _("Remove _Unused Samples")),
         sigc::mem_fun(*this, &MainWindow::on_action_remove_unused_samples)
     );
+    actionGroup->add(
+        Gtk::Action::create("RemoveDuplicateSamples", _("Remove _Duplicate Samples")),
+        sigc::mem_fun(*this, &MainWindow::on_action_remove_duplicate_samples)
+    );
     actionGroup->add(
         Gtk::Action::create("ShowSampleRefs", _("Show References...")),
         sigc::mem_fun(*this, &MainWindow::on_action_view_references)
@@ -861,6 +920,10 @@ MainWindow::MainWindow() :
         "          <attribute name='label' translatable='yes'>Remove unused Samples</attribute>"
         "          <attribute name='action'>AppMenu.RemoveUnusedSamples</attribute>"
         "        </item>"
+        "        <item id='RemoveDuplicateSamples'>"
+        "          <attribute name='label' translatable='yes'>Remove duplicate Samples</attribute>"
+        "          <attribute name='action'>AppMenu.RemoveDuplicateSamples</attribute>"
+        "        </item>"
         "      </section>"
         "    </menu>"
         "    <menu id='MenuInstrument'>"
@@ -960,6 +1023,14 @@ MainWindow::MainWindow() :
         "          <attribute name='label' translatable='yes'>Merge Files ...</attribute>"
         "          <attribute name='action'>AppMenu.MergeFiles</attribute>"
         "        </item>"
+        "        <item id='CheckAllScripts'>"
+        "          <attribute name='label' translatable='yes'>Check All Scripts ...</attribute>"
+        "          <attribute name='action'>AppMenu.CheckAllScripts</attribute>"
+        "        </item>"
+        "        <item id='RemoveRedundantDimensions'>"
+        "          <attribute name='label' translatable='yes'>Remove Redundant Dimensions ...</attribute>"
+        "          <attribute name='action'>AppMenu.RemoveRedundantDimensions</attribute>"
+        "        </item>"
         "      </section>"
         "    </menu>"
         "    <menu id='MenuSettings'>"
@@ -977,6 +1048,14 @@ MainWindow::MainWindow() :
         "          <attribute name='label' translatable='yes'>Move Root Note with Region moved</attribute>"
         "          <attribute name='action'>AppMenu.MoveRootNoteWithRegionMoved</attribute>"
         "        </item>"
+        "        <item id='KeepPluginWindow'>"
+        "          <attribute name='label' translatable='yes'>Keep Window in Live-Mode</attribute>"
+        "          <attribute name='action'>AppMenu.KeepPluginWindow</attribute>"
+        "        </item>"
+        "        <item id='CommitLiveEditsInstantly'>"
+        "          <attribute name='label' translatable='yes'>Commit Changes Instantly in Live-Mode</attribute>"
+        "          <attribute name='action'>AppMenu.CommitLiveEditsInstantly</attribute>"
+        "        </item>"
         "        <item id='SaveWithTemporaryFile'>"
         "          <attribute name='label' translatable='yes'>Save with temporary file</attribute>"
         "          <attribute name='action'>AppMenu.SaveWithTemporaryFile</attribute>"
@@ -1064,6 +1143,10 @@ MainWindow::MainWindow() :
         "        <attribute name='label' translatable='yes'>Remove unused Samples</attribute>"
         "        <attribute name='action'>AppMenu.RemoveUnusedSamples</attribute>"
         "      </item>"
+        "      <item id='RemoveDuplicateSamples'>"
+        "        <attribute name='label' translatable='yes'>Remove duplicate Samples</attribute>"
+        "        <attribute name='action'>AppMenu.RemoveDuplicateSamples</attribute>"
+        "      </item>"
         "    </section>"
         "  </menu>"
         "  <menu id='ScriptPopupMenu'>"
@@ -1143,6 +1226,7 @@ MainWindow::MainWindow() :
         "      <separator/>"
         "      <menuitem action='RemoveSample'/>"
         "      <menuitem action='RemoveUnusedSamples'/>"
+        "      <menuitem action='RemoveDuplicateSamples'/>"
         "    </menu>"
         "    <menu action='MenuInstrument'>"
         "      <menu action='AllInstruments'>"
@@ -1175,11 +1259,15 @@ MainWindow::MainWindow() :
         "    <menu action='MenuTools'>"
         "      <menuitem action='CombineInstruments'/>"
         "      <menuitem action='MergeFiles'/>"
+        "      <menuitem action='CheckAllScripts'/>"
+        "      <menuitem action='RemoveRedundantDimensions'/>"
         "    </menu>"
         "    <menu action='MenuSettings'>"
         "      <menuitem action='WarnUserOnExtensions'/>"
         "      <menuitem action='SyncSamplerInstrumentSelection'/>"
         "      <menuitem action='MoveRootNoteWithRegionMoved'/>"
+        "      <menuitem action='KeepPluginWindow'/>"
+        "      <menuitem action='CommitLiveEditsInstantly'/>"
         "      <menuitem action='SaveWithTemporaryFile'/>"
         "    </menu>"
         "    <menu action='MenuHelp'>"
@@ -1206,6 +1294,7 @@ MainWindow::MainWindow() :
         "    <separator/>"
         "    <menuitem action='RemoveSample'/>"
         "    <menuitem action='RemoveUnusedSamples'/>"
+        "    <menuitem action='RemoveDuplicateSamples'/>"
         "  </popup>"
         "  <popup name='ScriptPopupMenu'>"
         "    <menuitem action='AddScriptGroup'/>"
@@ -1266,11 +1355,21 @@ MainWindow::MainWindow() :
             uiManager->get_widget("/MenuBar/MenuSettings/SyncSamplerInstrumentSelection"));
         item->set_tooltip_text(_("If checked, the sampler's current instrument will automatically be switched whenever another instrument was selected in gigedit (only available in live-mode)."));
     }
+    {
+        Gtk::MenuItem* item = dynamic_cast<Gtk::MenuItem*>(
+            uiManager->get_widget("/MenuBar/MenuSettings/CommitLiveEditsInstantly"));
+        item->set_tooltip_text(_("If checked, each change of a dimension region is committed to the sampler immediately, so the affected region is only blocked for a very short moment. Otherwise the region stays blocked for playback until you stopped editing (only available in live-mode)."));
+    }
     {
         Gtk::MenuItem* item = dynamic_cast<Gtk::MenuItem*>(
             uiManager->get_widget("/MenuBar/MenuSettings/MoveRootNoteWithRegionMoved"));
         item->set_tooltip_text(_("If checked, and when a region is moved by dragging it around on the virtual keyboard, the keyboard position dependent pitch will move exactly with the amount of semi tones the region was moved around."));
     }
+    {
+        Gtk::MenuItem* item = dynamic_cast<Gtk::MenuItem*>(
+            uiManager->get_widget("/MenuBar/MenuSettings/KeepPluginWindow"));
+        item->set_tooltip_text(_("If checked, closing gigedit in live-mode only hides its window, so that it opens much faster the next time you edit an instrument from the sampler (only available in live-mode)."));
+    }
     {
         Gtk::MenuItem* item = dynamic_cast<Gtk::MenuItem*>(
             uiManager->get_widget("/MenuBar/MenuSample/RemoveUnusedSamples"));
@@ -1280,6 +1379,15 @@ MainWindow::MainWindow() :
             uiManager->get_widget("/SamplePopupMenu/RemoveUnusedSamples"));
         item2->set_tooltip_text(item->get_tooltip_text());
     }
+    {
+        Gtk::MenuItem* item = dynamic_cast<Gtk::MenuItem*>(
+            uiManager->get_widget("/MenuBar/MenuSample/RemoveDuplicateSamples"));
+        item->set_tooltip_text(_("Removes all samples with exactly the same sample data as another sample, all references to them are redirected to the sample being kept."));
+        // copy tooltip to popup menu
+        Gtk::MenuItem* item2 = dynamic_cast<Gtk::MenuItem*>(
+            uiManager->get_widget("/SamplePopupMenu/RemoveDuplicateSamples"));
+        item2->set_tooltip_text(item->get_tooltip_text());
+    }
     {
         Gtk::MenuItem* item = dynamic_cast<Gtk::MenuItem*>(
             uiManager->get_widget("/MenuBar/MenuView/RefreshAll"));
@@ -1300,6 +1408,16 @@ MainWindow::MainWindow() :
             uiManager->get_widget("/MenuBar/MenuTools/MergeFiles"));
         item->set_tooltip_text(_("Add instruments and samples of other .gig files to this .gig file."));
     }
+    {
+        Gtk::MenuItem* item = dynamic_cast<Gtk::MenuItem*>(
+            uiManager->get_widget("/MenuBar/MenuTools/CheckAllScripts"));
+        item->set_tooltip_text(_("Check all instrument scripts of this .gig file for errors and warnings."));
+    }
+    {
+        Gtk::MenuItem* item = dynamic_cast<Gtk::MenuItem*>(
+            uiManager->get_widget("/MenuBar/MenuTools/RemoveRedundantDimensions"));
+        item->set_tooltip_text(_("Remove dimensions and merge dimension zones of all regions which lead to identical dimension regions."));
+    }
 #endif
 
 #if USE_GTKMM_BUILDER
@@ -1336,6 +1454,7 @@ MainWindow::MainWindow() :
 #if USE_GTKMM_BOX
 # warning No status bar layout for GTKMM 4 yet
 #else
+    m_StatusBar.pack_start(m_LockStatsLabel, Gtk::PACK_SHRINK);
     m_StatusBar.pack_start(m_AttachedStateLabel, Gtk::PACK_SHRINK);
     m_StatusBar.pack_start(m_AttachedStateImage, Gtk::PACK_SHRINK);
 #endif
@@ -1488,12 +1607,8 @@ MainWindow::MainWindow() :
         sigc::mem_fun(*this, &MainWindow::region_changed));
     m_DimRegionChooser.signal_region_changed().connect(
         sigc::mem_fun(*this, &MainWindow::file_changed));
-    instrumentProps.signal_changed().connect(
-        sigc::mem_fun(*this, &MainWindow::file_changed));
-    propDialog.signal_changed().connect(
-        sigc::mem_fun(*this, &MainWindow::file_changed));
-    midiRules.signal_changed().connect(
-        sigc::mem_fun(*this, &MainWindow::file_changed));
+    m_DimRegionChooser.signal_region_changed().connect(
+        sigc::mem_fun(m_RegionChooser, &RegionChooser::on_dimensions_changed));
 
     dimreg_edit.signal_dimreg_to_be_changed().connect(
         dimreg_to_be_changed_signal.make_slot());
@@ -1528,6 +1643,31 @@ MainWindow::MainWindow() :
             )
         )
     );
+    // regions might have been deleted, don't keep their cached layouts (the
+    // region chooser deletes regions with instrument structure changes,
+    // other file structure changes i.e. come from merging files or macros)
+    m_RegionChooser.signal_instrument_struct_changed().connect(
+        sigc::hide(
+            sigc::mem_fun(m_DimRegionChooser, &DimRegionChooser::clear_layout_cache)
+        )
+    );
+    file_structure_changed_signal.connect(
+        sigc::hide(
+            sigc::mem_fun(m_DimRegionChooser, &DimRegionChooser::clear_layout_cache)
+        )
+    );
+    // same for the dimension stats cached by the dimension manager (also
+    // emitted for instrument structure changes, see above)
+    file_structure_changed_signal.connect(
+        sigc::hide(
+            sigc::mem_fun(m_RegionChooser, &RegionChooser::invalidate_dimension_stats)
+        )
+    );
+    region_changed_signal.connect(
+        sigc::hide(
+            sigc::mem_fun(m_RegionChooser, &RegionChooser::invalidate_dimension_stats)
+        )
+    );
     m_RegionChooser.signal_region_to_be_changed().connect(
         region_to_be_changed_signal.make_slot());
     m_RegionChooser.signal_region_changed_signal().connect(
@@ -1652,6 +1792,47 @@ MainWindow::MainWindow() :
 
 MainWindow::~MainWindow()
 {
+    if (propDialog) delete propDialog;
+    if (instrumentProps) delete instrumentProps;
+    if (midiRules) delete midiRules;
+    if (merger) delete merger;
+    if (sample_hasher) delete sample_hasher;
+    if (sample_hasher_dialog) delete sample_hasher_dialog;
+    Settings::singleton()->flush();
+}
+
+PropDialog& MainWindow::prop_dialog()
+{
+    if (!propDialog) {
+        propDialog = new PropDialog;
+        propDialog->signal_changed().connect(
+            sigc::mem_fun(*this, &MainWindow::file_changed));
+        if (file) {
+            propDialog->set_file(file);
+            propDialog->set_info(file->pInfo);
+        }
+    }
+    return *propDialog;
+}
+
+InstrumentProps& MainWindow::instrument_props()
+{
+    if (!instrumentProps) {
+        instrumentProps = new InstrumentProps;
+        instrumentProps->signal_changed().connect(
+            sigc::mem_fun(*this, &MainWindow::file_changed));
+    }
+    return *instrumentProps;
+}
+
+MidiRules& MainWindow::midi_rules()
+{
+    if (!midiRules) {
+        midiRules = new MidiRules;
+        midiRules->signal_changed().connect(
+            sigc::mem_fun(*this, &MainWindow::file_changed));
+    }
+    return *midiRules;
 }
 
 void MainWindow::bringToFront() {
@@ -1679,9 +1860,9 @@ void MainWindow::updateMacroMenu() {
         }
     }
 
-    // (re)load all macros from config file
+    // (re)load the index of all macros (macros are only decoded when used)
     try {
-        Settings::singleton()->loadMacros(m_macros);
+        Settings::singleton()->loadMacroIndex(m_macroIndex);
     } catch (Serialization::Exception e) {
         std::cerr << "Exception while loading macros: " << e.Message << std::endl;
     } catch (...) {
@@ -1689,11 +1870,11 @@ void MainWindow::updateMacroMenu() {
     }
 
     // add all configured macros as menu items to the "Macro" menu
-    for (int iMacro = 0; iMacro < m_macros.size(); ++iMacro) {
-        const Serialization::Archive& macro = m_macros[iMacro];
+    for (int iMacro = 0; iMacro < m_macroIndex.size(); ++iMacro) {
+        const Settings::MacroInfo& macro = m_macroIndex[iMacro];
         std::string name =
-            macro.name().empty() ?
-                (std::string(_("Unnamed Macro")) + " " + ToString(iMacro+1)) : macro.name();
+            macro.name.empty() ?
+                (std::string(_("Unnamed Macro")) + " " + ToString(iMacro+1)) : macro.name;
         Gtk::MenuItem* item = new Gtk::MenuItem(name);
         item->signal_activate().connect(
             sigc::bind(
@@ -1702,12 +1883,12 @@ void MainWindow::updateMacroMenu() {
         );
         menuMacro->append(*item);
         item->set_accel_path("<Macros>/macro_" + ToString(iMacro));
-        Glib::ustring comment = macro.comment();
+        Glib::ustring comment = macro.comment;
         if (!comment.empty())
             item->set_tooltip_text(comment);
     }
     // if there are no macros configured at all, then show a dummy entry instead
-    if (m_macros.empty()) {
+    if (m_macroIndex.empty()) {
         Gtk::MenuItem* item = new Gtk::MenuItem(_("No Macros"));
         item->set_sensitive(false);
         menuMacro->append(*item);
@@ -1732,10 +1913,12 @@ void MainWindow::updateMacroMenu() {
 
 void MainWindow::onMacroSelected(int iMacro) {
     printf("onMacroSelected(%d)\n", iMacro);
-    if (iMacro < 0 || iMacro >= m_macros.size()) return;
+    if (iMacro < 0 || iMacro >= m_macroIndex.size()) return;
     Glib::ustring errorText;
     try {
-        applyMacro(m_macros[iMacro]);
+        Serialization::Archive macro;
+        Settings::singleton()->loadMacro(m_macroIndex[iMacro], macro);
+        applyMacro(macro);
     } catch (Serialization::Exception e) {
         errorText = e.Message;
     } catch (...) {
@@ -1749,9 +1932,18 @@ void MainWindow::onMacroSelected(int iMacro) {
 }
 
 void MainWindow::setupMacros() {
+    std::vector<Serialization::Archive> macros;
+    try {
+        Settings::singleton()->loadMacros(macros);
+    } catch (Serialization::Exception e) {
+        Glib::ustring txt = _("Loading macros failed:\n") + e.Message;
+        Gtk::MessageDialog msg(*this, txt, false, Gtk::MESSAGE_ERROR);
+        msg.run();
+        return;
+    }
     MacrosSetup* setup = new MacrosSetup();
     gig::DimensionRegion* pDimRgn = m_DimRegionChooser.get_main_dimregion();
-    setup->setMacros(m_macros, &m_serializationArchive, pDimRgn);
+    setup->setMacros(macros, &m_serializationArchive, pDimRgn);
     setup->signal_macros_changed().connect(
         sigc::mem_fun(*this, &MainWindow::onMacrosSetupChanged)
     );
@@ -1759,8 +1951,7 @@ void MainWindow::setupMacros() {
 }
 
 void MainWindow::onMacrosSetupChanged(const std::vector<Serialization::Archive>& macros) {
-    m_macros = macros;
-    Settings::singleton()->saveMacros(m_macros);
+    Settings::singleton()->saveMacros(macros);
     updateMacroMenu();
 }
 
@@ -1805,11 +1996,7 @@ gig::Instrument* MainWindow::get_instrument()
 void MainWindow::add_region_to_dimregs(gig::Region* region, bool stereo, bool all_dimregs)
 {
     if (all_dimregs) {
-        for (int i = 0 ; i < region->DimensionRegions ; i++) {
-            if (region->pDimensionRegions[i]) {
-                dimreg_edit.dimregs.insert(region->pDimensionRegions[i]);
-            }
-        }
+        m_DimRegionChooser.get_all_dimregions(region, dimreg_edit.dimregs);
     } else {
         m_DimRegionChooser.get_dimregions(region, stereo, dimreg_edit.dimregs);
     }
@@ -1817,6 +2004,7 @@ void MainWindow::add_region_to_dimregs(gig::Region* region, bool stereo, bool al
 
 void MainWindow::update_dimregs()
 {
+    // clear() keeps the vector's memory, so refilling it is cheap
     dimreg_edit.dimregs.clear();
     bool all_regions = dimreg_all_regions.get_active();
     bool stereo = dimreg_stereo.get_active();
@@ -1837,6 +2025,7 @@ void MainWindow::update_dimregs()
             add_region_to_dimregs(region, stereo, all_dimregs);
         }
     }
+    dimreg_edit.dimregs.normalize();
 
     m_RegionChooser.setModifyAllRegions(all_regions);
     m_DimRegionChooser.setModifyAllRegions(all_regions);
@@ -2081,6 +2270,194 @@ Glib::Dispatcher& Saver::signal_error()
     return error_dispatcher;
 }
 
+void merger_progress_callback(gig::progress_t* progress)
+{
+    Merger* merger = static_cast<Merger*>(progress->custom);
+    merger->progress_callback(progress->factor);
+}
+
+/**
+ * Progress of saving the merged file at the end, after all source files were
+ * merged.
+ */
+void Merger::progress_callback(float fraction)
+{
+    {
+        Glib::Threads::Mutex::Lock lock(progressMutex);
+        currentFile = filenames.size();
+        progress = (filenames.size() + fraction) / (filenames.size() + 1);
+    }
+    progress_dispatcher.emit();
+}
+
+void Merger::set_current_file(int index)
+{
+    {
+        Glib::Threads::Mutex::Lock lock(progressMutex);
+        currentFile = index;
+        progress = float(index) / (filenames.size() + 1);
+    }
+    progress_dispatcher.emit();
+}
+
+#if defined(WIN32) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 2))
+// make sure stack is 16-byte aligned for SSE instructions
+__attribute__((force_align_arg_pointer))
+#endif
+void Merger::thread_function()
+{
+    printf("thread_function self=%p\n",
+           static_cast<void*>(Glib::Threads::Thread::self()));
+    try {
+        // merge the .gig files one by one to the .gig file currently being
+        // open in gigedit
+        mergeGigFiles(gig, filenames,
+                      sigc::mem_fun(*this, &Merger::set_current_file));
+
+        // finally save the merged file
+        //NOTE: requires that this gig file already has a filename !
+        gig::progress_t progress;
+        progress.callback = merger_progress_callback;
+        progress.custom = this;
+        gig->Save(&progress);
+
+        printf("End\n");
+        finished_dispatcher.emit();
+    } catch (RIFF::Exception e) {
+        error_message = e.Message;
+        error_dispatcher.emit();
+    } catch (...) {
+        error_message = _("Unknown exception occurred");
+        error_dispatcher.emit();
+    }
+}
+
+Merger::Merger(gig::File* file, const std::vector<std::string>& filenames)
+    : gig(file), filenames(filenames), thread(0), progress(0.f), currentFile(0)
+{
+}
+
+Merger::~Merger()
+{
+    if (thread) thread->join();
+}
+
+void Merger::launch()
+{
+#ifdef OLD_THREADS
+    thread = Glib::Thread::create(sigc::mem_fun(*this, &Merger::thread_function), true);
+#else
+    thread = Glib::Threads::Thread::create(sigc::mem_fun(*this, &Merger::thread_function));
+#endif
+    printf("launch thread=%p\n", static_cast<void*>(thread));
+}
+
+float Merger::get_progress()
+{
+    float res;
+    {
+        Glib::Threads::Mutex::Lock lock(progressMutex);
+        res = progress;
+    }
+    return res;
+}
+
+/**
+ * Index of the source file currently being merged, or the amount of source
+ * files if the merged file is currently being saved.
+ */
+int Merger::get_current_file()
+{
+    Glib::Threads::Mutex::Lock lock(progressMutex);
+    return currentFile;
+}
+
+Glib::Dispatcher& Merger::signal_progress()
+{
+    return progress_dispatcher;
+}
+
+Glib::Dispatcher& Merger::signal_finished()
+{
+    return finished_dispatcher;
+}
+
+Glib::Dispatcher& Merger::signal_error()
+{
+    return error_dispatcher;
+}
+
+#if defined(WIN32) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 2))
+// make sure stack is 16-byte aligned for SSE instructions
+__attribute__((force_align_arg_pointer))
+#endif
+void SampleHasher::thread_function()
+{
+    try {
+        index.update(gig, skip,
+                     sigc::mem_fun(*this, &SampleHasher::progress_callback));
+        if (audioFiles.empty()) {
+            duplicates = index.duplicates(gig, skip);
+        } else {
+            for (int i = 0; i < audioFiles.size(); ++i) {
+                gig::Sample* sample = index.find(gig, audioFiles[i], skip);
+                if (sample) existing[audioFiles[i]] = sample;
+            }
+        }
+    } catch (...) {
+        // results are incomplete, so some duplicates are just not detected
+        std::cerr << "Unknown exception while comparing sample data\n" << std::flush;
+    }
+    finished_dispatcher.emit();
+}
+
+void SampleHasher::progress_callback(float fraction)
+{
+    {
+        Glib::Threads::Mutex::Lock lock(progressMutex);
+        progress = fraction;
+    }
+    progress_dispatcher.emit();
+}
+
+SampleHasher::SampleHasher(SampleHashIndex& index, gig::File* file,
+                           const std::set<gig::Sample*>& skip,
+                           const std::vector<std::string>& audioFiles)
+    : audioFiles(audioFiles), thread(0), index(index), gig(file), skip(skip),
+      progress(0.f)
+{
+}
+
+SampleHasher::~SampleHasher()
+{
+    if (thread) thread->join();
+}
+
+void SampleHasher::launch()
+{
+#ifdef OLD_THREADS
+    thread = Glib::Thread::create(sigc::mem_fun(*this, &SampleHasher::thread_function), true);
+#else
+    thread = Glib::Threads::Thread::create(sigc::mem_fun(*this, &SampleHasher::thread_function));
+#endif
+}
+
+float SampleHasher::get_progress()
+{
+    Glib::Threads::Mutex::Lock lock(progressMutex);
+    return progress;
+}
+
+Glib::Dispatcher& SampleHasher::signal_progress()
+{
+    return progress_dispatcher;
+}
+
+Glib::Dispatcher& SampleHasher::signal_finished()
+{
+    return finished_dispatcher;
+}
+
 ProgressDialog::ProgressDialog(const Glib::ustring& title, Gtk::Window& parent)
     : Gtk::Dialog(title, parent, true)
 {
@@ -2095,11 +2472,20 @@ ProgressDialog::ProgressDialog(const Glib::ustring& title, Gtk::Window& parent)
     resize(600,50);
 }
 
+void ProgressDialog::set_text(const Glib::ustring& text)
+{
+#if GTKMM_MAJOR_VERSION >= 3
+    progressBar.set_show_text(true);
+#endif
+    progressBar.set_text(text);
+}
+
 // Clear all GUI elements / controls. This method is typically called
 // before a new .gig file is to be created or to be loaded.
 void MainWindow::__clear() {
     // forget all samples that ought to be imported
     m_SampleImportQueue.clear();
+    m_sampleHashIndex.clear();
     // clear the samples and instruments tree views
     m_refTreeModel->clear();
     m_refSamplesTreeModel->clear();
@@ -2110,6 +2496,8 @@ void MainWindow::__clear() {
         remove_instrument_from_menu(0);
     }
 #endif
+    // forget cached dimension layouts of the old file's regions
+    m_DimRegionChooser.clear_layout_cache();
     // free libgig's gig::File instance
     if (file && !file_is_shared) delete file;
     file = NULL;
@@ -2273,11 +2661,28 @@ void MainWindow::load_instrument(gig::Instrument* instr) {
         msg.run();
         Gtk::Main::quit();
     }
-    // clear all GUI elements
-    __clear();
-    // load the instrument
     gig::File* pFile = (gig::File*) instr->GetParent();
-    load_gig(pFile, 0 /*file name*/, true /*shared instrument*/);
+    if (kept_file && kept_file == pFile && models_match_file(pFile)) {
+        // window was kept from a previous editor session and its models
+        // still reflect this file, so only attach it again
+        file = pFile;
+        set_file_is_shared(true);
+        this->filename = !pFile->GetFileName().empty() ?
+            pFile->GetFileName() : _("Unsaved Gig File");
+        set_title(Glib::filename_display_basename(this->filename));
+        file_has_name = false;
+        file_is_changed = false;
+        if (propDialog) {
+            propDialog->set_file(pFile);
+            propDialog->set_info(pFile->pInfo);
+        }
+    } else {
+        // clear all GUI elements
+        __clear();
+        // load the instrument
+        load_gig(pFile, 0 /*file name*/, true /*shared instrument*/);
+    }
+    kept_file = NULL;
     // automatically select the given instrument
     int i = 0;
     for (gig::Instrument* instrument = pFile->GetFirstInstrument(); instrument;
@@ -2304,6 +2709,127 @@ void MainWindow::load_instrument(gig::Instrument* instr) {
     }
 }
 
+/**
+ * Shows the sampler's lock duration statistics (in live-mode) next to the
+ * attached state in the status bar.
+ */
+void MainWindow::set_lock_stats(const Glib::ustring& summary, const Glib::ustring& details) {
+    m_LockStatsLabel.set_text(summary);
+    m_LockStatsLabel.set_tooltip_text(details);
+    if (file_is_shared) m_LockStatsLabel.show();
+}
+
+/**
+ * Hides all windows owned by this main window and detaches the shared gig
+ * file, used when the main window is hidden to be reused later on (see
+ * Settings::keepPluginWindow). The sampler may free the file before the
+ * window is reused, so nothing refers to it anymore afterwards, except of
+ * the instruments, samples and scripts tree models. Those are kept, but only
+ * reused by load_instrument() if models_match_file() confirms they still
+ * reflect the file to be edited, otherwise they are rebuilt.
+ */
+void MainWindow::prepare_for_reuse() {
+    if (propDialog) propDialog->hide();
+    if (instrumentProps) instrumentProps->hide();
+    if (midiRules) midiRules->hide();
+    m_RegionChooser.hide_dimension_manager();
+    m_RegionChooser.invalidate_dimension_stats();
+    // no instrument selected, so no handler picks up an instrument of the
+    // kept models while the window is hidden
+    m_TreeView.get_selection()->unselect_all();
+    m_RegionChooser.set_instrument(NULL);
+    // caches which cannot be confirmed against the file later on
+    m_SampleImportQueue.clear();
+    m_sampleHashIndex.clear();
+    m_DimRegionChooser.clear_layout_cache();
+    kept_file = file_is_shared ? file : NULL;
+    if (file && !file_is_shared) delete file;
+    file = NULL;
+    set_file_is_shared(false);
+}
+
+/**
+ * Returns true if the instruments, samples and scripts tree models exactly
+ * reflect the given (live) .gig file, that is each row refers to the file's
+ * respective object, in the same order and with the same name. The objects
+ * referenced by the models are never accessed here, they might already be
+ * freed. Their pointers are only compared with the ones of the given file,
+ * so if all of them match, all of them are valid.
+ */
+bool MainWindow::models_match_file(gig::File* gig) {
+    // instruments
+    Gtk::TreeModel::Children rows = m_refTreeModel->children();
+    Gtk::TreeModel::Children::iterator it = rows.begin();
+    for (gig::Instrument* instrument = gig->GetFirstInstrument(); instrument;
+         instrument = gig->GetNextInstrument(), ++it)
+    {
+        if (it == rows.end()) return false;
+        Gtk::TreeModel::Row row = *it;
+        const gig::Instrument* rowInstrument = row[m_Columns.m_col_instr];
+        const Glib::ustring name = row[m_Columns.m_col_name];
+        const Glib::ustring scripts = row[m_Columns.m_col_scripts];
+        const int iScriptSlots = instrument->ScriptSlotCount();
+        if (rowInstrument != instrument ||
+            name != gig_to_utf8(instrument->pInfo->Name) ||
+            scripts != (iScriptSlots ? ToString(iScriptSlots) : ""))
+            return false;
+    }
+    if (it != rows.end()) return false;
+
+    // sample groups and their samples (groups without name are not listed)
+    rows = m_refSamplesTreeModel->children();
+    it = rows.begin();
+    for (gig::Group* group = gig->GetFirstGroup(); group; group = gig->GetNextGroup()) {
+        if (group->Name == "") continue;
+        if (it == rows.end()) return false;
+        Gtk::TreeModel::Row rowGroup = *it++;
+        const gig::Group* rowGroupPtr = rowGroup[m_SamplesModel.m_col_group];
+        const Glib::ustring groupName = rowGroup[m_SamplesModel.m_col_name];
+        if (rowGroupPtr != group || groupName != gig_to_utf8(group->Name))
+            return false;
+        Gtk::TreeModel::Children sampleRows = rowGroup.children();
+        Gtk::TreeModel::Children::iterator itSample = sampleRows.begin();
+        for (gig::Sample* sample = group->GetFirstSample(); sample;
+             sample = group->GetNextSample(), ++itSample)
+        {
+            if (itSample == sampleRows.end()) return false;
+            Gtk::TreeModel::Row rowSample = *itSample;
+            const gig::Sample* rowSamplePtr = rowSample[m_SamplesModel.m_col_sample];
+            const Glib::ustring sampleName = rowSample[m_SamplesModel.m_col_name];
+            if (rowSamplePtr != sample || sampleName != gig_to_utf8(sample->pInfo->Name))
+                return false;
+        }
+        if (itSample != sampleRows.end()) return false;
+    }
+    if (it != rows.end()) return false;
+
+    // script groups and their scripts
+    rows = m_refScriptsTreeModel->children();
+    it = rows.begin();
+    for (int i = 0; gig->GetScriptGroup(i); ++i, ++it) {
+        gig::ScriptGroup* group = gig->GetScriptGroup(i);
+        if (it == rows.end()) return false;
+        Gtk::TreeModel::Row rowGroup = *it;
+        const gig::ScriptGroup* rowGroupPtr = rowGroup[m_ScriptsModel.m_col_group];
+        const Glib::ustring groupName = rowGroup[m_ScriptsModel.m_col_name];
+        if (rowGroupPtr != group || groupName != gig_to_utf8(group->Name))
+            return false;
+        Gtk::TreeModel::Children scriptRows = rowGroup.children();
+        Gtk::TreeModel::Children::iterator itScript = scriptRows.begin();
+        for (int s = 0; group->GetScript(s); ++s, ++itScript) {
+            gig::Script* script = group->GetScript(s);
+            if (itScript == scriptRows.end()) return false;
+            Gtk::TreeModel::Row rowScript = *itScript;
+            const gig::Script* rowScriptPtr = rowScript[m_ScriptsModel.m_col_script];
+            const Glib::ustring scriptName = rowScript[m_ScriptsModel.m_col_name];
+            if (rowScriptPtr != script || scriptName != gig_to_utf8(script->Name))
+                return false;
+        }
+        if (itScript != scriptRows.end()) return false;
+    }
+    return it == rows.end();
+}
+
 void MainWindow::on_loader_progress()
 {
     progress_dialog->set_fraction(loader->get_progress());
@@ -2523,89 +3049,32 @@ void MainWindow::__import_queued_samples() {
     std::cout << "Starting sample import\n" << std::flush;
     Glib::ustring error_files;
     printf("Samples to import: %d\n", int(m_SampleImportQueue.size()));
+    std::vector<SampleImporter::Job> jobs;
     for (std::map<gig::Sample*, SampleImportItem>::iterator iter = m_SampleImportQueue.begin();
-         iter != m_SampleImportQueue.end(); ) {
-        printf("Importing sample %s\n",iter->second.sample_path.c_str());
-        SF_INFO info;
-        info.format = 0;
-        SNDFILE* hFile = sf_open(iter->second.sample_path.c_str(), SFM_READ, &info);
-        sf_command(hFile, SFC_SET_SCALE_FLOAT_INT_READ, 0, SF_TRUE);
-        try {
-            if (!hFile) throw std::string(_("could not open file"));
-            // determine sample's bit depth
-            int bitdepth;
-            switch (info.format & 0xff) {
-                case SF_FORMAT_PCM_S8:
-                case SF_FORMAT_PCM_16:
-                case SF_FORMAT_PCM_U8:
-                    bitdepth = 16;
-                    break;
-                case SF_FORMAT_PCM_24:
-                case SF_FORMAT_PCM_32:
-                case SF_FORMAT_FLOAT:
-                case SF_FORMAT_DOUBLE:
-                    bitdepth = 24;
-                    break;
-                default:
-                    sf_close(hFile); // close sound file
-                    throw std::string(_("format not supported")); // unsupported subformat (yet?)
-            }
-
-            // reset write position for sample
-            iter->first->SetPos(0);
-
-            const int bufsize = 10000;
-            switch (bitdepth) {
-                case 16: {
-                    short* buffer = new short[bufsize * info.channels];
-                    sf_count_t cnt = info.frames;
-                    while (cnt) {
-                        // libsndfile does the conversion for us (if needed)
-                        int n = sf_readf_short(hFile, buffer, bufsize);
-                        // write from buffer directly (physically) into .gig file
-                        iter->first->Write(buffer, n);
-                        cnt -= n;
-                    }
-                    delete[] buffer;
-                    break;
-                }
-                case 24: {
-                    int* srcbuf = new int[bufsize * info.channels];
-                    uint8_t* dstbuf = new uint8_t[bufsize * 3 * info.channels];
-                    sf_count_t cnt = info.frames;
-                    while (cnt) {
-                        // libsndfile returns 32 bits, convert to 24
-                        int n = sf_readf_int(hFile, srcbuf, bufsize);
-                        int j = 0;
-                        for (int i = 0 ; i < n * info.channels ; i++) {
-                            dstbuf[j++] = srcbuf[i] >> 8;
-                            dstbuf[j++] = srcbuf[i] >> 16;
-                            dstbuf[j++] = srcbuf[i] >> 24;
-                        }
-                        // write from buffer directly (physically) into .gig file
-                        iter->first->Write(dstbuf, n);
-                        cnt -= n;
-                    }
-                    delete[] srcbuf;
-                    delete[] dstbuf;
-                    break;
-                }
-            }
-            // cleanup
-            sf_close(hFile);
-            // let the sampler re-cache the sample if needed
-            sample_changed_signal.emit(iter->first);
-            // on success we remove the sample from the import queue,
-            // otherwise keep it, maybe it works the next time ?
-            std::map<gig::Sample*, SampleImportItem>::iterator cur = iter;
-            ++iter;
-            m_SampleImportQueue.erase(cur);
-        } catch (std::string what) {
+         iter != m_SampleImportQueue.end(); ++iter)
+    {
+        SampleImporter::Job job;
+        job.sample = iter->first;
+        job.path = iter->second.sample_path;
+        job.framesWritten = 0;
+        jobs.push_back(job);
+        m_sampleHashIndex.forget(iter->first);
+    }
+    SampleImporter importer;
+    importer.run(jobs);
+    for (int i = 0; i < jobs.size(); ++i) {
+        const SampleImporter::Job& job = jobs[i];
+        if (!job.error.empty()) {
             // remember the files that made trouble (and their cause)
             if (!error_files.empty()) error_files += "\n";
-            error_files += iter->second.sample_path += " (" + what + ")";
-            ++iter;
+            error_files += Glib::filename_to_utf8(job.path) + " (" + job.error + ")";
+            continue;
         }
+        // let the sampler re-cache the sample if needed
+        sample_changed_signal.emit(job.sample);
+        // on success we remove the sample from the import queue,
+        // otherwise keep it, maybe it works the next time ?
+        m_SampleImportQueue.erase(job.sample);
     }
     // show error message box when some sample(s) could not be imported
     if (!error_files.empty()) {
@@ -2617,8 +3086,9 @@ void MainWindow::__import_queued_samples() {
 
 void MainWindow::on_action_file_properties()
 {
-    propDialog.show();
-    propDialog.deiconify();
+    PropDialog& dialog = prop_dialog();
+    dialog.show();
+    dialog.deiconify();
 }
 
 void MainWindow::on_action_warn_user_on_extensions() {
@@ -2660,6 +3130,16 @@ void MainWindow::on_action_move_root_note_with_region_moved() {
         !Settings::singleton()->moveRootNoteWithRegionMoved;
 }
 
+void MainWindow::on_action_keep_plugin_window() {
+    Settings::singleton()->keepPluginWindow =
+        !Settings::singleton()->keepPluginWindow;
+}
+
+void MainWindow::on_action_commit_live_edits_instantly() {
+    Settings::singleton()->commitLiveEditsInstantly =
+        !Settings::singleton()->commitLiveEditsInstantly;
+}
+
 void MainWindow::on_action_help_about()
 {
     Gtk::AboutDialog dialog;
@@ -2976,24 +3456,7 @@ void MainWindow::file_changed()
 }
 
 void MainWindow::updateSampleRefCountMap(gig::File* gig) {
-    sample_ref_count.clear();
-    
-    if (!gig) return;
-
-    for (gig::Instrument* instrument = gig->GetFirstInstrument(); instrument;
-         instrument = gig->GetNextInstrument())
-    {
-        for (gig::Region* rgn = instrument->GetFirstRegion(); rgn;
-             rgn = instrument->GetNextRegion())
-        {
-            for (int i = 0; i < 256; ++i) {
-                if (!rgn->pDimensionRegions[i]) continue;
-                if (rgn->pDimensionRegions[i]->pSample) {
-                    sample_ref_count[rgn->pDimensionRegions[i]->pSample]++;
-                }
-            }
-        }
-    }
+    countSampleRefs(gig, sample_ref_count);
 }
 
 bool MainWindow::onQueryTreeViewTooltip(int x, int y, bool keyboardTip, const Glib::RefPtr<Gtk::Tooltip>& tooltip) {
@@ -3056,8 +3519,10 @@ void MainWindow::load_gig(gig::File* gig, const char* filename, bool isSharedIns
     file_has_name = filename;
     file_is_changed = false;
 
-    propDialog.set_file(gig);
-    propDialog.set_info(gig->pInfo);
+    if (propDialog) {
+        propDialog->set_file(gig);
+        propDialog->set_info(gig->pInfo);
+    }
 
     instrument_name_connection.block();
     int index = 0;
@@ -3138,18 +3603,21 @@ void MainWindow::load_gig(gig::File* gig, const char* filename, bool isSharedIns
 
     instr_props_set_instrument();
     gig::Instrument* instrument = get_instrument();
-    if (instrument) {
-        midiRules.set_instrument(instrument);
+    if (instrument && midiRules) {
+        midiRules->set_instrument(instrument);
     }
 }
 
 bool MainWindow::instr_props_set_instrument()
 {
-    instrumentProps.signal_name_changed().clear();
+    // nothing to update if the instrument properties window was never opened
+    if (!instrumentProps) return get_instrument() != NULL;
+
+    instrumentProps->signal_name_changed().clear();
 
     std::vector<Gtk::TreeModel::Path> rows = m_TreeView.get_selection()->get_selected_rows();
     if (rows.empty()) {
-        instrumentProps.hide();
+        instrumentProps->hide();
         return false;
     }
     //NOTE: was const_iterator before, which did not compile with GTKMM4 development branch, probably going to be fixed before final GTKMM4 release though.
@@ -3158,17 +3626,17 @@ bool MainWindow::instr_props_set_instrument()
         Gtk::TreeModel::Row row = *it;
         gig::Instrument* instrument = row[m_Columns.m_col_instr];
 
-        instrumentProps.set_instrument(instrument);
+        instrumentProps->set_instrument(instrument);
 
         // make sure instrument tree is updated when user changes the
         // instrument name in instrument properties window
-        instrumentProps.signal_name_changed().connect(
+        instrumentProps->signal_name_changed().connect(
             sigc::bind(
                 sigc::mem_fun(*this, 
                               &MainWindow::instr_name_changed_by_instr_props),
                 it));
     } else {
-        instrumentProps.hide();
+        instrumentProps->hide();
     }
     //NOTE: explicit boolean cast required for GTKMM4 development branch here
     return it ? true : false;
@@ -3176,9 +3644,10 @@ bool MainWindow::instr_props_set_instrument()
 
 void MainWindow::show_instr_props()
 {
+    instrument_props();
     if (instr_props_set_instrument()) {
-        instrumentProps.show();
-        instrumentProps.deiconify();
+        instrumentProps->show();
+        instrumentProps->deiconify();
     }
 }
 
@@ -3201,9 +3670,10 @@ void MainWindow::show_midi_rules()
 {
     if (gig::Instrument* instrument = get_instrument())
     {
-        midiRules.set_instrument(instrument);
-        midiRules.show();
-        midiRules.deiconify();
+        MidiRules& rules = midi_rules();
+        rules.set_instrument(instrument);
+        rules.show();
+        rules.deiconify();
     }
 }
 
@@ -3890,10 +4360,12 @@ void MainWindow::on_action_remove_instrument() {
 #endif
             instr_props_set_instrument();
             instr = get_instrument();
-            if (instr) {
-                midiRules.set_instrument(instr);
-            } else {
-                midiRules.hide();
+            if (midiRules) {
+                if (instr) {
+                    midiRules->set_instrument(instr);
+                } else {
+                    midiRules->hide();
+                }
             }
         } catch (RIFF::Exception e) {
             Gtk::MessageDialog msg(*this, e.Message.c_str(), false, Gtk::MESSAGE_ERROR);
@@ -4052,6 +4524,15 @@ void MainWindow::on_action_add_sample() {
     add_or_replace_sample(false);
 }
 
+// matches all file types supported by libsndfile
+static const char* const supportedFileTypes[] = {
+    "*.wav", "*.WAV", "*.aiff", "*.AIFF", "*.aifc", "*.AIFC", "*.snd",
+    "*.SND", "*.au", "*.AU", "*.paf", "*.PAF", "*.iff", "*.IFF",
+    "*.svx", "*.SVX", "*.sf", "*.SF", "*.voc", "*.VOC", "*.w64",
+    "*.W64", "*.pvf", "*.PVF", "*.xi", "*.XI", "*.htk", "*.HTK",
+    "*.caf", "*.CAF", NULL
+};
+
 void MainWindow::add_or_replace_sample(bool replace) {
     if (!file) return;
 
@@ -4092,13 +4573,6 @@ void MainWindow::add_or_replace_sample(bool replace) {
 #else
     Glib::RefPtr<Gtk::FileFilter> soundfilter = Gtk::FileFilter::create();
 #endif
-    const char* const supportedFileTypes[] = {
-        "*.wav", "*.WAV", "*.aiff", "*.AIFF", "*.aifc", "*.AIFC", "*.snd",
-        "*.SND", "*.au", "*.AU", "*.paf", "*.PAF", "*.iff", "*.IFF",
-        "*.svx", "*.SVX", "*.sf", "*.SF", "*.voc", "*.VOC", "*.w64",
-        "*.W64", "*.pvf", "*.PVF", "*.xi", "*.XI", "*.htk", "*.HTK",
-        "*.caf", "*.CAF", NULL
-    };
     const char* soundfiles = _("Sound Files");
     const char* allfiles = _("All Files");
 #if (GTKMM_MAJOR_VERSION == 2 && GTKMM_MINOR_VERSION < 90) || GTKMM_MAJOR_VERSION < 2
@@ -4127,124 +4601,173 @@ void MainWindow::add_or_replace_sample(bool replace) {
     }
     if (dialog.run() == Gtk::RESPONSE_OK) {
         current_sample_dir = dialog.get_current_folder();
-        Glib::ustring error_files;
-        std::vector<std::string> filenames = dialog.get_filenames();
-        for (std::vector<std::string>::iterator iter = filenames.begin();
-             iter != filenames.end(); ++iter) {
-            printf("Adding sample %s\n",(*iter).c_str());
-            // use libsndfile to retrieve file information
-            SF_INFO info;
-            info.format = 0;
-            SNDFILE* hFile = sf_open((*iter).c_str(), SFM_READ, &info);
-            try {
-                if (!hFile) throw std::string(_("could not open file"));
-                int bitdepth;
-                switch (info.format & 0xff) {
-                    case SF_FORMAT_PCM_S8:
-                    case SF_FORMAT_PCM_16:
-                    case SF_FORMAT_PCM_U8:
-                        bitdepth = 16;
+        const std::vector<std::string> filenames = dialog.get_filenames();
+        const Gtk::TreeModel::Path path = m_refSamplesTreeModel->get_path(row);
+        if (replace) {
+            add_or_replace_sample_files(true, group, sample, path, filenames);
+        } else {
+            // don't add audio files whose sample data is already stored as
+            // sample in the .gig file, which requires hashing all samples
+            // first
+            hash_samples(filenames, sigc::bind(
+                sigc::mem_fun(*this, &MainWindow::add_or_replace_sample_files),
+                false, group, sample, path, filenames
+            ));
+        }
+    }
+}
+
+/**
+ * Adds the given audio files as new samples to @a group, or replaces
+ * @a sample by the (single) given audio file. @a path is the samples tree
+ * view row of the group, or of the sample respectively. When adding, the
+ * samples must have been hashed by hash_samples() before.
+ */
+void MainWindow::add_or_replace_sample_files(bool replace, gig::Group* group,
+                                             gig::Sample* sample,
+                                             Gtk::TreeModel::Path path,
+                                             const std::vector<std::string>& filenames)
+{
+    Gtk::TreeModel::iterator it = m_refSamplesTreeModel->get_iter(path);
+    if (!it) return;
+    Gtk::TreeModel::Row row = *it;
+    const gig::Group* rowGroup = row[m_SamplesModel.m_col_group];
+    const gig::Sample* rowSample = row[m_SamplesModel.m_col_sample];
+    if (replace ? rowSample != sample : rowGroup != group) return;
+    Glib::ustring error_files, duplicate_files;
+    for (std::vector<std::string>::const_iterator iter = filenames.begin();
+         iter != filenames.end(); ++iter) {
+        printf("Adding sample %s\n",(*iter).c_str());
+        // use libsndfile to retrieve file information
+        SF_INFO info;
+        info.format = 0;
+        SNDFILE* hFile = sf_open((*iter).c_str(), SFM_READ, &info);
+        try {
+            if (!hFile) throw std::string(_("could not open file"));
+            int bitdepth;
+            switch (info.format & 0xff) {
+                case SF_FORMAT_PCM_S8:
+                case SF_FORMAT_PCM_16:
+                case SF_FORMAT_PCM_U8:
+                    bitdepth = 16;
+                    break;
+                case SF_FORMAT_PCM_24:
+                case SF_FORMAT_PCM_32:
+                case SF_FORMAT_FLOAT:
+                case SF_FORMAT_DOUBLE:
+                    bitdepth = 24;
+                    break;
+                default:
+                    sf_close(hFile); // close sound file
+                    throw std::string(_("format not supported")); // unsupported subformat (yet?)
+            }
+            // don't add an audio file whose sample data is already
+            // stored as sample in the .gig file
+            if (!replace && sample_hasher->existing.count(*iter)) {
+                gig::Sample* existing = sample_hasher->existing[*iter];
+                sf_close(hFile); // close sound file
+                if (!duplicate_files.empty()) duplicate_files += "\n";
+                duplicate_files += *iter + " (" + gig_to_utf8(existing->pInfo->Name) + ")";
+                continue;
+            }
+            // add a new sample to the .gig file (if adding is requested actually)
+            if (!replace) sample = file->AddSample();
+            // file name without path
+            Glib::ustring filename = Glib::filename_display_basename(*iter);
+            // remove file extension if there is one
+            for (int i = 0; supportedFileTypes[i]; i++) {
+                if (Glib::str_has_suffix(filename, supportedFileTypes[i] + 1)) {
+                    filename.erase(filename.length() - strlen(supportedFileTypes[i] + 1));
+                    break;
+                }
+            }
+            sample->pInfo->Name = gig_from_utf8(filename);
+            sample->Channels = info.channels;
+            sample->BitDepth = bitdepth;
+            sample->FrameSize = bitdepth / 8/*1 byte are 8 bits*/ * info.channels;
+            sample->SamplesPerSecond = info.samplerate;
+            sample->AverageBytesPerSecond = sample->FrameSize * sample->SamplesPerSecond;
+            sample->BlockAlign = sample->FrameSize;
+            sample->SamplesTotal = info.frames;
+
+            SF_INSTRUMENT instrument;
+            if (sf_command(hFile, SFC_GET_INSTRUMENT,
+                           &instrument, sizeof(instrument)) != SF_FALSE)
+            {
+                sample->MIDIUnityNote = instrument.basenote;
+                sample->FineTune      = instrument.detune;
+
+                if (instrument.loop_count && instrument.loops[0].mode != SF_LOOP_NONE) {
+                    sample->Loops = 1;
+
+                    switch (instrument.loops[0].mode) {
+                    case SF_LOOP_FORWARD:
+                        sample->LoopType = gig::loop_type_normal;
                         break;
-                    case SF_FORMAT_PCM_24:
-                    case SF_FORMAT_PCM_32:
-                    case SF_FORMAT_FLOAT:
-                    case SF_FORMAT_DOUBLE:
-                        bitdepth = 24;
+                    case SF_LOOP_BACKWARD:
+                        sample->LoopType = gig::loop_type_backward;
                         break;
-                    default:
-                        sf_close(hFile); // close sound file
-                        throw std::string(_("format not supported")); // unsupported subformat (yet?)
-                }
-                // add a new sample to the .gig file (if adding is requested actually)
-                if (!replace) sample = file->AddSample();
-                // file name without path
-                Glib::ustring filename = Glib::filename_display_basename(*iter);
-                // remove file extension if there is one
-                for (int i = 0; supportedFileTypes[i]; i++) {
-                    if (Glib::str_has_suffix(filename, supportedFileTypes[i] + 1)) {
-                        filename.erase(filename.length() - strlen(supportedFileTypes[i] + 1));
+                    case SF_LOOP_ALTERNATING:
+                        sample->LoopType = gig::loop_type_bidirectional;
                         break;
                     }
+                    sample->LoopStart = instrument.loops[0].start;
+                    sample->LoopEnd = instrument.loops[0].end;
+                    sample->LoopPlayCount = instrument.loops[0].count;
+                    sample->LoopSize = sample->LoopEnd - sample->LoopStart + 1;
                 }
-                sample->pInfo->Name = gig_from_utf8(filename);
-                sample->Channels = info.channels;
-                sample->BitDepth = bitdepth;
-                sample->FrameSize = bitdepth / 8/*1 byte are 8 bits*/ * info.channels;
-                sample->SamplesPerSecond = info.samplerate;
-                sample->AverageBytesPerSecond = sample->FrameSize * sample->SamplesPerSecond;
-                sample->BlockAlign = sample->FrameSize;
-                sample->SamplesTotal = info.frames;
-
-                SF_INSTRUMENT instrument;
-                if (sf_command(hFile, SFC_GET_INSTRUMENT,
-                               &instrument, sizeof(instrument)) != SF_FALSE)
-                {
-                    sample->MIDIUnityNote = instrument.basenote;
-                    sample->FineTune      = instrument.detune;
-
-                    if (instrument.loop_count && instrument.loops[0].mode != SF_LOOP_NONE) {
-                        sample->Loops = 1;
-
-                        switch (instrument.loops[0].mode) {
-                        case SF_LOOP_FORWARD:
-                            sample->LoopType = gig::loop_type_normal;
-                            break;
-                        case SF_LOOP_BACKWARD:
-                            sample->LoopType = gig::loop_type_backward;
-                            break;
-                        case SF_LOOP_ALTERNATING:
-                            sample->LoopType = gig::loop_type_bidirectional;
-                            break;
-                        }
-                        sample->LoopStart = instrument.loops[0].start;
-                        sample->LoopEnd = instrument.loops[0].end;
-                        sample->LoopPlayCount = instrument.loops[0].count;
-                        sample->LoopSize = sample->LoopEnd - sample->LoopStart + 1;
-                    }
-                }
+            }
 
-                // schedule resizing the sample (which will be done
-                // physically when File::Save() is called)
-                sample->Resize(info.frames);
-                // make sure sample is part of the selected group
-                if (!replace) group->AddSample(sample);
-                // schedule that physical resize and sample import
-                // (data copying), performed when "Save" is requested
-                SampleImportItem sched_item;
-                sched_item.gig_sample  = sample;
-                sched_item.sample_path = *iter;
-                m_SampleImportQueue[sample] = sched_item;
-                // add sample to the tree view
-                if (replace) {
-                    row[m_SamplesModel.m_col_name] = gig_to_utf8(sample->pInfo->Name);
-                } else {
-                    Gtk::TreeModel::iterator iterSample =
-                        m_refSamplesTreeModel->append(row.children());
-                    Gtk::TreeModel::Row rowSample = *iterSample;
-                    rowSample[m_SamplesModel.m_col_name] =
-                        gig_to_utf8(sample->pInfo->Name);
-                    rowSample[m_SamplesModel.m_col_sample] = sample;
-                    rowSample[m_SamplesModel.m_col_group]  = NULL;
-                }
-                // close sound file
-                sf_close(hFile);
-                file_changed();
-            } catch (std::string what) { // remember the files that made trouble (and their cause)
-                if (!error_files.empty()) error_files += "\n";
-                error_files += *iter += " (" + what + ")";
+            // schedule resizing the sample (which will be done
+            // physically when File::Save() is called)
+            sample->Resize(info.frames);
+            // make sure sample is part of the selected group
+            if (!replace) group->AddSample(sample);
+            // schedule that physical resize and sample import
+            // (data copying), performed when "Save" is requested
+            SampleImportItem sched_item;
+            sched_item.gig_sample  = sample;
+            sched_item.sample_path = *iter;
+            m_SampleImportQueue[sample] = sched_item;
+            m_sampleHashIndex.forget(sample);
+            // add sample to the tree view
+            if (replace) {
+                row[m_SamplesModel.m_col_name] = gig_to_utf8(sample->pInfo->Name);
+            } else {
+                Gtk::TreeModel::iterator iterSample =
+                    m_refSamplesTreeModel->append(row.children());
+                Gtk::TreeModel::Row rowSample = *iterSample;
+                rowSample[m_SamplesModel.m_col_name] =
+                    gig_to_utf8(sample->pInfo->Name);
+                rowSample[m_SamplesModel.m_col_sample] = sample;
+                rowSample[m_SamplesModel.m_col_group]  = NULL;
             }
-        }
-        // show error message box when some file(s) could not be opened / added
-        if (!error_files.empty()) {
-            Glib::ustring txt =
-                (replace
-                    ? _("Failed to replace sample with:\n")
-                    : _("Could not add the following sample(s):\n"))
-                + error_files;
-            Gtk::MessageDialog msg(*this, txt, false, Gtk::MESSAGE_ERROR);
-            msg.run();
+            // close sound file
+            sf_close(hFile);
+            file_changed();
+        } catch (std::string what) { // remember the files that made trouble (and their cause)
+            if (!error_files.empty()) error_files += "\n";
+            error_files += *iter + " (" + what + ")";
         }
     }
+    // show error message box when some file(s) could not be opened / added
+    if (!error_files.empty()) {
+        Glib::ustring txt =
+            (replace
+                ? _("Failed to replace sample with:\n")
+                : _("Could not add the following sample(s):\n"))
+            + error_files;
+        Gtk::MessageDialog msg(*this, txt, false, Gtk::MESSAGE_ERROR);
+        msg.run();
+    }
+    // show which files were skipped because they are already there
+    if (!duplicate_files.empty()) {
+        Glib::ustring txt =
+            _("The following file(s) were not added, because samples with "
+              "identical sample data already exist:\n") + duplicate_files;
+        Gtk::MessageDialog msg(*this, txt, false, Gtk::MESSAGE_INFO);
+        msg.run();
+    }
 }
 
 void MainWindow::on_action_replace_all_samples_in_all_groups()
@@ -4316,30 +4839,15 @@ void MainWindow::on_action_replace_all_samples_in_all_groups()
                 folder + G_DIR_SEPARATOR_S +
                 Glib::filename_from_utf8(gig_to_utf8(sample->pInfo->Name) +
                                          postfixEntryBox.get_text());
-            SF_INFO info;
-            info.format = 0;
-            SNDFILE* hFile = sf_open(filename.c_str(), SFM_READ, &info);
             try
             {
-                if (!hFile) throw std::string(_("could not open file"));
-                switch (info.format & 0xff) {
-                    case SF_FORMAT_PCM_S8:
-                    case SF_FORMAT_PCM_16:
-                    case SF_FORMAT_PCM_U8:
-                    case SF_FORMAT_PCM_24:
-                    case SF_FORMAT_PCM_32:
-                    case SF_FORMAT_FLOAT:
-                    case SF_FORMAT_DOUBLE:
-                        break;
-                    default:
-                        sf_close(hFile);
-                        throw std::string(_("format not supported"));
-                }
+                Glib::ustring error;
+                if (!SampleImporter::prepareSample(sample, filename, error))
+                    throw std::string(error);
                 SampleImportItem sched_item;
                 sched_item.gig_sample  = sample;
                 sched_item.sample_path = filename;
                 m_SampleImportQueue[sample] = sched_item;
-                sf_close(hFile);
                 file_changed();
             }
             catch (std::string what)
@@ -4490,6 +4998,114 @@ void MainWindow::on_action_remove_unused_samples() {
     __refreshEntireGUI();
 }
 
+/**
+ * Returns all samples whose sample data was not imported into the .gig file
+ * yet (that is before the file is saved).
+ */
+std::set<gig::Sample*> MainWindow::samplesNotImportedYet() const {
+    std::set<gig::Sample*> samples;
+    for (std::map<gig::Sample*, SampleImportItem>::const_iterator it = m_SampleImportQueue.begin();
+         it != m_SampleImportQueue.end(); ++it)
+    {
+        samples.insert(it->first);
+    }
+    return samples;
+}
+
+void MainWindow::on_action_remove_duplicate_samples() {
+    if (!file) return;
+
+    // find all samples with identical sample data, which requires hashing all
+    // samples first
+    hash_samples(std::vector<std::string>(),
+                 sigc::mem_fun(*this, &MainWindow::remove_duplicate_samples));
+}
+
+/**
+ * Removes the duplicate samples found by hash_samples() before, all
+ * references to them are redirected to the respective sample being kept.
+ */
+void MainWindow::remove_duplicate_samples() {
+    const std::vector<SampleHashIndex::Duplicates>& duplicates =
+        sample_hasher->duplicates;
+    if (duplicates.empty()) {
+        Gtk::MessageDialog msg(*this, _("No duplicate samples found."), false, Gtk::MESSAGE_INFO);
+        msg.run();
+        return;
+    }
+
+    // the first sample of each group is kept, all other ones are removed
+    std::map<gig::Sample*, gig::Sample*> keptSample;
+    std::list<gig::Sample*> lsamples;
+    uint64_t bytes = 0;
+    for (int i = 0; i < duplicates.size(); ++i) {
+        for (int j = 1; j < duplicates[i].size(); ++j) {
+            gig::Sample* sample = duplicates[i][j];
+            keptSample[sample] = duplicates[i][0];
+            lsamples.push_back(sample);
+            bytes += uint64_t(sample->SamplesTotal) * sample->FrameSize;
+        }
+    }
+
+    // redirect all references to the samples being kept
+    std::vector<gig::Region*> regions;
+    for (gig::Instrument* instrument = file->GetFirstInstrument(); instrument;
+                          instrument = file->GetNextInstrument())
+    {
+        for (gig::Region* rgn = instrument->GetFirstRegion(); rgn;
+                          rgn = instrument->GetNextRegion())
+        {
+            regions.push_back(rgn);
+        }
+    }
+    for (int r = 0; r < regions.size(); ++r) {
+        gig::Region* rgn = regions[r];
+        bool changed = false;
+        for (int i = 0; i < 256; ++i) {
+            gig::DimensionRegion* d = rgn->pDimensionRegions[i];
+            if (!d || !keptSample.count(d->pSample)) continue;
+            if (!changed) {
+                region_to_be_changed_signal.emit(rgn);
+                changed = true;
+            }
+            gig::Sample* oldref = d->pSample;
+            d->pSample = keptSample[oldref];
+            sample_ref_changed_signal.emit(oldref, d->pSample);
+        }
+        if (changed) region_changed_signal.emit(rgn);
+    }
+
+    // notify everybody that we're going to remove these samples
+    samples_to_be_removed_signal.emit(lsamples);
+
+    // remove the duplicates
+    try {
+        for (std::list<gig::Sample*>::iterator itSample = lsamples.begin();
+             itSample != lsamples.end(); ++itSample)
+        {
+            file->DeleteSample(*itSample);
+        }
+    } catch (RIFF::Exception e) {
+        // show error message
+        Gtk::MessageDialog msg(*this, e.Message.c_str(), false, Gtk::MESSAGE_ERROR);
+        msg.run();
+    }
+
+    // notify everybody that we're done with removal
+    samples_removed_signal.emit();
+
+    dimreg_changed();
+    file_changed();
+    __refreshEntireGUI();
+
+    Glib::ustring txt =
+        ToString(lsamples.size()) + " " + _("duplicate samples removed") +
+        ", " + ToString(bytes / 1024 / 1024) + " MB " +
+        _("sample data will be reclaimed on next save.");
+    Gtk::MessageDialog msg(*this, txt, false, Gtk::MESSAGE_INFO);
+    msg.run();
+}
+
 // see comment on on_sample_treeview_drag_begin()
 void MainWindow::on_scripts_treeview_drag_begin(const Glib::RefPtr<Gdk::DragContext>& context)
 {
@@ -4778,8 +5394,8 @@ void MainWindow::instrument_name_changed(const Gtk::TreeModel::Path& path,
         instrument->pInfo->Name = gigname;
 
         // change name in the instrument properties window
-        if (instrumentProps.get_instrument() == instrument) {
-            instrumentProps.update_name();
+        if (instrumentProps && instrumentProps->get_instrument() == instrument) {
+            instrumentProps->update_name();
         }
 
         file_changed();
@@ -4870,97 +5486,119 @@ void MainWindow::on_action_view_references() {
 }
 
 void MainWindow::mergeFiles(const std::vector<std::string>& filenames) {
-    struct _Source {
-        std::vector<RIFF::File*> riffs;
-        std::vector<gig::File*> gigs;
-        
-        ~_Source() {
-            for (int k = 0; k < gigs.size(); ++k) delete gigs[k];
-            for (int k = 0; k < riffs.size(); ++k) delete riffs[k];
-            riffs.clear();
-            gigs.clear();
-        }
-    } sources;
-
     if (filenames.empty())
         throw RIFF::Exception(_("No files selected, so nothing done."));
 
-    // first open all input files (to avoid output file corruption)
-    int i;
-    try {
-        for (i = 0; i < filenames.size(); ++i) {
-            const std::string& filename = filenames[i];
-            printf("opening file=%s\n", filename.c_str());
+    // the source files are merged and the result is saved to disk by a
+    // separate thread
+    //NOTE: requires that this gig file already has a filename !
+    std::cout << "Merging files\n" << std::flush;
+    file_structure_to_be_changed_signal.emit(this->file);
 
-            RIFF::File* riff = new RIFF::File(filename);
-            sources.riffs.push_back(riff);
+    progress_dialog = new ProgressDialog( //FIXME: memory leak!
+        _("Merging into") +  Glib::ustring(" '") +
+        Glib::filename_display_basename(this->filename) + "' ...",
+        *this
+    );
+#if HAS_GTKMM_SHOW_ALL_CHILDREN
+    progress_dialog->show_all();
+#else
+    progress_dialog->show();
+#endif
+    if (merger) delete merger;
+    merger = new Merger(this->file, filenames);
+    merger->signal_progress().connect(
+        sigc::mem_fun(*this, &MainWindow::on_merger_progress));
+    merger->signal_finished().connect(
+        sigc::mem_fun(*this, &MainWindow::on_merger_finished));
+    merger->signal_error().connect(
+        sigc::mem_fun(*this, &MainWindow::on_merger_error));
+    merger->launch();
+}
+
+/**
+ * Hashes the sample data of all samples of the .gig file on a separate thread
+ * (samples whose sample data was not imported yet are ignored) and looks up
+ * the samples already containing the given audio files or, if no audio files
+ * are given, all duplicate samples. The sampler is locked meanwhile, since the
+ * sample data is read from the file. Calls @a finished afterwards, which finds
+ * the results in sample_hasher.
+ */
+void MainWindow::hash_samples(const std::vector<std::string>& audioFiles,
+                              const sigc::slot<void>& finished)
+{
+    file_structure_to_be_changed_signal.emit(this->file);
 
-            gig::File* gig = new gig::File(riff);
-            sources.gigs.push_back(gig);
-        }
-    } catch (RIFF::Exception e) {
-        throw RIFF::Exception(
-            _("Error occurred while opening '") +
-            filenames[i] +
-            "': " +
-            e.Message
-        );
-    } catch (...) {
-        throw RIFF::Exception(
-            _("Unknown exception occurred while opening '") + 
-            filenames[i] + "'"
-        );
-    }
+    // own dialog, deleted again when finished, since this runs on each
+    // "Add Samples" action
+    if (sample_hasher_dialog) delete sample_hasher_dialog;
+    sample_hasher_dialog = new ProgressDialog(
+        _("Comparing sample data ..."), *this
+    );
+#if HAS_GTKMM_SHOW_ALL_CHILDREN
+    sample_hasher_dialog->show_all();
+#else
+    sample_hasher_dialog->show();
+#endif
+    if (sample_hasher) delete sample_hasher;
+    sample_hasher = new SampleHasher(m_sampleHashIndex, this->file,
+                                     samplesNotImportedYet(), audioFiles);
+    sample_hasher_finished = finished;
+    sample_hasher->signal_progress().connect(
+        sigc::mem_fun(*this, &MainWindow::on_sample_hasher_progress));
+    sample_hasher->signal_finished().connect(
+        sigc::mem_fun(*this, &MainWindow::on_sample_hasher_finished));
+    sample_hasher->launch();
+}
+
+void MainWindow::on_sample_hasher_progress()
+{
+    sample_hasher_dialog->set_fraction(sample_hasher->get_progress());
+}
 
-    // now merge the opened .gig files to the main .gig file currently being
-    // open in gigedit
-    try {
-        for (i = 0; i < filenames.size(); ++i) {
-            const std::string& filename = filenames[i];
-            printf("merging file=%s\n", filename.c_str());
-            assert(i < sources.gigs.size());
+void MainWindow::on_sample_hasher_finished()
+{
+    file_structure_changed_signal.emit(this->file);
+    delete sample_hasher_dialog;
+    sample_hasher_dialog = NULL;
+    sample_hasher_finished();
+}
 
-            this->file->AddContentOf(sources.gigs[i]);
-        }
-    } catch (RIFF::Exception e) {
-        throw RIFF::Exception(
-            _("Error occurred while merging '") +
-            filenames[i] +
-            "': " +
-            e.Message
-        );
-    } catch (...) {
-        throw RIFF::Exception(
-            _("Unknown exception occurred while merging '") + 
-            filenames[i] + "'"
+void MainWindow::on_merger_progress()
+{
+    const int i = merger->get_current_file();
+    const int n = merger->filenames.size();
+    progress_dialog->set_fraction(merger->get_progress());
+    if (i < n) {
+        progress_dialog->set_text(
+            Glib::filename_display_basename(merger->filenames[i]) + " (" +
+            ToString(i + 1) + "/" + ToString(n) + ")"
         );
+    } else {
+        progress_dialog->set_text(_("Saving"));
     }
+}
 
-    // Finally save gig file persistently to disk ...
-    //NOTE: requires that this gig file already has a filename !
-    {
-        std::cout << "Saving file\n" << std::flush;
-        file_structure_to_be_changed_signal.emit(this->file);
+void MainWindow::on_merger_error()
+{
+    file_structure_changed_signal.emit(this->file);
+    progress_dialog->hide();
+    Gtk::MessageDialog msg(*this, merger->error_message, false, Gtk::MESSAGE_ERROR);
+    msg.run();
+    __refreshEntireGUI();
+}
 
-        progress_dialog = new ProgressDialog( //FIXME: memory leak!
-            _("Saving") +  Glib::ustring(" '") +
-            Glib::filename_display_basename(this->filename) + "' ...",
-            *this
-        );
-#if HAS_GTKMM_SHOW_ALL_CHILDREN
-        progress_dialog->show_all();
-#else
-        progress_dialog->show();
-#endif
-        saver = new Saver(this->file); //FIXME: memory leak!
-        saver->signal_progress().connect(
-            sigc::mem_fun(*this, &MainWindow::on_saver_progress));
-        saver->signal_finished().connect(
-            sigc::mem_fun(*this, &MainWindow::on_saver_finished));
-        saver->signal_error().connect(
-            sigc::mem_fun(*this, &MainWindow::on_saver_error));
-        saver->launch();
-    }
+void MainWindow::on_merger_finished()
+{
+    std::cout << "Merging files done. Importing queued samples now ...\n" << std::flush;
+    file_is_changed = false;
+    // the file was saved by the merge, so the data chunks of samples added
+    // before have their final size now, like after on_saver_finished()
+    __import_queued_samples();
+    std::cout << "Importing queued samples done.\n" << std::flush;
+    file_structure_changed_signal.emit(this->file);
+    __refreshEntireGUI();
+    progress_dialog->hide();
 }
 
 void MainWindow::on_action_merge_files() {
@@ -5019,7 +5657,9 @@ void MainWindow::on_action_merge_files() {
         "merge algorithm does not detect duplicate samples yet. So if you are "
         "merging files which are using equivalent sample data, those "
         "equivalent samples will currently be treated as separate samples and "
-        "will accordingly be stored separately in the target .gig file!"
+        "will accordingly be stored separately in the target .gig file! You "
+        "may remove them afterwards with 'Remove duplicate Samples' from the "
+        "'Sample' menu."
     ));
     descriptionArea.pack_start(description);
 #if USE_GTKMM_BOX
@@ -5038,16 +5678,107 @@ void MainWindow::on_action_merge_files() {
                static_cast<void*>(Glib::Threads::Thread::self()));
         std::vector<std::string> filenames = dialog.get_filenames();
 
-        // merge the selected files to the currently open .gig file
+        // merge the selected files to the currently open .gig file (the GUI
+        // is updated when the merge operation has finished)
         try {
             mergeFiles(filenames);
         } catch (RIFF::Exception e) {
             Gtk::MessageDialog msg(*this, e.Message, false, Gtk::MESSAGE_ERROR);
             msg.run();
         }
+    }
+}
 
-        // update GUI
-        __refreshEntireGUI();
+void MainWindow::on_action_check_all_scripts() {
+    if (!file) return;
+#if USE_LS_SCRIPTVM
+    // kept over the entire session, so only modified scripts are parsed again
+    static ScriptChecker checker;
+    const std::vector<ScriptChecker::Result> results = checker.check(file);
+
+    Gtk::Dialog dialog(_("Check All Scripts"), *this, true);
+    Gtk::ScrolledWindow scrolledWindow;
+    Gtk::TextView textView;
+    textView.get_buffer()->set_text(ScriptChecker::report(results));
+    textView.set_editable(false);
+    scrolledWindow.add(textView);
+    scrolledWindow.set_policy(Gtk::POLICY_AUTOMATIC, Gtk::POLICY_AUTOMATIC);
+    scrolledWindow.set_size_request(600, 400);
+#if USE_GTKMM_BOX
+    dialog.get_content_area()->pack_start(scrolledWindow);
+#else
+    dialog.get_vbox()->pack_start(scrolledWindow);
+#endif
+#if HAS_GTKMM_STOCK
+    dialog.add_button(Gtk::Stock::CLOSE, Gtk::RESPONSE_CLOSE);
+#else
+    dialog.add_button(_("_Close"), Gtk::RESPONSE_CLOSE);
+#endif
+#if HAS_GTKMM_SHOW_ALL_CHILDREN
+    dialog.show_all_children();
+#endif
+    dialog.run();
+#else
+    Gtk::MessageDialog msg(
+        *this, _("Checking scripts requires gigedit to be compiled with liblinuxsampler support."),
+        false, Gtk::MESSAGE_ERROR
+    );
+    msg.run();
+#endif
+}
+
+void MainWindow::on_action_remove_redundant_dimensions() {
+    if (!file) return;
+
+    DimensionOptimizer optimizer;
+    optimizer.analyze(file);
+
+    Gtk::Dialog dialog(_("Remove Redundant Dimensions"), *this, true);
+    Gtk::ScrolledWindow scrolledWindow;
+    Gtk::TextView textView;
+    textView.get_buffer()->set_text(optimizer.report());
+    textView.set_editable(false);
+    scrolledWindow.add(textView);
+    scrolledWindow.set_policy(Gtk::POLICY_AUTOMATIC, Gtk::POLICY_AUTOMATIC);
+    scrolledWindow.set_size_request(600, 400);
+#if USE_GTKMM_BOX
+    dialog.get_content_area()->pack_start(scrolledWindow);
+#else
+    dialog.get_vbox()->pack_start(scrolledWindow);
+#endif
+#if HAS_GTKMM_STOCK
+    dialog.add_button(Gtk::Stock::CANCEL, Gtk::RESPONSE_CANCEL);
+#else
+    dialog.add_button(_("_Cancel"), Gtk::RESPONSE_CANCEL);
+#endif
+    if (!optimizer.redundancies().empty())
+        dialog.add_button(_("_Remove"), Gtk::RESPONSE_OK);
+#if HAS_GTKMM_SHOW_ALL_CHILDREN
+    dialog.show_all_children();
+#endif
+    if (dialog.run() != Gtk::RESPONSE_OK) return;
+    dialog.hide();
+
+    file_structure_to_be_changed_signal.emit(this->file);
+    optimizer.apply();
+    file_structure_changed_signal.emit(this->file);
+
+    file_changed();
+    __refreshEntireGUI();
+
+    const std::set<Glib::ustring>& errors = optimizer.errors();
+    if (!errors.empty()) {
+        Glib::ustring txt = _(
+            "The following errors occurred while removing redundant dimensions:"
+        );
+        txt += "\n\n";
+        for (std::set<Glib::ustring>::const_iterator it = errors.begin();
+             it != errors.end(); ++it)
+        {
+            txt += "-> " + *it + "\n";
+        }
+        Gtk::MessageDialog msg(*this, txt, false, Gtk::MESSAGE_ERROR);
+        msg.run();
     }
 }
 
@@ -5064,6 +5795,7 @@ void MainWindow::set_file_is_shared(bool b) {
         m_AttachedStateImage.set(
             Gdk::Pixbuf::create_from_xpm_data(status_detached_xpm)
         );
+        m_LockStatsLabel.hide();
     }
 
     {
@@ -5073,6 +5805,24 @@ void MainWindow::set_file_is_shared(bool b) {
         Gtk::MenuItem* item = dynamic_cast<Gtk::MenuItem*>(
             uiManager->get_widget("/MenuBar/MenuSettings/SyncSamplerInstrumentSelection"));
         if (item) item->set_sensitive(b);
+#endif
+    }
+    {
+#if USE_GTKMM_BUILDER
+        m_actionToggleKeepPluginWindow->property_enabled() = b;
+#else
+        Gtk::MenuItem* item = dynamic_cast<Gtk::MenuItem*>(
+            uiManager->get_widget("/MenuBar/MenuSettings/KeepPluginWindow"));
+        if (item) item->set_sensitive(b);
+#endif
+    }
+    {
+#if USE_GTKMM_BUILDER
+        m_actionToggleCommitLiveEdits->property_enabled() = b;
+#else
+        Gtk::MenuItem* item = dynamic_cast<Gtk::MenuItem*>(
+            uiManager->get_widget("/MenuBar/MenuSettings/CommitLiveEditsInstantly"));
+        if (item) item->set_sensitive(b);
 #endif
     }
 }
@@ -5106,6 +5856,7 @@ void MainWindow::on_samples_to_be_removed(std::list<gig::Sample*> samples) {
          it != samples.end(); ++it)
     {
         sample_ref_count.erase(*it);
+        m_sampleHashIndex.forget(*it);
     }
 }
 
@@ -5271,14 +6022,39 @@ void MainWindow::applyMacro(Serialization::Archive& macro) {
     gig::DimensionRegion* pDimRgn = m_DimRegionChooser.get_main_dimregion();
     if (!pDimRgn) return;
 
-    for (std::set<gig::DimensionRegion*>::iterator itDimReg = dimreg_edit.dimregs.begin();
+    // compile the macro only once, instead of resolving it against each
+    // dimension region (falls back to deserialize() if not possible)
+    DimRegionPatch patch;
+    const bool bCompiled = patch.compile(macro, pDimRgn);
+
+    // announce the change once per region, instead of once per dimension
+    // region, the sampler suspends entire regions anyway
+    std::set<gig::Region*> regions;
+    for (DimRegionSet::iterator itDimReg = dimreg_edit.dimregs.begin();
          itDimReg != dimreg_edit.dimregs.end(); ++itDimReg)
     {
-        gig::DimensionRegion* pDimRgn = *itDimReg;
-        DimRegionChangeGuard(this, pDimRgn);
-        macro.deserialize(pDimRgn);
+        regions.insert((gig::Region*) (*itDimReg)->GetParent());
     }
-    //region_changed()
+    for (std::set<gig::Region*>::iterator it = regions.begin(); it != regions.end(); ++it)
+        region_to_be_changed_signal.emit(*it);
+
+    try {
+        for (DimRegionSet::iterator itDimReg = dimreg_edit.dimregs.begin();
+             itDimReg != dimreg_edit.dimregs.end(); ++itDimReg)
+        {
+            if (bCompiled)
+                patch.apply(*itDimReg);
+            else
+                macro.deserialize(*itDimReg);
+        }
+    } catch (...) {
+        for (std::set<gig::Region*>::iterator it = regions.begin(); it != regions.end(); ++it)
+            region_changed_signal.emit(*it);
+        throw;
+    }
+
+    for (std::set<gig::Region*>::iterator it = regions.begin(); it != regions.end(); ++it)
+        region_changed_signal.emit(*it);
     file_changed();
     dimreg_changed();
 }
@@ -5352,6 +6128,11 @@ sigc::signal<void, gig::Sample*>& MainWindow::signal_sample_changed() {
     return sample_changed_signal;
 }
 
+/**
+ * Like signal_sample_changed(), but additionally reports which frames of the
+ * sample's wave data were actually rewritten, so the sampler only needs to
+ * refresh its cache if its cached part of the sample is affected.
+ */
 sigc::signal<void, gig::Sample*/*old*/, gig::Sample*/*new*/>& MainWindow::signal_sample_ref_changed() {
     return sample_ref_changed_signal;
 }
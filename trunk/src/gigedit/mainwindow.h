@@ -29,6 +29,7 @@
 #endif
 
 #include "compat.h"
+#include "global.h"
 
 #include <gtkmm/box.h>
 #include <gtkmm/buttonbox.h>
@@ -63,6 +64,7 @@
 #include <glibmm/threads.h>
 #endif
 #include "ManagedWindow.h"
+#include "SampleHashIndex.h"
 
 class MainWindow;
 
@@ -153,6 +155,7 @@ class ProgressDialog : public Gtk::Dialog {
 public:
     ProgressDialog(const Glib::ustring& title, Gtk::Window& parent);
     void set_fraction(float fraction) { progressBar.set_fraction(fraction); }
+    void set_text(const Glib::ustring& text);
 protected:
     Gtk::ProgressBar progressBar;
 };
@@ -203,12 +206,79 @@ private:
     float progress;
 };
 
+/**
+ * Merges .gig files into a .gig file on a separate thread. The source files
+ * are opened, merged and closed again one after another, so only one of them
+ * is kept in memory at a time.
+ */
+class Merger : public sigc::trackable {
+public:
+    Merger(gig::File* file, const std::vector<std::string>& filenames);
+    ~Merger();
+    void launch();
+    Glib::Dispatcher& signal_progress();
+    Glib::Dispatcher& signal_finished(); ///< Finished successfully, without error.
+    Glib::Dispatcher& signal_error();
+    void progress_callback(float fraction);
+    float get_progress();
+    int get_current_file();
+    gig::File* gig;
+    const std::vector<std::string> filenames;
+    Glib::ustring error_message;
+
+private:
+    Glib::Threads::Thread* thread;
+    void thread_function();
+    void set_current_file(int index);
+    Glib::Dispatcher finished_dispatcher;
+    Glib::Dispatcher progress_dispatcher;
+    Glib::Dispatcher error_dispatcher;
+    Glib::Threads::Mutex progressMutex;
+    float progress;
+    int currentFile;
+};
+
+/**
+ * Hashes the sample data of all samples of a .gig file on a separate thread
+ * (see SampleHashIndex) and then looks up samples with identical sample data:
+ * the samples already containing the given audio files or, if no audio files
+ * are given, all duplicate samples of the .gig file.
+ */
+class SampleHasher : public sigc::trackable {
+public:
+    SampleHasher(SampleHashIndex& index, gig::File* file,
+                 const std::set<gig::Sample*>& skip,
+                 const std::vector<std::string>& audioFiles);
+    ~SampleHasher();
+    void launch();
+    Glib::Dispatcher& signal_progress();
+    Glib::Dispatcher& signal_finished();
+    float get_progress();
+    const std::vector<std::string> audioFiles;
+    std::map<std::string, gig::Sample*> existing; ///< Sample already containing the respective audio file's sample data.
+    std::vector<SampleHashIndex::Duplicates> duplicates;
+
+private:
+    Glib::Threads::Thread* thread;
+    void thread_function();
+    void progress_callback(float fraction);
+    SampleHashIndex& index;
+    gig::File* gig;
+    const std::set<gig::Sample*> skip;
+    Glib::Dispatcher finished_dispatcher;
+    Glib::Dispatcher progress_dispatcher;
+    Glib::Threads::Mutex progressMutex;
+    float progress;
+};
+
 class MainWindow : public ManagedWindow {
 public:
     MainWindow();
     virtual ~MainWindow();
     void load_file(const char* name);
     void load_instrument(gig::Instrument* instr);
+    void prepare_for_reuse();
+    void set_lock_stats(const Glib::ustring& summary, const Glib::ustring& details);
     void file_changed();
     sigc::signal<void, gig::File*>& signal_file_structure_to_be_changed();
     sigc::signal<void, gig::File*>& signal_file_structure_changed();
@@ -276,18 +346,26 @@ protected:
     Glib::RefPtr<Gio::SimpleAction> m_actionToggleShowTooltips;
     Glib::RefPtr<Gio::SimpleAction> m_actionToggleSyncSamplerSelection;
     Glib::RefPtr<Gio::SimpleAction> m_actionToggleMoveRootNoteWithRegion;
+    Glib::RefPtr<Gio::SimpleAction> m_actionToggleKeepPluginWindow;
+    Glib::RefPtr<Gio::SimpleAction> m_actionToggleCommitLiveEdits;
 #endif
 
     Gtk::Statusbar m_StatusBar;
+    Gtk::Label     m_LockStatsLabel;
     Gtk::Label     m_AttachedStateLabel;
     Gtk::Image     m_AttachedStateImage;
 
     RegionChooser m_RegionChooser;
     DimRegionChooser m_DimRegionChooser;
 
-    PropDialog propDialog;
-    InstrumentProps instrumentProps;
-    MidiRules midiRules;
+    // secondary windows, created on first use (see prop_dialog(),
+    // instrument_props() and midi_rules())
+    PropDialog* propDialog;
+    InstrumentProps* instrumentProps;
+    MidiRules* midiRules;
+    PropDialog& prop_dialog();
+    InstrumentProps& instrument_props();
+    MidiRules& midi_rules();
 
     /**
      * Ensures that the 2 signals MainWindow::dimreg_to_be_changed_signal and
@@ -333,6 +411,13 @@ protected:
     void on_saver_progress();
     void on_saver_error();
     void on_saver_finished();
+    void on_merger_progress();
+    void on_merger_error();
+    void on_merger_finished();
+    void hash_samples(const std::vector<std::string>& audioFiles,
+                      const sigc::slot<void>& finished);
+    void on_sample_hasher_progress();
+    void on_sample_hasher_finished();
     void updateMacroMenu();
     void onMacroSelected(int iMacro);
     void setupMacros();
@@ -470,6 +555,8 @@ protected:
                                    // imported
     };
     std::map<gig::Sample*, SampleImportItem> m_SampleImportQueue;
+    std::set<gig::Sample*> samplesNotImportedYet() const;
+    SampleHashIndex m_sampleHashIndex;
 
 
     void on_action_file_new();
@@ -491,6 +578,9 @@ protected:
     void on_show_tooltips_changed();
     void on_action_sync_sampler_instrument_selection();
     void on_action_move_root_note_with_region_moved();
+    void on_action_keep_plugin_window();
+    void on_action_commit_live_edits_instantly();
+    bool models_match_file(gig::File* gig);
     void on_action_help_about();
 
     void on_notebook_tab_switched(void* page, guint page_num);
@@ -508,6 +598,7 @@ protected:
     void on_action_replace_all_samples_in_all_groups();
     void on_action_remove_sample();
     void on_action_remove_unused_samples();
+    void on_action_remove_duplicate_samples();
 
     // script right-click popup actions
 #if GTKMM_MAJOR_VERSION > 3 || (GTKMM_MAJOR_VERSION == 3 && (GTKMM_MINOR_VERSION > 91 || (GTKMM_MINOR_VERSION == 91 && GTKMM_MICRO_VERSION >= 2))) // GTKMM >= 3.91.2
@@ -543,7 +634,7 @@ protected:
     void select_next_dimension();
 
     Serialization::Archive m_serializationArchive; ///< Clipboard content.
-    std::vector<Serialization::Archive> m_macros; ///< User configured list of macros.
+    std::vector<Settings::MacroInfo> m_macroIndex; ///< Index of the user configured list of macros.
 
     void copy_selected_dimrgn();
     void paste_copied_dimrgn();
@@ -571,10 +662,15 @@ protected:
     ProgressDialog* progress_dialog;
     Loader* loader;
     Saver* saver;
+    Merger* merger;
+    SampleHasher* sample_hasher;
+    ProgressDialog* sample_hasher_dialog;
+    sigc::slot<void> sample_hasher_finished;
     void load_gig(gig::File* gig, const char* filename, bool isSharedInstrument = false);
     void updateSampleRefCountMap(gig::File* gig);
 
     gig::File* file;
+    gig::File* kept_file; ///< File the models of a hidden (kept) window were built from, never dereferenced (see prepare_for_reuse()).
     bool file_is_shared;
     bool file_has_name;
     bool file_is_changed;
@@ -625,6 +721,8 @@ protected:
     void on_action_combine_instruments();
     void on_action_view_references();
     void on_action_merge_files();
+    void on_action_check_all_scripts();
+    void on_action_remove_redundant_dimensions();
     void mergeFiles(const std::vector<std::string>& filenames);
 
     void on_sample_ref_changed(gig::Sample* oldSample, gig::Sample* newSample);
@@ -632,6 +730,11 @@ protected:
     void on_samples_to_be_removed(std::list<gig::Sample*> samples);
 
     void add_or_replace_sample(bool replace);
+    void add_or_replace_sample_files(bool replace, gig::Group* group,
+                                     gig::Sample* sample,
+                                     Gtk::TreeModel::Path path,
+                                     const std::vector<std::string>& filenames);
+    void remove_duplicate_samples();
 
     void __import_queued_samples();
     void __clear();
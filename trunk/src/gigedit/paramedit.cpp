@@ -295,7 +295,8 @@ int32_t BoolEntryPlus6::get_value() const
 
 void BoolEntryPlus6::set_value(int32_t value)
 {
-    checkbutton.set_active(value < 0);
+    if (checkbutton.get_active() != (value < 0))
+        checkbutton.set_active(value < 0);
 }
 
 NumEntryPermille::NumEntryPermille(const char* labelText,
@@ -331,23 +332,18 @@ NoteEntry::NoteEntry(const char* labelText) :
 }
 
 namespace {
-    const char* notes[] = {
-        _("C"), _("C#"), _("D"), _("D#"), _("E"), _("F"),_("F#"),
-        _("G"), _("G#"), _("A"), _("A#"), _("B")
-    };
-
     int note_value(const Glib::ustring& note, double* value)
     {
         const char* str = note.c_str();
 
         int i;
         for (i = 11 ; i >= 0 ; i--) {
-            if (strncasecmp(str, notes[i], strlen(notes[i])) == 0) break;
+            if (strncasecmp(str, noteNames[i], strlen(noteNames[i])) == 0) break;
         }
         if (i >= 0) {
             char* endptr;
-            long x = strtol(str + strlen(notes[i]), &endptr, 10);
-            if (endptr != str + strlen(notes[i])) {
+            long x = strtol(str + strlen(noteNames[i]), &endptr, 10);
+            if (endptr != str + strlen(noteNames[i])) {
                 *value = std::max(0L, std::min(i + (x + 1) * 12, 127L));
                 return true;
             }
@@ -375,13 +371,6 @@ int note_value(const Glib::ustring& note)
     return value;
 }
 
-Glib::ustring note_str(int note)
-{
-    char buf[10];
-    sprintf(buf, "%s%d", notes[note % 12], note / 12 - 1);
-    return buf;
-}
-
 namespace {
     // Convert the Entry text to a number
 #if GTKMM_MAJOR_VERSION > 3 || (GTKMM_MAJOR_VERSION == 3 && (GTKMM_MINOR_VERSION > 91 || (GTKMM_MINOR_VERSION == 91 && GTKMM_MICRO_VERSION >= 2))) // GTKMM >= 3.91.2
@@ -534,7 +523,8 @@ void ChoiceEntryLeverageCtrl::set_value(gig::leverage_ctrl_t value)
         comboIndex = -1;
         break;
     }
-    combobox.set_active(comboIndex);
+    if (combobox.get_active_row_number() != comboIndex)
+        combobox.set_active(comboIndex);
 }
 
 
@@ -279,7 +279,9 @@ void ChoiceEntry<T>::set_value(T value)
     for (; row < nb_rows ; row++) {
         if (value == values[row]) break;
     }
-    combobox.set_active(row == nb_rows ? -1 : row);
+    if (row == nb_rows) row = -1;
+    if (combobox.get_active_row_number() != row)
+        combobox.set_active(row);
 }
 
 
@@ -309,7 +311,9 @@ private:
 public:
     BoolEntry(const char* labelText);
     bool get_value() const { return checkbutton.get_active(); }
-    void set_value(bool value) { checkbutton.set_active(value); }
+    void set_value(bool value) {
+        if (checkbutton.get_active() != value) checkbutton.set_active(value);
+    }
 
     void set_tip(const Glib::ustring& tip_text) {
 #ifdef OLD_TOOLTIPS
@@ -324,7 +328,7 @@ class BoolBox : public Gtk::CheckButton {
 public:
     BoolBox(const char* labelText);
     bool get_value() const { return get_active(); }
-    void set_value(bool value) { set_active(value); }
+    void set_value(bool value) { if (get_active() != value) set_active(value); }
     sigc::signal<void>& signal_value_changed() { return sig_changed; }
 protected:
     void on_show_tooltips_changed();
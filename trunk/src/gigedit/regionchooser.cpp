@@ -43,30 +43,6 @@
 #define REGION_BLOCK_HEIGHT             30
 #define KEYBOARD_HEIGHT                 40
 
-struct RegionFeatures {
-    int sampleRefs;
-    int loops;
-    int validDimRegs;
-
-    RegionFeatures() {
-        sampleRefs = loops = validDimRegs = 0;
-    }
-};
-
-static RegionFeatures regionFeatures(gig::Region* rgn) {
-    RegionFeatures f;
-    for (int i = 0; i < rgn->DimensionRegions; ++i) {
-        gig::DimensionRegion* dr = rgn->pDimensionRegions[i];
-        DimensionCase c = dimensionCaseOf(dr);
-        if (!isUsedCase(c, rgn)) continue;
-        f.validDimRegs++;
-        if (dr->pSample) f.sampleRefs++;
-        // the user doesn't care about loop if there is no valid sample reference
-        if (dr->pSample && dr->SampleLoops) f.loops++;
-    }
-    return f;
-}
-
 void SortedRegions::update(gig::Instrument* instrument) {
     // Usually, the regions in a gig file are ordered after their key
     // range, but there are files where they are not. The
@@ -102,7 +78,13 @@ RegionChooser::RegionChooser() :
     black("black"),
     m_VirtKeybModeChoice(_("Virtual Keyboard Mode")),
     currentActiveKey(-1),
-    modifyallregions(false)
+    dirtyKeyLow(-1),
+    dirtyKeyHigh(-1),
+    noteOnVelocity(-1),
+    noteOffVelocity(-1),
+    keyFlushScheduled(false),
+    modifyallregions(false),
+    dimensionManager(NULL)
 {
     set_size_request(500, KEYBOARD_HEIGHT + REGION_BLOCK_HEIGHT);
 
@@ -277,17 +259,6 @@ RegionChooser::RegionChooser() :
                Gdk::POINTER_MOTION_MASK | Gdk::POINTER_MOTION_HINT_MASK);
 #endif
 
-    dimensionManager.region_to_be_changed_signal.connect(
-        region_to_be_changed_signal.make_slot()
-    );
-    dimensionManager.region_changed_signal.connect(
-        region_changed_signal.make_slot()
-    );
-    dimensionManager.region_changed_signal.connect(
-        sigc::hide(
-            sigc::mem_fun(*this, &RegionChooser::on_dimension_manager_changed)
-        )
-    );
     keyboard_key_hit_signal.connect(
         sigc::mem_fun(*this, &RegionChooser::on_note_on_event)
     );
@@ -305,6 +276,7 @@ RegionChooser::RegionChooser() :
 
 RegionChooser::~RegionChooser()
 {
+    if (dimensionManager) delete dimensionManager;
 }
 
 void RegionChooser::on_show_tooltips_changed() {
@@ -319,26 +291,82 @@ void RegionChooser::setModifyAllRegions(bool b) {
     queue_draw();
 }
 
-void RegionChooser::invalidate_key(int key) {
+void RegionChooser::invalidate_keys(int low, int high) {
+    Glib::RefPtr<Gdk::Window> window = get_window();
+    if (!window) return;
+
     const int h = KEYBOARD_HEIGHT;
     const int w = get_width() - 1;
-    int x1 = key_to_x(key - 0.5, w);
-    int x2 = key_to_x(key + 1.5, w);
+    int x1 = key_to_x(low - 0.5, w);
+    int x2 = key_to_x(high + 1.5, w);
 
     Gdk::Rectangle rect(x1 + 1, h1 + 1, x2 - x1 - 1, h - 2);
-    get_window()->invalidate_rect(rect, false);
+    window->invalidate_rect(rect, false);
 }
 
+// Note events may arrive in fast bursts (i.e. from the sampler in live-mode),
+// so they only update the key states immediately, whereas the keyboard is
+// redrawn at most once per frame by flush_key_changes().
 void RegionChooser::on_note_on_event(int key, int velocity) {
     key_pressed[key] = true;
-    invalidate_key(key);
-    m_VirtKeybVelocityLabel.set_text(ToString(velocity));
+    noteOnVelocity = velocity;
+    schedule_key_flush(key);
 }
 
 void RegionChooser::on_note_off_event(int key, int velocity) {
     key_pressed[key] = false;
-    invalidate_key(key);
-    m_VirtKeybOffVelocityLabel.set_text(ToString(velocity));
+    noteOffVelocity = velocity;
+    schedule_key_flush(key);
+}
+
+void RegionChooser::schedule_key_flush(int key) {
+    if (dirtyKeyLow < 0 || key < dirtyKeyLow) dirtyKeyLow = key;
+    if (key > dirtyKeyHigh) dirtyKeyHigh = key;
+    if (keyFlushScheduled) return;
+    keyFlushScheduled = true;
+#if GTKMM_MAJOR_VERSION > 3 || (GTKMM_MAJOR_VERSION == 3 && GTKMM_MINOR_VERSION >= 8)
+    gtk_widget_add_tick_callback(
+        GTK_WIDGET(gobj()), &RegionChooser::on_key_flush_tick, this, NULL
+    );
+#else
+    // run before GDK's redraw idle handler of the same main loop iteration
+    Glib::signal_idle().connect(
+        sigc::mem_fun(*this, &RegionChooser::on_key_flush_idle),
+        Glib::PRIORITY_HIGH_IDLE
+    );
+#endif
+}
+
+#if GTKMM_MAJOR_VERSION > 3 || (GTKMM_MAJOR_VERSION == 3 && GTKMM_MINOR_VERSION >= 8)
+gboolean RegionChooser::on_key_flush_tick(GtkWidget* widget, GdkFrameClock* clock, gpointer data) {
+    static_cast<RegionChooser*>(data)->flush_key_changes();
+    return G_SOURCE_REMOVE;
+}
+#else
+bool RegionChooser::on_key_flush_idle() {
+    flush_key_changes();
+    return false;
+}
+#endif
+
+/**
+ * Shows all note events received since the last frame: the keys changed in
+ * the meantime are invalidated as one single area, and the velocity labels
+ * are updated with the latest velocities.
+ */
+void RegionChooser::flush_key_changes() {
+    keyFlushScheduled = false;
+    if (noteOnVelocity >= 0) {
+        m_VirtKeybVelocityLabel.set_text(ToString(noteOnVelocity));
+        noteOnVelocity = -1;
+    }
+    if (noteOffVelocity >= 0) {
+        m_VirtKeybOffVelocityLabel.set_text(ToString(noteOffVelocity));
+        noteOffVelocity = -1;
+    }
+    if (dirtyKeyLow < 0) return;
+    invalidate_keys(dirtyKeyLow, dirtyKeyHigh);
+    dirtyKeyLow = dirtyKeyHigh = -1;
 }
 
 
@@ -640,7 +668,7 @@ void RegionChooser::set_instrument(gig::Instrument* instrument)
     region = regions.first();
     queue_draw();
     region_selected();
-    dimensionManager.set_region(region);
+    update_dimension_manager();
 }
 
 bool RegionChooser::on_button_release_event(GdkEventButton* event)
@@ -788,7 +816,7 @@ bool RegionChooser::on_button_press_event(GdkEventButton* event)
             region = r;
             queue_draw();
             region_selected();
-            dimensionManager.set_region(region);
+            update_dimension_manager();
             popup_menu_inside_region->popup(event->button, event->time);
         } else {
             new_region_pos = k;
@@ -836,7 +864,7 @@ bool RegionChooser::on_button_press_event(GdkEventButton* event)
                 region = r;
                 queue_draw();
                 region_selected();
-                dimensionManager.set_region(region);
+                update_dimension_manager();
 
 #if (GTKMM_MAJOR_VERSION == 2 && GTKMM_MINOR_VERSION < 90) || GTKMM_MAJOR_VERSION < 2
                 get_window()->pointer_grab(false,
@@ -892,7 +920,7 @@ void RegionChooser::set_region(gig::Region* region) {
     this->region = region;
     queue_draw();
     region_selected();
-    dimensionManager.set_region(region);
+    update_dimension_manager();
 }
 
 void RegionChooser::select_next_region() {
@@ -1264,7 +1292,7 @@ void RegionChooser::add_region()
 
     queue_draw();
     region_selected();
-    dimensionManager.set_region(region);
+    update_dimension_manager();
     instrument_changed();
 }
 
@@ -1278,7 +1306,7 @@ void RegionChooser::delete_region()
     region = 0;
     queue_draw();
     region_selected();
-    dimensionManager.set_region(region);
+    update_dimension_manager();
     instrument_changed();
 }
 
@@ -1286,7 +1314,62 @@ void RegionChooser::manage_dimensions()
 {
     gig::Region* region = get_region();
     if (!region) return;
-    dimensionManager.show(region);
+    if (!dimensionManager) {
+        dimensionManager = new DimensionManager;
+        dimensionManager->region_to_be_changed_signal.connect(
+            region_to_be_changed_signal.make_slot()
+        );
+        dimensionManager->region_changed_signal.connect(
+            region_changed_signal.make_slot()
+        );
+        dimensionManager->region_changed_signal.connect(
+            sigc::hide(
+                sigc::mem_fun(*this, &RegionChooser::on_dimension_manager_changed)
+            )
+        );
+        dimensionManager->instrument_struct_to_be_changed_signal.connect(
+            instrument_struct_to_be_changed_signal.make_slot()
+        );
+        dimensionManager->instrument_struct_changed_signal.connect(
+            instrument_struct_changed_signal.make_slot()
+        );
+        dimensionManager->instrument_struct_changed_signal.connect(
+            sigc::hide(
+                sigc::mem_fun(*this, &RegionChooser::on_dimension_manager_changed)
+            )
+        );
+    }
+    dimensionManager->show(region);
+}
+
+// The dimension manager window is only refreshed while it is shown, since
+// show() refreshes it anyway.
+void RegionChooser::update_dimension_manager()
+{
+    if (dimensionManager && dimensionManager->get_visible())
+        dimensionManager->set_region(region);
+}
+
+void RegionChooser::hide_dimension_manager()
+{
+    if (dimensionManager) dimensionManager->hide();
+}
+
+// Called when dimensions of the current region were changed somewhere else
+// than in the dimension manager window.
+void RegionChooser::on_dimensions_changed()
+{
+    if (!dimensionManager) return;
+    dimensionManager->invalidate_stats();
+    update_dimension_manager();
+}
+
+// Called when regions of the current instrument might have been changed
+// somewhere else than in the dimension manager window, the dimension stats
+// are recalculated on the dimension manager's next refresh.
+void RegionChooser::invalidate_dimension_stats()
+{
+    if (dimensionManager) dimensionManager->invalidate_stats();
 }
 
 void RegionChooser::on_dimension_manager_changed() {
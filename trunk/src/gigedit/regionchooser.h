@@ -91,6 +91,9 @@ public:
     void set_region(gig::Region* region);
     void select_next_region();
     void select_prev_region();
+    void hide_dimension_manager();
+    void on_dimensions_changed();
+    void invalidate_dimension_stats();
 
     void on_note_on_event(int key, int velocity);
     void on_note_off_event(int key, int velocity);
@@ -140,7 +143,14 @@ protected:
     void motion_move_region(int x, int y);
     void update_after_resize();
     void update_after_move(int pos);
-    void invalidate_key(int key);
+    void invalidate_keys(int low, int high);
+    void schedule_key_flush(int key);
+    void flush_key_changes();
+#if GTKMM_MAJOR_VERSION > 3 || (GTKMM_MAJOR_VERSION == 3 && GTKMM_MINOR_VERSION >= 8)
+    static gboolean on_key_flush_tick(GtkWidget* widget, GdkFrameClock* clock, gpointer data);
+#else
+    bool on_key_flush_idle();
+#endif
     void on_show_tooltips_changed();
 
     // returns the leftmost pixel of a key
@@ -213,7 +223,13 @@ protected:
     int currentActiveKey;
     bool key_pressed[128];
 
-    DimensionManager dimensionManager;
+    // note events not yet shown on screen (see flush_key_changes())
+    int dirtyKeyLow, dirtyKeyHigh; ///< range of keys to be redrawn, -1 if none
+    int noteOnVelocity, noteOffVelocity; ///< for the velocity labels, -1 if none
+    bool keyFlushScheduled;
+
+    DimensionManager* dimensionManager; ///< Created on first use (see manage_dimensions()).
+    void update_dimension_manager();
 };
 
 #endif
@@ -13,6 +13,7 @@
 # include "MacHelper.h"
 #endif
 #include <math.h> // for log10()
+#include <set>
 
 #if !USE_LS_SCRIPTVM
 
@@ -77,6 +78,10 @@ ScriptEditor::ScriptEditor() :
     m_script = NULL;
 #if USE_LS_SCRIPTVM
     m_vm = NULL;
+    m_parseRevision = 0;
+    m_dirtyStart = 0;
+    m_dirtyEnd = -1;
+    m_charCount = 0;
 #endif
 
     if (!Settings::singleton()->autoRestoreWindowDimension) {
@@ -154,6 +159,12 @@ ScriptEditor::ScriptEditor() :
     m_preprocCommentTag->property_background() = "#e5e5e5";
     m_tagTable->add(m_preprocCommentTag);
 
+#if USE_LS_SCRIPTVM
+    m_hotTag = Gtk::TextBuffer::Tag::create();
+    m_hotTag->property_background() = "#ffd59a"; // orange
+    m_tagTable->add(m_hotTag);
+#endif
+
     m_errorTag = Gtk::TextBuffer::Tag::create();
     m_errorTag->property_background() = "#ff9393"; // red
     m_tagTable->add(m_errorTag);
@@ -166,6 +177,20 @@ ScriptEditor::ScriptEditor() :
     m_lineNrTag->property_foreground() = "#CCCCCC";
     m_tagTable->add(m_lineNrTag);
 
+#if USE_LS_SCRIPTVM
+    m_parserTags[ScriptParserThread::TAG_KEYWORD] = m_keywordTag;
+    m_parserTags[ScriptParserThread::TAG_EVENT] = m_eventTag;
+    m_parserTags[ScriptParserThread::TAG_VARIABLE] = m_variableTag;
+    m_parserTags[ScriptParserThread::TAG_FUNCTION] = m_functionTag;
+    m_parserTags[ScriptParserThread::TAG_NUMBER] = m_numberTag;
+    m_parserTags[ScriptParserThread::TAG_STRING] = m_stringTag;
+    m_parserTags[ScriptParserThread::TAG_COMMENT] = m_commentTag;
+    m_parserTags[ScriptParserThread::TAG_PREPROC] = m_preprocTag;
+    m_parserTags[ScriptParserThread::TAG_PREPROC_COMMENT] = m_preprocCommentTag;
+    m_parserTags[ScriptParserThread::TAG_ERROR] = m_errorTag;
+    m_parserTags[ScriptParserThread::TAG_WARNING] = m_warningTag;
+#endif
+
     // create menu
 #if USE_GTKMM_BUILDER
     m_actionGroup = Gio::SimpleActionGroup::create();
@@ -175,6 +200,9 @@ ScriptEditor::ScriptEditor() :
     m_actionGroup->add_action(
         "Close", sigc::mem_fun(*this, &ScriptEditor::onButtonCancel)
     );
+    m_actionGroup->add_action(
+        "EstimateCost", sigc::mem_fun(*this, &ScriptEditor::onMenuEstimateCost)
+    );
     m_actionGroup->add_action(
         "ChangeFont", sigc::mem_fun(*this, &ScriptEditor::onMenuChangeFontSize)
     );
@@ -193,6 +221,12 @@ ScriptEditor::ScriptEditor() :
         "        </item>"
         "      </section>"
         "      <section>"
+        "        <item id='EstimateCost'>"
+        "          <attribute name='label' translatable='yes'>Static _Cost Estimate (Not Measured)</attribute>"
+        "          <attribute name='action'>ScriptEditor.EstimateCost</attribute>"
+        "        </item>"
+        "      </section>"
+        "      <section>"
         "        <item id='Close'>"
         "          <attribute name='label' translatable='yes'>_Close</attribute>"
         "          <attribute name='action'>ScriptEditor.Close</attribute>"
@@ -222,6 +256,8 @@ ScriptEditor::ScriptEditor() :
     m_actionGroup->add(Gtk::Action::create("Apply", _("_Apply")),
                        Gtk::AccelKey("<control>s"),
                        sigc::mem_fun(*this, &ScriptEditor::onButtonApply));
+    m_actionGroup->add(Gtk::Action::create("EstimateCost", _("Static _Cost Estimate (Not Measured)")),
+                       sigc::mem_fun(*this, &ScriptEditor::onMenuEstimateCost));
     m_actionGroup->add(Gtk::Action::create("Close", _("_Close")),
                        Gtk::AccelKey("<control>q"),
                        sigc::mem_fun(*this, &ScriptEditor::onButtonCancel));
@@ -237,6 +273,8 @@ ScriptEditor::ScriptEditor() :
         "    <menu action='MenuScript'>"
         "      <menuitem action='Apply'/>"
         "      <separator/>"
+        "      <menuitem action='EstimateCost'/>"
+        "      <separator/>"
         "      <menuitem action='Close'/>"
         "    </menu>"
         "    <menu action='MenuEditor'>"
@@ -353,6 +391,12 @@ ScriptEditor::ScriptEditor() :
     m_textBuffer->signal_modified_changed().connect(
         sigc::mem_fun(*this, &ScriptEditor::onModifiedChanged)
     );
+
+#if USE_LS_SCRIPTVM
+    m_parser.signal_parsed().connect(
+        sigc::mem_fun(*this, &ScriptEditor::onScriptParsed)
+    );
+#endif
     
     signal_hide().connect(
         sigc::mem_fun(*this, &ScriptEditor::onWindowHide)
@@ -374,6 +418,7 @@ ScriptEditor::ScriptEditor() :
 ScriptEditor::~ScriptEditor() {
     printf("ScriptEditor destruct\n");
 #if USE_LS_SCRIPTVM
+    m_parseTimeout.disconnect();
     if (m_vm) delete m_vm;
 #endif
 }
@@ -478,10 +523,9 @@ void ScriptEditor::updateLineNumbers() {
 void ScriptEditor::onTextInserted(const Gtk::TextBuffer::iterator& itEnd, const Glib::ustring& txt, int length) {
     //printf("onTextInserted()\n");
 #if USE_LS_SCRIPTVM
-    m_textBuffer->remove_all_tags(m_textBuffer->begin(), m_textBuffer->end());
-    updateSyntaxHighlightingByVM();
-    updateParserIssuesByVM();
-    updateStatusBar();
+    // (length is in bytes, not in characters)
+    onTextChangedAt(itEnd.get_offset() - int(txt.size()), int(txt.size()));
+    scheduleParse();
 #else
     //printf("inserted %d\n", length);
     Gtk::TextBuffer::iterator itStart = itEnd;
@@ -530,116 +574,322 @@ void ScriptEditor::onTextInserted(const Gtk::TextBuffer::iterator& itEnd, const
 
 #if USE_LS_SCRIPTVM
 
+/// Delay (in ms) after the last text change before the script is parsed.
+#define PARSE_DELAY_MS 100
+
+/// Assumed amount of iterations of each while loop by the cost estimate.
+#define COST_LOOP_ITERATIONS 10
+/// Cost of a function call relative to any other token by the cost estimate.
+#define COST_FUNCTION_CALL 5
+
 LinuxSampler::ScriptVM* ScriptEditor::GetScriptVM() {
     if (!m_vm) m_vm = LinuxSampler::ScriptVMFactory::Create("gig");
     return m_vm;
 }
 
+/**
+ * Converts the line / column positions reported by the script VM into
+ * character offsets within the script text. Columns are byte positions
+ * within their line.
+ */
+class ScriptTextPositions {
+public:
+    ScriptTextPositions(const std::string& text) : text(text), totalChars(0) {
+        const char* p = text.c_str();
+        size_t begin = 0;
+        for (size_t i = 0; i <= text.size(); ++i) {
+            if (i < text.size() && text[i] != '\n') continue;
+            lineBegin.push_back(begin);
+            lineEnd.push_back(i);
+            lineChars.push_back(totalChars);
+            totalChars += g_utf8_pointer_to_offset(p + begin, p + i) + 1;
+            begin = i + 1;
+        }
+        totalChars--; // no line break after the last line
+    }
+
+    /// Character offset of the zero based @a line / byte @a column.
+    int offset(int line, int column) const {
+        if (line < 0) return 0;
+        if (line >= int(lineBegin.size())) return totalChars;
+        const char* p = text.c_str();
+        size_t byte = lineBegin[line] + std::max(column, 0);
+        if (byte > lineEnd[line]) byte = lineEnd[line];
+        return lineChars[line] + g_utf8_pointer_to_offset(p + lineBegin[line], p + byte);
+    }
+
+    int chars() const { return totalChars; }
+
+private:
+    const std::string& text;
+    std::vector<size_t> lineBegin; ///< Byte offset of each line.
+    std::vector<size_t> lineEnd; ///< Byte offset of each line's line break.
+    std::vector<int> lineChars; ///< Character offset of each line.
+    int totalChars;
+};
+
 template<class T>
-static void getIteratorsForIssue(Glib::RefPtr<Gtk::TextBuffer>& txtbuf, const T& issue, Gtk::TextBuffer::iterator& start, Gtk::TextBuffer::iterator& end) {
-    Gtk::TextBuffer::iterator itLine =
-        txtbuf->get_iter_at_line_index(issue.firstLine - 1, 0);
-    const int charsInLine = itLine.get_bytes_in_line();
-    start = txtbuf->get_iter_at_line_index(
-        issue.firstLine - 1,
-        // check we are not getting past the end of the line here, otherwise Gtk crashes
-        issue.firstColumn - 1 < charsInLine ? issue.firstColumn - 1 : charsInLine - 1
-    );
-    end = start;
-    end.forward_lines(issue.lastLine - issue.firstLine);
-    end.forward_chars(
-        (issue.lastLine != issue.firstLine)
-            ? issue.lastColumn - 1
-            : issue.lastColumn - issue.firstColumn + 1
-    );
+static void addIssueTag(std::vector<ScriptParserThread::TagRange>& tags, const ScriptTextPositions& pos,
+                        const T& issue, ScriptParserThread::tag_t tag)
+{
+    ScriptParserThread::TagRange range;
+    range.tag = tag;
+    range.start = pos.offset(issue.firstLine - 1, issue.firstColumn - 1);
+    range.end = (issue.lastLine != issue.firstLine)
+        ? pos.offset(issue.lastLine - 1, 0) + issue.lastColumn - 1
+        : range.start + issue.lastColumn - issue.firstColumn + 1;
+    range.end = std::min(range.end, pos.chars());
+    if (range.start < range.end) tags.push_back(range);
 }
 
-static void applyCodeTag(Glib::RefPtr<Gtk::TextBuffer>& txtbuf, const LinuxSampler::VMSourceToken& token, Glib::RefPtr<Gtk::TextBuffer::Tag>& tag) {
-    Gtk::TextBuffer::iterator itLine =
-        txtbuf->get_iter_at_line_index(token.firstLine(), 0);
-    const int charsInLine = itLine.get_bytes_in_line();
-    Gtk::TextBuffer::iterator itStart = txtbuf->get_iter_at_line_index(
-        token.firstLine(),
-        // check we are not getting past the end of the line here, otherwise Gtk crashes
-        token.firstColumn() < charsInLine ? token.firstColumn() : charsInLine - 1
-    );
-    Gtk::TextBuffer::iterator itEnd = itStart;
-    const int length = token.text().length();
-    itEnd.forward_chars(length);
-    txtbuf->apply_tag(tag, itStart, itEnd);
+static void addTokenTag(std::vector<ScriptParserThread::TagRange>& tags, const ScriptTextPositions& pos,
+                        const LinuxSampler::VMSourceToken& token, ScriptParserThread::tag_t tag)
+{
+    ScriptParserThread::TagRange range;
+    range.tag = tag;
+    range.start = pos.offset(token.firstLine(), token.firstColumn());
+    range.end = std::min<int>(range.start + token.text().length(), pos.chars());
+    if (range.start < range.end) tags.push_back(range);
 }
 
-static void applyCodeTag(Glib::RefPtr<Gtk::TextBuffer>& txtbuf, const LinuxSampler::ParserIssue& issue, Glib::RefPtr<Gtk::TextBuffer::Tag>& tag) {
-    Gtk::TextBuffer::iterator itStart, itEnd;
-    getIteratorsForIssue(txtbuf, issue, itStart, itEnd);
-    txtbuf->apply_tag(tag, itStart, itEnd);
+ScriptParserThread::ScriptParserThread()
+    : thread(0), quit(false), hasJob(false), hasResult(false), jobRevision(0)
+{
+#ifdef OLD_THREADS
+    thread = Glib::Thread::create(sigc::mem_fun(*this, &ScriptParserThread::thread_function), true);
+#else
+    thread = Glib::Threads::Thread::create(sigc::mem_fun(*this, &ScriptParserThread::thread_function));
+#endif
 }
 
-static void applyPreprocessorComment(Glib::RefPtr<Gtk::TextBuffer>& txtbuf, const LinuxSampler::CodeBlock& block, Glib::RefPtr<Gtk::TextBuffer::Tag>& tag) {
-    Gtk::TextBuffer::iterator itStart, itEnd;
-    getIteratorsForIssue(txtbuf, block, itStart, itEnd);
-    txtbuf->apply_tag(tag, itStart, itEnd);
+ScriptParserThread::~ScriptParserThread() {
+    {
+        Glib::Threads::Mutex::Lock lock(mutex);
+        quit = true;
+        cond.signal();
+    }
+    if (thread) thread->join();
 }
 
-void ScriptEditor::updateSyntaxHighlightingByVM() {
-    GetScriptVM();
-    const std::string s = m_textBuffer->get_text();
-    if (s.empty()) return;
-    std::vector<LinuxSampler::VMSourceToken> tokens = m_vm->syntaxHighlighting(s);
+/**
+ * Submit the given script @a text to be parsed. A text still waiting to be
+ * parsed is discarded, since it is outdated by this one.
+ */
+void ScriptParserThread::parse(const std::string& text, int revision) {
+    Glib::Threads::Mutex::Lock lock(mutex);
+    jobText = text;
+    jobRevision = revision;
+    hasJob = true;
+    cond.signal();
+}
 
-    for (int i = 0; i < tokens.size(); ++i) {
-        const LinuxSampler::VMSourceToken& token = tokens[i];
+/**
+ * Moves the latest parser result to @a result. Returns false if there was no
+ * new result since the last call.
+ */
+bool ScriptParserThread::takeResult(Result& result) {
+    Glib::Threads::Mutex::Lock lock(mutex);
+    if (!hasResult) return false;
+    std::swap(result, this->result);
+    hasResult = false;
+    return true;
+}
 
-        if (token.isKeyword()) {
-            applyCodeTag(m_textBuffer, token, m_keywordTag);
-        } else if (token.isVariableName()) {
-            applyCodeTag(m_textBuffer, token, m_variableTag);
-        } else if (token.isIdentifier()) {
-            if (token.isEventHandlerName()) {
-                applyCodeTag(m_textBuffer, token, m_eventTag);
-            } else { // a function ...
-                applyCodeTag(m_textBuffer, token, m_functionTag);
+Glib::Dispatcher& ScriptParserThread::signal_parsed() {
+    return parsed_dispatcher;
+}
+
+#if defined(WIN32) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 2))
+// make sure stack is 16-byte aligned for SSE instructions
+__attribute__((force_align_arg_pointer))
+#endif
+void ScriptParserThread::thread_function() {
+    LinuxSampler::ScriptVM* vm = LinuxSampler::ScriptVMFactory::Create("gig");
+    while (true) {
+        Result r;
+        std::string text;
+        {
+            Glib::Threads::Mutex::Lock lock(mutex);
+            while (!hasJob && !quit) cond.wait(mutex);
+            if (quit) break;
+            text.swap(jobText);
+            r.revision = jobRevision;
+            hasJob = false;
+        }
+
+        const ScriptTextPositions pos(text);
+
+        if (!text.empty()) {
+            std::vector<LinuxSampler::VMSourceToken> tokens = vm->syntaxHighlighting(text);
+            for (int i = 0; i < tokens.size(); ++i) {
+                const LinuxSampler::VMSourceToken& token = tokens[i];
+
+                if (token.isKeyword()) {
+                    addTokenTag(r.tags, pos, token, TAG_KEYWORD);
+                } else if (token.isVariableName()) {
+                    addTokenTag(r.tags, pos, token, TAG_VARIABLE);
+                } else if (token.isIdentifier()) {
+                    if (token.isEventHandlerName()) {
+                        addTokenTag(r.tags, pos, token, TAG_EVENT);
+                    } else { // a function ...
+                        addTokenTag(r.tags, pos, token, TAG_FUNCTION);
+                    }
+                } else if (token.isNumberLiteral()) {
+                    addTokenTag(r.tags, pos, token, TAG_NUMBER);
+                } else if (token.isStringLiteral()) {
+                    addTokenTag(r.tags, pos, token, TAG_STRING);
+                } else if (token.isComment()) {
+                    addTokenTag(r.tags, pos, token, TAG_COMMENT);
+                } else if (token.isPreprocessor()) {
+                    addTokenTag(r.tags, pos, token, TAG_PREPROC);
+                }
+            }
+        }
+
+        LinuxSampler::VMParserContext* parserContext = vm->loadScript(text);
+        r.issues = parserContext->issues();
+        r.errors = parserContext->errors();
+        r.warnings = parserContext->warnings();
+        r.preprocComments = parserContext->preprocessorComments();
+        delete parserContext;
+
+        if (!text.empty()) {
+            for (int i = 0; i < r.issues.size(); ++i) {
+                const LinuxSampler::ParserIssue& issue = r.issues[i];
+                if (issue.isErr())
+                    addIssueTag(r.tags, pos, issue, TAG_ERROR);
+                else if (issue.isWrn())
+                    addIssueTag(r.tags, pos, issue, TAG_WARNING);
             }
-        } else if (token.isNumberLiteral()) {
-            applyCodeTag(m_textBuffer, token, m_numberTag);
-        } else if (token.isStringLiteral()) {
-            applyCodeTag(m_textBuffer, token, m_stringTag);
-        } else if (token.isComment()) {
-            applyCodeTag(m_textBuffer, token, m_commentTag);
-        } else if (token.isPreprocessor()) {
-            applyCodeTag(m_textBuffer, token, m_preprocTag);
-        } else if (token.isNewLine()) {
         }
+        for (int i = 0; i < r.preprocComments.size(); ++i)
+            addIssueTag(r.tags, pos, r.preprocComments[i], TAG_PREPROC_COMMENT);
+
+        {
+            Glib::Threads::Mutex::Lock lock(mutex);
+            // don't bother the GUI thread if this result is already outdated
+            if (hasJob) continue;
+            std::swap(result, r);
+            hasResult = true;
+        }
+        parsed_dispatcher.emit();
     }
+    delete vm;
 }
 
-void ScriptEditor::updateParserIssuesByVM() {
-    GetScriptVM();
-    const std::string s = m_textBuffer->get_text();
-    LinuxSampler::VMParserContext* parserContext = m_vm->loadScript(s);
-    m_issues = parserContext->issues();
-    m_errors = parserContext->errors();
-    m_warnings = parserContext->warnings();
-    m_preprocComments = parserContext->preprocessorComments();
-
-    if (!s.empty()) {
-        for (int i = 0; i < m_issues.size(); ++i) {
-            const LinuxSampler::ParserIssue& issue = m_issues[i];
-
-            if (issue.isErr()) {
-                applyCodeTag(m_textBuffer, issue, m_errorTag);
-            } else if (issue.isWrn()) {
-                applyCodeTag(m_textBuffer, issue, m_warningTag);
-            }
+/**
+ * Called on every text change: (re)starts the timeout after which the
+ * current script text will be handed over to the parser thread.
+ */
+void ScriptEditor::scheduleParse() {
+    ++m_parseRevision;
+    // cost estimate is outdated now
+    if (!m_lineCosts.empty()) {
+        m_lineCosts.clear();
+        m_textBuffer->remove_tag(m_hotTag, m_textBuffer->begin(), m_textBuffer->end());
+    }
+    m_parseTimeout.disconnect();
+    m_parseTimeout = Glib::signal_timeout().connect(
+        sigc::mem_fun(*this, &ScriptEditor::onParseTimeout), PARSE_DELAY_MS
+    );
+}
+
+bool ScriptEditor::onParseTimeout() {
+    m_parser.parse(m_textBuffer->get_text(), m_parseRevision);
+    return false; // one-shot
+}
+
+void ScriptEditor::onScriptParsed() {
+    ScriptParserThread::Result result;
+    if (!m_parser.takeResult(result)) return;
+    // ignore results for outdated texts, a new parser run is pending already
+    if (result.revision != m_parseRevision) return;
+
+    applyParserTags(result.tags);
+    m_issues.swap(result.issues);
+    m_errors.swap(result.errors);
+    m_warnings.swap(result.warnings);
+    m_preprocComments.swap(result.preprocComments);
+    updateStatusBar();
+}
+
+/**
+ * Updates the text tags of the text buffer to the ones given by @a tags.
+ * The previously applied tags are compared with the new ones, and only the
+ * text range covering tags which differ (and the text edited in the
+ * meantime) is retagged, which avoids scanning the entire script for each
+ * tag and the text view having to re-layout it after each keystroke.
+ */
+void ScriptEditor::applyParserTags(const std::vector<ScriptParserThread::TagRange>& tags) {
+    typedef std::set<ScriptParserThread::TagRange> TagSet;
+    const TagSet wanted(tags.begin(), tags.end());
+    const TagSet applied(m_appliedTags.begin(), m_appliedTags.end());
+    for (TagSet::const_iterator it = wanted.begin(); it != wanted.end(); ++it)
+        if (!applied.count(*it)) markDirty(it->start, it->end);
+    for (TagSet::const_iterator it = applied.begin(); it != applied.end(); ++it)
+        if (!wanted.count(*it)) markDirty(it->start, it->end);
+
+    const int dirtyStart = m_dirtyStart;
+    const int dirtyEnd = std::min(m_dirtyEnd, m_textBuffer->get_char_count());
+    if (dirtyStart < dirtyEnd) {
+        const Gtk::TextBuffer::iterator itStart = m_textBuffer->get_iter_at_offset(dirtyStart);
+        const Gtk::TextBuffer::iterator itEnd = m_textBuffer->get_iter_at_offset(dirtyEnd);
+        for (int t = 0; t < ScriptParserThread::TAG_COUNT; ++t)
+            m_textBuffer->remove_tag(m_parserTags[t], itStart, itEnd);
+        for (TagSet::const_iterator it = wanted.begin(); it != wanted.end(); ++it) {
+            const int start = std::max(it->start, dirtyStart);
+            const int end = std::min(it->end, dirtyEnd);
+            if (start >= end) continue;
+            m_textBuffer->apply_tag(
+                m_parserTags[it->tag],
+                m_textBuffer->get_iter_at_offset(start),
+                m_textBuffer->get_iter_at_offset(end)
+            );
         }
     }
 
-    for (int i = 0; i < m_preprocComments.size(); ++i) {
-        applyPreprocessorComment(m_textBuffer, m_preprocComments[i],
-                                 m_preprocCommentTag);
+    m_appliedTags.assign(wanted.begin(), wanted.end());
+    m_dirtyStart = 0;
+    m_dirtyEnd = -1;
+}
+
+// Maps character offset @a pos from before to after a text change, where
+// @a delta characters were inserted (> 0) or erased (< 0) at @a offset.
+static int mapOffset(int pos, int offset, int delta) {
+    if (pos < offset) return pos;
+    if (delta < 0 && pos < offset - delta) return offset; // inside erased text
+    return pos + delta;
+}
+
+/**
+ * Called on every text change: moves the applied parser tags and the dirty
+ * range along with the text, and marks the changed text as dirty.
+ */
+void ScriptEditor::onTextChangedAt(int offset, int delta) {
+    m_charCount += delta;
+    size_t n = 0;
+    for (size_t i = 0; i < m_appliedTags.size(); ++i) {
+        ScriptParserThread::TagRange range = m_appliedTags[i];
+        range.start = mapOffset(range.start, offset, delta);
+        range.end = mapOffset(range.end, offset, delta);
+        if (range.start < range.end) m_appliedTags[n++] = range;
+    }
+    m_appliedTags.resize(n);
+    if (m_dirtyStart <= m_dirtyEnd) {
+        m_dirtyStart = mapOffset(m_dirtyStart, offset, delta);
+        m_dirtyEnd = mapOffset(m_dirtyEnd, offset, delta);
     }
+    markDirty(offset, offset + std::max(delta, 0));
+}
 
-    delete parserContext;
+void ScriptEditor::markDirty(int start, int end) {
+    if (m_dirtyStart > m_dirtyEnd) {
+        m_dirtyStart = start;
+        m_dirtyEnd = end;
+    } else {
+        m_dirtyStart = std::min(m_dirtyStart, start);
+        m_dirtyEnd = std::max(m_dirtyEnd, end);
+    }
 }
 
 void ScriptEditor::updateIssueTooltip(GdkEventMotion* e) {
@@ -689,6 +939,17 @@ void ScriptEditor::updateIssueTooltip(GdkEventMotion* e) {
         }
     }
 
+    std::map<int,int>::const_iterator itCost = m_lineCosts.find(line);
+    if (itCost != m_lineCosts.end() && it.has_tag(m_hotTag)) {
+        m_textView.set_tooltip_markup(
+            "Static estimate of this line's relative cost per event handler call: " +
+            ToString(itCost->second) +
+            " (not measured, assumes " + ToString(COST_LOOP_ITERATIONS) +
+            " iterations per while loop)"
+        );
+        return;
+    }
+
     m_textView.set_tooltip_markup("");
 }
 
@@ -737,10 +998,8 @@ void ScriptEditor::updateStatusBar() {
 void ScriptEditor::onTextErased(const Gtk::TextBuffer::iterator& itStart, const Gtk::TextBuffer::iterator& itEnd) {
     //printf("erased\n");
 #if USE_LS_SCRIPTVM
-    m_textBuffer->remove_all_tags(m_textBuffer->begin(), m_textBuffer->end());
-    updateSyntaxHighlightingByVM();
-    updateParserIssuesByVM();
-    updateStatusBar();
+    onTextChangedAt(itStart.get_offset(), m_textBuffer->get_char_count() - m_charCount);
+    scheduleParse();
 #else
     Gtk::TextBuffer::iterator itStart2 = itStart;
     if (itStart2.inside_word() || itStart2.ends_word())
@@ -767,6 +1026,92 @@ bool ScriptEditor::on_motion_notify_event(GdkEventMotion* e) {
 #endif
 }
 
+/**
+ * Estimates the relative CPU cost of each event handler of the script and
+ * highlights the lines causing most of it.
+ *
+ * Event handlers of instrument scripts can only be executed by a sampler
+ * engine for real note events, so this is a static estimate: each token of
+ * an event handler costs 1 (function calls COST_FUNCTION_CALL), multiplied
+ * by COST_LOOP_ITERATIONS for each while loop the token is nested in.
+ */
+void ScriptEditor::onMenuEstimateCost() {
+#if USE_LS_SCRIPTVM
+    const std::string s = m_textBuffer->get_text();
+    std::vector<LinuxSampler::VMSourceToken> tokens = GetScriptVM()->syntaxHighlighting(s);
+
+    std::vector<std::string> handlerNames;
+    std::vector<int> handlerCosts;
+    std::map<int,int> lineHandler;
+    std::map<int,int> lineCosts;
+    std::string prevKeyword;
+    bool inHandler = false;
+    int loopDepth = 0;
+
+    for (int i = 0; i < tokens.size(); ++i) {
+        const LinuxSampler::VMSourceToken& token = tokens[i];
+        if (token.isKeyword()) {
+            const std::string keyword = token.text();
+            if (prevKeyword == "end") {
+                if (keyword == "while" && loopDepth > 0) --loopDepth;
+                else if (keyword == "on") inHandler = false;
+            } else if (keyword == "while") {
+                ++loopDepth; // loop condition is evaluated on each iteration
+            }
+            prevKeyword = keyword;
+        } else if (token.isEventHandlerName() && prevKeyword == "on") {
+            handlerNames.push_back(token.text());
+            handlerCosts.push_back(0);
+            inHandler = true;
+            loopDepth = 0;
+            continue;
+        }
+        if (!inHandler || token.isNewLine() || token.isComment() ||
+            trim(token.text()).empty()) continue;
+
+        int cost = (token.isIdentifier() && !token.isEventHandlerName())
+                 ? COST_FUNCTION_CALL : 1;
+        for (int d = 0; d < loopDepth; ++d)
+            cost *= COST_LOOP_ITERATIONS;
+        lineCosts[token.firstLine()] += cost;
+        lineHandler[token.firstLine()] = handlerCosts.size() - 1;
+        handlerCosts.back() += cost;
+    }
+
+    // highlight lines executed repeatedly which cause at least 10% of their
+    // event handler's cost
+    m_textBuffer->remove_tag(m_hotTag, m_textBuffer->begin(), m_textBuffer->end());
+    m_lineCosts.clear();
+    for (std::map<int,int>::iterator it = lineCosts.begin(); it != lineCosts.end(); ++it) {
+        const int handlerCost = handlerCosts[lineHandler[it->first]];
+        if (it->second < COST_LOOP_ITERATIONS || it->second * 10 < handlerCost)
+            continue;
+        Gtk::TextBuffer::iterator itStart = m_textBuffer->get_iter_at_line(it->first);
+        Gtk::TextBuffer::iterator itEnd = itStart;
+        itEnd.forward_to_line_end();
+        m_textBuffer->apply_tag(m_hotTag, itStart, itEnd);
+        m_lineCosts[it->first] = it->second;
+    }
+
+    std::string txt;
+    for (int i = 0; i < handlerNames.size(); ++i) {
+        if (i) txt += ", ";
+        txt += "<b>" + handlerNames[i] + "</b> " + ToString(handlerCosts[i]);
+    }
+    m_statusLabel.set_markup(
+        handlerNames.empty()
+            ? std::string("No event handler in this script.")
+            : "Static estimate (not measured) of relative cost per event handler call: " + txt
+    );
+#else
+    Gtk::MessageDialog msg(
+        *this, _("Estimating script cost requires gigedit to be compiled with liblinuxsampler support."),
+        false, Gtk::MESSAGE_ERROR
+    );
+    msg.run();
+#endif
+}
+
 void ScriptEditor::onMenuChangeFontSize() {
     //TODO: for GTKMM >= 3.2 class Gtk::FontChooser could be used instead
     Gtk::Dialog dialog(_("Font Size"), true /*modal*/);
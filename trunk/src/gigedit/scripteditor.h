@@ -23,6 +23,7 @@
 # include <config.h>
 #endif
 #include "compat.h"
+#include "global.h" // for Glib::Threads with old glibmm versions
 
 #if USE_GTKMM_BUILDER
 # include <gtkmm/builder.h>
@@ -37,6 +38,7 @@
 #endif
 
 #include "ManagedWindow.h"
+#include <map>
 
 // Should we use a very simple (and buggy) local NKSP syntax parser, or should
 // we rather use the full featured NKSP syntax highlighting backend from
@@ -55,6 +57,78 @@
 # endif
 #endif
 
+#if USE_LS_SCRIPTVM
+
+/**
+ * Runs the NKSP parser of liblinuxsampler on a separate thread, so that
+ * typing in the script editor never has to wait for a complete parser run.
+ * Only the most recently submitted script text is parsed; texts submitted
+ * while the parser is still busy replace each other, so outdated texts are
+ * never parsed at all.
+ */
+class ScriptParserThread : public sigc::trackable {
+public:
+    /// Text tags assigned by the parser, see TagRange.
+    enum tag_t {
+        TAG_KEYWORD,
+        TAG_EVENT,
+        TAG_VARIABLE,
+        TAG_FUNCTION,
+        TAG_NUMBER,
+        TAG_STRING,
+        TAG_COMMENT,
+        TAG_PREPROC,
+        TAG_PREPROC_COMMENT,
+        TAG_ERROR,
+        TAG_WARNING,
+        TAG_COUNT
+    };
+
+    /// A text tag spanning character offsets [start, end) of the script.
+    struct TagRange {
+        tag_t tag;
+        int start;
+        int end;
+
+        bool operator<(const TagRange& o) const {
+            if (tag != o.tag) return tag < o.tag;
+            if (start != o.start) return start < o.start;
+            return end < o.end;
+        }
+    };
+
+    struct Result {
+        int revision; ///< Revision of the script text this result belongs to.
+        std::vector<TagRange> tags;
+        std::vector<LinuxSampler::ParserIssue> issues;
+        std::vector<LinuxSampler::ParserIssue> errors;
+        std::vector<LinuxSampler::ParserIssue> warnings;
+        std::vector<LinuxSampler::CodeBlock> preprocComments;
+    };
+
+    ScriptParserThread();
+   ~ScriptParserThread();
+    void parse(const std::string& text, int revision);
+    bool takeResult(Result& result);
+    Glib::Dispatcher& signal_parsed(); ///< Emitted on the GUI thread when a new Result is available.
+
+private:
+    Glib::Threads::Thread* thread;
+    Glib::Threads::Mutex mutex;
+    Glib::Threads::Cond cond;
+    Glib::Dispatcher parsed_dispatcher;
+    bool quit;
+    bool hasJob;
+    bool hasResult;
+    std::string jobText;
+    int jobRevision;
+    Result result;
+
+    void thread_function();
+};
+
+#endif // USE_LS_SCRIPTVM
+
 class ScriptEditor : public ManagedWindow {
 public:
     ScriptEditor();
@@ -122,10 +196,20 @@ protected:
     gig::Script* m_script;
 #if USE_LS_SCRIPTVM
     LinuxSampler::ScriptVM* m_vm;
+    ScriptParserThread m_parser;
+    Glib::RefPtr<Gtk::TextBuffer::Tag> m_parserTags[ScriptParserThread::TAG_COUNT];
+    int m_parseRevision;
+    sigc::connection m_parseTimeout;
+    Glib::RefPtr<Gtk::TextBuffer::Tag> m_hotTag;
+    std::map<int,int> m_lineCosts; ///< Estimated cost of lines highlighted by m_hotTag (key: line).
     std::vector<LinuxSampler::ParserIssue> m_issues;
     std::vector<LinuxSampler::ParserIssue> m_errors;
     std::vector<LinuxSampler::ParserIssue> m_warnings;
     std::vector<LinuxSampler::CodeBlock> m_preprocComments;
+    std::vector<ScriptParserThread::TagRange> m_appliedTags; ///< Parser tags currently applied to the text buffer (offsets kept up to date on text changes).
+    int m_dirtyStart; ///< Begin of the text changed since parser tags were applied last time.
+    int m_dirtyEnd; ///< End of the text changed since then (nothing changed if m_dirtyStart > m_dirtyEnd).
+    int m_charCount; ///< Length of the text, required to know the amount of erased characters.
 #endif
 
     bool isModified() const;
@@ -136,8 +220,12 @@ protected:
     void onTextErased(const Gtk::TextBuffer::iterator& itStart, const Gtk::TextBuffer::iterator& itEnd);
     void onModifiedChanged();
 #if USE_LS_SCRIPTVM
-    void updateSyntaxHighlightingByVM();
-    void updateParserIssuesByVM();
+    void scheduleParse();
+    bool onParseTimeout();
+    void onScriptParsed();
+    void applyParserTags(const std::vector<ScriptParserThread::TagRange>& tags);
+    void onTextChangedAt(int offset, int delta);
+    void markDirty(int start, int end);
     LinuxSampler::ScriptVM* GetScriptVM();
     void updateIssueTooltip(GdkEventMotion* e);
     void updateStatusBar();
@@ -148,6 +236,7 @@ protected:
 #endif
     bool onWindowDeleteP(GdkEventAny* e);
     void onMenuChangeFontSize();
+    void onMenuEstimateCost();
     int  currentFontSize() const;
     void setFontSize(int size, bool save);
     void updateLineNumbers();
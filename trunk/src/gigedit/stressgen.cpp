@@ -0,0 +1,97 @@
+/*
+    Copyright (c) 2026 The gigedit developers
+
+    This file is part of "gigedit" and released under the terms of the
+    GNU General Public License version 2.
+*/
+
+// Generates reproducible large .gig files for performance testing (loading,
+// saving, combining and GUI profiling), see SyntheticGig.
+
+#include "global.h"
+#include "SyntheticGig.h"
+
+#include <iostream>
+#include <stdlib.h>
+
+static void usage() {
+    std::cerr <<
+        "usage: gigedit-stressgen [OPTIONS] OUTPUT.gig\n"
+        "\n"
+        "  --preset small|medium|large  standard input size (default: small)\n"
+        "  --instruments N              amount of instruments\n"
+        "  --regions N                  regions per instrument (1..128)\n"
+        "  --dimensions N               dimensions per region (0..8)\n"
+        "  --samples N                  amount of samples\n"
+        "  --frames N                   sample points per sample\n"
+        "  --scripts N                  amount of instrument scripts\n"
+        "  --seed N                     seed of the pseudo-random content\n"
+        "\n"
+        "Options are applied in the given order, so size options given after\n"
+        "--preset override the preset's values.\n";
+}
+
+int main(int argc, char* argv[]) {
+    SyntheticGig::Params params;
+    std::string output;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg[0] != '-') {
+            if (!output.empty()) {
+                usage();
+                return 2;
+            }
+            output = arg;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage();
+            return 2;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--preset") {
+            if (!SyntheticGig::preset(value, params)) {
+                std::cerr << "Unknown preset '" << value << "'" << std::endl;
+                return 2;
+            }
+        } else if (arg == "--instruments")
+            params.instruments = atoi(value.c_str());
+        else if (arg == "--regions")
+            params.regions = atoi(value.c_str());
+        else if (arg == "--dimensions")
+            params.dimensions = atoi(value.c_str());
+        else if (arg == "--samples")
+            params.samples = atoi(value.c_str());
+        else if (arg == "--frames")
+            params.sampleFrames = atoi(value.c_str());
+        else if (arg == "--scripts")
+            params.scripts = atoi(value.c_str());
+        else if (arg == "--seed")
+            params.seed = strtoul(value.c_str(), NULL, 0);
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if (output.empty()) {
+        usage();
+        return 2;
+    }
+
+    const gint64 t0 = g_get_monotonic_time();
+    try {
+        SyntheticGig::create(output, params);
+    } catch (RIFF::Exception e) {
+        std::cerr << e.Message << std::endl;
+        return 1;
+    }
+    std::cout << output << ": "
+              << params.instruments << " instruments, "
+              << params.regions << " regions per instrument, "
+              << params.dimensions << " dimensions per region, "
+              << params.samples << " samples of " << params.sampleFrames
+              << " sample points, " << params.scripts << " scripts, seed "
+              << params.seed << " (" << (g_get_monotonic_time() - t0) / 1000
+              << " ms)" << std::endl;
+    return 0;
+}
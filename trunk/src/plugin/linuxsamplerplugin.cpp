@@ -31,6 +31,7 @@
 
 #include "../gigedit/gigedit.h"
 #include "../gigedit/global.h"
+#include "../gigedit/Settings.h"
 
 #include <iostream>
 #ifdef SIGCPP_HEADER_FILE
@@ -39,27 +40,87 @@
 # include <sigc++/bind.h>
 #endif
 #include <glibmm/main.h>
+#include <glibmm/miscutils.h>
+#include <glibmm/fileutils.h>
 #include <set>
+#include <map>
 
 REGISTER_INSTRUMENT_EDITOR(LinuxSamplerPlugin)
 
-struct LSPluginPrivate {
-    std::set<gig::Region*> debounceRegionChange;
-    bool debounceRegionChangedScheduled;
+// polling interval for note events from the sampler (in ms): we start polling
+// fast as soon as notes are changing and slowly back off when it's quiet again
+#define POLL_PERIOD_MIN  16  /* about one frame */
+#define POLL_PERIOD_MAX 100
 
-    LSPluginPrivate() {
-        debounceRegionChangedScheduled = false;
+/**
+ * Histogram of the durations the sampler was blocked by gigedit for one
+ * particular kind of data structure, that is the time between sending a
+ * "to be changed" notification and its "changed" counterpart.
+ */
+class LockStats {
+public:
+    LockStats() : count(0), max(0) {
+        for (int i = 0; i < BUCKETS; ++i) buckets[i] = 0;
+    }
+
+    void add(gint64 us) {
+        int i = 0;
+        for (gint64 v = us; v > 1 && i < BUCKETS - 1; v >>= 1) ++i;
+        buckets[i]++;
+        count++;
+        if (us > max) max = us;
+    }
+
+    /// Returns (an upper bound of) the given percentile (0.0 .. 1.0) in us.
+    gint64 percentile(double p) const {
+        if (!count) return 0;
+        const gint64 n = gint64(p * count + 0.5);
+        gint64 sum = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            sum += buckets[i];
+            if (sum >= n) return std::min(gint64(2) << i, max);
+        }
+        return max;
+    }
+
+    gint64 count;
+    gint64 max;
+
+private:
+    enum { BUCKETS = 40 }; ///< bucket i counts durations of about 2^i us
+    gint64 buckets[BUCKETS];
+};
+
+struct LockEvent {
+    String type;
+    gint64 begin; ///< monotonic time in us
+    gint64 duration; ///< in us
+};
+
+struct LSPluginPrivate {
+    DimRegionChangeDebouncer dimRgnDebouncer;
+    sigc::connection pollConnection;
+    int pollPeriod;
+    std::map<std::pair<void*,String>, gint64> lockBegin;
+    std::map<String, LockStats> lockStats;
+    std::vector<LockEvent> lockEvents; ///< only recorded if GIGEDIT_LOCK_STATS_CSV is set
+
+    LSPluginPrivate(DimRegionChangeDebouncer::Host& host) : dimRgnDebouncer(host) {
+        pollPeriod = POLL_PERIOD_MAX;
     }
 };
 
 LinuxSamplerPlugin::LinuxSamplerPlugin() {
     pApp = new GigEdit;
-    priv = new LSPluginPrivate;
+    priv = new LSPluginPrivate(*this);
 }
 
 LinuxSamplerPlugin::~LinuxSamplerPlugin() {
     if (pApp) delete static_cast<GigEdit*>(pApp);
-    if (priv) delete priv;
+    if (priv) {
+        priv->pollConnection.disconnect();
+        delete priv;
+    }
 }
 
 int LinuxSamplerPlugin::Main(void* pInstrument, String sTypeName, String sTypeVersion, void* /*pUserData*/) {
@@ -75,7 +136,7 @@ int LinuxSamplerPlugin::Main(void* pInstrument, String sTypeName, String sTypeVe
     app->signal_file_structure_to_be_changed().connect(
         sigc::bind(
             sigc::mem_fun(
-                *this, &LinuxSamplerPlugin::NotifyDataStructureToBeChanged
+                *this, &LinuxSamplerPlugin::__notifyDataStructureToBeChanged
             ),
             "gig::File"
         )
@@ -83,7 +144,7 @@ int LinuxSamplerPlugin::Main(void* pInstrument, String sTypeName, String sTypeVe
     app->signal_file_structure_changed().connect(
         sigc::bind(
             sigc::mem_fun(
-                *this, &LinuxSamplerPlugin::NotifyDataStructureChanged
+                *this, &LinuxSamplerPlugin::__notifyDataStructureChanged
             ),
             "gig::File"
         )
@@ -92,12 +153,12 @@ int LinuxSamplerPlugin::Main(void* pInstrument, String sTypeName, String sTypeVe
         sigc::mem_fun(*this, &LinuxSamplerPlugin::__onSamplesToBeRemoved)
     );
     app->signal_samples_removed().connect(
-        sigc::mem_fun(*this, &LinuxSamplerPlugin::NotifySamplesRemoved)
+        sigc::mem_fun(*this, &LinuxSamplerPlugin::__notifySamplesRemoved)
     );
     app->signal_region_to_be_changed().connect(
         sigc::bind(
             sigc::mem_fun(
-                *this, &LinuxSamplerPlugin::NotifyDataStructureToBeChanged
+                *this, &LinuxSamplerPlugin::__notifyDataStructureToBeChanged
             ),
             "gig::Region"
         )
@@ -105,7 +166,7 @@ int LinuxSamplerPlugin::Main(void* pInstrument, String sTypeName, String sTypeVe
     app->signal_region_changed().connect(
         sigc::bind(
             sigc::mem_fun(
-                *this, &LinuxSamplerPlugin::NotifyDataStructureChanged
+                *this, &LinuxSamplerPlugin::__notifyDataStructureChanged
             ),
             "gig::Region"
         )
@@ -130,7 +191,7 @@ int LinuxSamplerPlugin::Main(void* pInstrument, String sTypeName, String sTypeVe
             "gig::DimensionRegion"
         )*/
         // ... because we are doing some event debouncing here :
-        sigc::mem_fun(*this, &LinuxSamplerPlugin::__onDimRegionChanged)
+        sigc::mem_fun(priv->dimRgnDebouncer, &DimRegionChangeDebouncer::dimRegionChanged)
     );
     app->signal_sample_changed().connect(
         sigc::bind(
@@ -156,7 +217,7 @@ int LinuxSamplerPlugin::Main(void* pInstrument, String sTypeName, String sTypeVe
     app->signal_script_to_be_changed.connect(
         sigc::bind(
             sigc::mem_fun(
-                *this, &LinuxSamplerPlugin::NotifyDataStructureToBeChanged
+                *this, &LinuxSamplerPlugin::__notifyDataStructureToBeChanged
             ),
             "gig::Script"
         )
@@ -164,7 +225,7 @@ int LinuxSamplerPlugin::Main(void* pInstrument, String sTypeName, String sTypeVe
     app->signal_script_changed.connect(
         sigc::bind(
             sigc::mem_fun(
-                *this, &LinuxSamplerPlugin::NotifyDataStructureChanged
+                *this, &LinuxSamplerPlugin::__notifyDataStructureChanged
             ),
             "gig::Script"
         )
@@ -174,15 +235,108 @@ int LinuxSamplerPlugin::Main(void* pInstrument, String sTypeName, String sTypeVe
     // the sampler periodically for MIDI events (I HOPE it works on all
     // archs, because gigedit is actually running in another thread than
     // the one that is calling this timeout handler register code)
-    const Glib::RefPtr<Glib::TimeoutSource> timeout_source =
-        Glib::TimeoutSource::create(100); // poll every 100ms
-    timeout_source->connect(
-        sigc::mem_fun(this, &LinuxSamplerPlugin::__onPollPeriod)
-    );
-    timeout_source->attach(Glib::MainContext::get_default());
+    if (!priv->pollConnection.connected())
+        __schedulePoll(POLL_PERIOD_MAX);
 
     // run gigedit application
-    return app->run(pGigInstr);
+    const int result = app->run(pGigInstr);
+    __dumpLockStats();
+    return result;
+}
+
+void LinuxSamplerPlugin::__notifyDataStructureToBeChanged(void* pStruct, String sStructType) {
+    NotifyDataStructureToBeChanged(pStruct, sStructType);
+    __lockBegin(pStruct, sStructType);
+}
+
+void LinuxSamplerPlugin::__notifyDataStructureChanged(void* pStruct, String sStructType) {
+    __lockEnd(pStruct, sStructType);
+    NotifyDataStructureChanged(pStruct, sStructType);
+}
+
+void LinuxSamplerPlugin::__notifySamplesToBeRemoved(std::set<void*> Samples) {
+    NotifySamplesToBeRemoved(Samples);
+    __lockBegin(NULL, "gig::Sample");
+}
+
+void LinuxSamplerPlugin::__notifySamplesRemoved() {
+    __lockEnd(NULL, "gig::Sample");
+    NotifySamplesRemoved();
+}
+
+// The time is taken after the sampler returned from the "to be changed"
+// notification, since from then on the sampler is actually blocked.
+void LinuxSamplerPlugin::__lockBegin(void* pStruct, const String& sStructType) {
+    const std::pair<void*,String> key(pStruct, sStructType);
+    if (!priv->lockBegin.count(key))
+        priv->lockBegin[key] = g_get_monotonic_time();
+}
+
+void LinuxSamplerPlugin::__lockEnd(void* pStruct, const String& sStructType) {
+    std::map<std::pair<void*,String>, gint64>::iterator it =
+        priv->lockBegin.find(std::make_pair(pStruct, sStructType));
+    if (it == priv->lockBegin.end()) return; // i.e. a sole "changed" notification
+    LockEvent event;
+    event.type = sStructType;
+    event.begin = it->second;
+    event.duration = g_get_monotonic_time() - it->second;
+    priv->lockBegin.erase(it);
+    priv->lockStats[sStructType].add(event.duration);
+    if (!Glib::getenv("GIGEDIT_LOCK_STATS_CSV").empty())
+        priv->lockEvents.push_back(event);
+    __showLockStats(sStructType);
+}
+
+static String lockStatsText(String sStructType, const LockStats& stats) {
+    // "gig::Region" -> "Region"
+    const size_t pos = sStructType.rfind(':');
+    if (pos != String::npos) sStructType = sStructType.substr(pos + 1);
+    char buf[128];
+    snprintf(buf, sizeof(buf), "%s: %.1f / %.1f / %.1f ms",
+             sStructType.c_str(), stats.percentile(0.5) / 1000.0,
+             stats.percentile(0.99) / 1000.0, stats.max / 1000.0);
+    return buf;
+}
+
+void LinuxSamplerPlugin::__showLockStats(const String& sStructType) {
+    GigEdit* app = static_cast<GigEdit*>(pApp);
+    String details = _("Sampler blocked by changes (p50 / p99 / max):");
+    for (std::map<String, LockStats>::const_iterator it = priv->lockStats.begin();
+         it != priv->lockStats.end(); ++it)
+    {
+        details += "\n" + lockStatsText(it->first, it->second) +
+                   " (" + ToString(it->second.count) + "x)";
+    }
+    if (priv->dimRgnDebouncer.changeEvents()) {
+        details += "\n" + ToString(priv->dimRgnDebouncer.changeEvents()) + " " +
+                   _("dimension region changes sent as") + " " +
+                   ToString(priv->dimRgnDebouncer.regionNotifications()) + " " +
+                   _("region notifications");
+    }
+    app->set_lock_stats(
+        lockStatsText(sStructType, priv->lockStats[sStructType]), details
+    );
+}
+
+// Appends all lock durations recorded so far to the CSV file given by
+// environment variable GIGEDIT_LOCK_STATS_CSV (if set).
+void LinuxSamplerPlugin::__dumpLockStats() {
+    const std::string filename = Glib::getenv("GIGEDIT_LOCK_STATS_CSV");
+    if (filename.empty() || priv->lockEvents.empty()) return;
+    const bool bNewFile = !Glib::file_test(filename, Glib::FILE_TEST_EXISTS);
+    FILE* f = fopen(filename.c_str(), "a");
+    if (!f) {
+        std::cerr << "Could not open lock stats file '" << filename << "'\n";
+        return;
+    }
+    if (bNewFile) fprintf(f, "type,begin_us,duration_us\n");
+    for (size_t i = 0; i < priv->lockEvents.size(); ++i) {
+        const LockEvent& e = priv->lockEvents[i];
+        fprintf(f, "%s,%lld,%lld\n", e.type.c_str(),
+                (long long) e.begin, (long long) e.duration);
+    }
+    fclose(f);
+    priv->lockEvents.clear();
 }
 
 void LinuxSamplerPlugin::__onDimRegionToBeChanged(gig::DimensionRegion* pDimRgn) {
@@ -192,63 +346,55 @@ void LinuxSamplerPlugin::__onDimRegionToBeChanged(gig::DimensionRegion* pDimRgn)
     // ... we are rather debouncing those dimregion to be changed events, and
     // instead only send a region to be changed event, which is much faster when
     // changing a very large amount of dimregions.
-    if (!pDimRgn) return;
-    gig::Region* pRegion = (gig::Region*) pDimRgn->GetParent();
-    const bool bIdle = priv->debounceRegionChange.empty();
-    bool bRegionLocked = priv->debounceRegionChange.count(pRegion);
-    if (!bRegionLocked) {
-        if (bIdle)
-            printf("DimRgn change event debounce BEGIN (%p)\n", pRegion);
-        priv->debounceRegionChange.insert(pRegion);
-        NotifyDataStructureToBeChanged(pRegion, "gig::Region");
-    }
+    priv->dimRgnDebouncer.dimRegionToBeChanged(
+        pDimRgn, Settings::singleton()->commitLiveEditsInstantly
+    );
 }
 
-void LinuxSamplerPlugin::__onDimRegionChanged(gig::DimensionRegion* pDimRgn) {
-    // like above, not sending this ...
-    //NotifyDataStructureChanged(pDimRgn, "gig::DimensionRegion");
-
-    // ... but rather aggressively debounce those dim region changed events and
-    // sending a debounced region changed event instead.
-    if (!pDimRgn) return;
-    if (!priv->debounceRegionChangedScheduled) {
-        priv->debounceRegionChangedScheduled = true;
-        Glib::signal_idle().connect_once(
-            sigc::mem_fun(*this, &LinuxSamplerPlugin::__onDimRegionChangedDebounced),
-            Glib::PRIORITY_HIGH_IDLE
-        );
-    }
+void LinuxSamplerPlugin::regionToBeChanged(gig::Region* pRegion) {
+    __notifyDataStructureToBeChanged(pRegion, "gig::Region");
 }
 
-void LinuxSamplerPlugin::__onDimRegionChangedDebounced() {
-    // Note that we are really aggressively unlocking the region here: we are
-    // not even bothering whether the amount "changed" events match with the
-    // previously sent amount of "to be changed" events, because this handler
-    // here is only called when the app's event loop is already idle for a
-    // while, which is not the case if the app is still changing instrument
-    // parameters (except if the app is i.e. currently showing an error dialog
-    // to the user).
-    priv->debounceRegionChangedScheduled = false;
-    for (std::set<gig::Region*>::const_iterator it = priv->debounceRegionChange.begin();
-         it != priv->debounceRegionChange.end(); ++it)
-    {
-        gig::Region* pRegion = *it;
-        NotifyDataStructureChanged(pRegion, "gig::Region");
-    }
-    priv->debounceRegionChange.clear();
-    printf("DimRgn change event debounce END\n");
+void LinuxSamplerPlugin::regionChanged(gig::Region* pRegion) {
+    __notifyDataStructureChanged(pRegion, "gig::Region");
+}
+
+void LinuxSamplerPlugin::scheduleFlush() {
+    Glib::signal_idle().connect_once(
+        sigc::mem_fun(priv->dimRgnDebouncer, &DimRegionChangeDebouncer::flush),
+        Glib::PRIORITY_HIGH_IDLE
+    );
+}
+
+void LinuxSamplerPlugin::__schedulePoll(int iMilliseconds) {
+    priv->pollPeriod = iMilliseconds;
+    const Glib::RefPtr<Glib::TimeoutSource> timeout_source =
+        Glib::TimeoutSource::create(iMilliseconds);
+    priv->pollConnection = timeout_source->connect(
+        sigc::mem_fun(this, &LinuxSamplerPlugin::__onPollPeriod)
+    );
+    timeout_source->attach(Glib::MainContext::get_default());
 }
 
 bool LinuxSamplerPlugin::__onPollPeriod() {
     #if HAVE_LINUXSAMPLER_VIRTUAL_MIDI_DEVICE
     GigEdit* app = static_cast<GigEdit*>(pApp);
-    if (!NotesChanged()) return true;
-    for (int iKey = 0; iKey < 128; iKey++)
-        if (NoteChanged(iKey))
-            NoteIsActive(iKey) ?
-                app->on_note_on_event(iKey, NoteOnVelocity(iKey)) :
-                app->on_note_off_event(iKey, NoteOffVelocity(iKey));
-    return true;
+    int iNextPeriod;
+    if (NotesChanged()) {
+        // the GUI only collects these events and redraws the keyboard once
+        // per frame, so polling faster than that would not gain anything
+        for (int iKey = 0; iKey < 128; iKey++)
+            if (NoteChanged(iKey))
+                NoteIsActive(iKey) ?
+                    app->on_note_on_event(iKey, NoteOnVelocity(iKey)) :
+                    app->on_note_off_event(iKey, NoteOffVelocity(iKey));
+        iNextPeriod = POLL_PERIOD_MIN;
+    } else {
+        iNextPeriod = std::min(priv->pollPeriod * 2, POLL_PERIOD_MAX);
+    }
+    if (iNextPeriod == priv->pollPeriod) return true; // keep current timer
+    __schedulePoll(iNextPeriod);
+    return false; // replaced by the new timer
     #else
     return false;
     #endif
@@ -262,7 +408,7 @@ void LinuxSamplerPlugin::__onSamplesToBeRemoved(std::list<gig::Sample*> lSamples
         iter != lSamples.end(); ++iter
     ) samples.insert((void*)*iter);
     // finally send notification to sampler
-    NotifySamplesToBeRemoved(samples);
+    __notifySamplesToBeRemoved(samples);
 }
 
 void LinuxSamplerPlugin::__onVirtualKeyboardKeyHit(int Key, int Velocity) {
@@ -30,13 +30,18 @@
 # include <linuxsampler/plugins/InstrumentEditor.h>
 #endif
 
+#include <set>
+
+#include "../gigedit/DimRegionChangeDebouncer.h"
+
 #ifdef LIBGIG_HEADER_FILE
 # include LIBGIG_HEADER_FILE(gig.h)
 #else
 # include <gig.h>
 #endif
 
-class LinuxSamplerPlugin : public LinuxSampler::InstrumentEditor {
+class LinuxSamplerPlugin : public LinuxSampler::InstrumentEditor,
+                           private DimRegionChangeDebouncer::Host {
     public:
         LinuxSamplerPlugin();
         virtual int Main(void* pInstrument, String sTypeName, String sTypeVersion); // old LS plugin API entry point
@@ -56,9 +61,23 @@ class LinuxSamplerPlugin : public LinuxSampler::InstrumentEditor {
         void __onVirtualKeyboardKeyReleased(int Key, int Velocity);
         void __requestSamplerToSwitchInstrument(gig::Instrument* pInstrument);
         bool __onPollPeriod();
+        void __schedulePoll(int iMilliseconds);
         void __onDimRegionToBeChanged(gig::DimensionRegion* pDimRgn);
-        void __onDimRegionChanged(gig::DimensionRegion* pDimRgn);
-        void __onDimRegionChangedDebounced();
+
+        // DimRegionChangeDebouncer::Host
+        virtual void regionToBeChanged(gig::Region* pRegion);
+        virtual void regionChanged(gig::Region* pRegion);
+        virtual void scheduleFlush();
+
+        // notifications to the sampler, measuring how long it is blocked
+        void __notifyDataStructureToBeChanged(void* pStruct, String sStructType);
+        void __notifyDataStructureChanged(void* pStruct, String sStructType);
+        void __notifySamplesToBeRemoved(std::set<void*> Samples);
+        void __notifySamplesRemoved();
+        void __lockBegin(void* pStruct, const String& sStructType);
+        void __lockEnd(void* pStruct, const String& sStructType);
+        void __showLockStats(const String& sStructType);
+        void __dumpLockStats();
 };
 
 #endif // GIGEDIT_LINUXSAMPLER_PLUGIN_H